@@ -1,5 +1,7 @@
 #include "AABB.h"
 
+#include <algorithm>
+
 bool IsCollisionAABBAABB(const AABB& aabb1, const AABB& aabb2) {
 	AABB fixedAABB1 = aabb1;
 
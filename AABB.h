@@ -1,5 +1,5 @@
 #pragma once
-#include "KamataEngine.h"
+#include "MathTypes.h"
 
 struct AABB {
 	KamataEngine::Vector3 min; // 最小点
@@ -0,0 +1,68 @@
+#include "BlockChunkManager.h"
+
+#include "MathUtl.h"
+
+using namespace KamataEngine;
+
+BlockChunkManager::~BlockChunkManager() { Clear(); }
+
+void BlockChunkManager::Initialize(const MapChipField* mapChipField) {
+	// 既存チャンクの WorldTransform はプールへ戻して次のマップで再利用する
+	streamer_.Reset();
+
+	mapChipField_ = mapChipField;
+}
+
+void BlockChunkManager::Update(const Vector3& center) {
+	if (!mapChipField_) {
+		return;
+	}
+
+	streamer_.Update(*mapChipField_->GetSnapshot(), center);
+	PlaceBlocks();
+}
+
+void BlockChunkManager::InvalidateTiles(std::span<const MapChipTileChange> changes) {
+	if (!mapChipField_) {
+		return;
+	}
+
+	streamer_.InvalidateTiles(*mapChipField_->GetSnapshot(), changes);
+	PlaceBlocks();
+}
+
+void BlockChunkManager::Draw(Model* blockModel, Model* iceModel, const Camera& camera) {
+	for (const BlockChunkStreamer::Chunk& chunk : streamer_.GetChunks()) {
+		for (const BlockChunkStreamer::Block& block : chunk.blocks) {
+			if (block.isIce && iceModel) {
+				iceModel->Draw(*transforms_[block.slot], camera);
+			} else if (blockModel) {
+				blockModel->Draw(*transforms_[block.slot], camera);
+			}
+		}
+	}
+}
+
+void BlockChunkManager::Clear() {
+	streamer_.Clear();
+
+	for (WorldTransform* wt : transforms_) {
+		delete wt;
+	}
+	transforms_.clear();
+}
+
+void BlockChunkManager::PlaceBlocks() {
+	while (transforms_.size() < streamer_.GetSlotCount()) {
+		WorldTransform* wt = new WorldTransform();
+		wt->Initialize();
+		transforms_.push_back(wt);
+	}
+
+	for (const BlockChunkStreamer::Block& block : streamer_.GetPlacedBlocks()) {
+		WorldTransform* wt = transforms_[block.slot];
+		wt->translation_ = mapChipField_->GetMapChipPositionByIndex(block.xIndex, block.yIndex);
+		wt->matWorld_ = MakeAffineMatrix(wt->scale_, wt->rotation_, wt->translation_);
+		wt->TransferMatrix();
+	}
+}
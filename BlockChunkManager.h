@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BlockChunkStreamer.h"
+#include "KamataEngine.h"
+#include "MapChipField.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// ブロック描画用の WorldTransform をチャンク単位でストリーミングする
+/// カメラ周辺のチャンクだけに描画リソースを持たせ、範囲外に出たチャンクは解放してプールへ戻す
+/// どのチャンク・ブロックを常駐させるかは BlockChunkStreamer が決め、ここではそのスロットごとに WorldTransform を持つ
+/// </summary>
+class BlockChunkManager {
+public:
+	// 1 チャンクの縦横タイル数
+	static inline const uint32_t kChunkSize = BlockChunkStreamer::kChunkSize;
+
+	BlockChunkManager() = default;
+	~BlockChunkManager();
+
+	BlockChunkManager(const BlockChunkManager&) = delete;
+	BlockChunkManager& operator=(const BlockChunkManager&) = delete;
+
+	/// <summary>
+	/// 対象のマップを設定し、常駐チャンクをすべて解放する
+	/// チャンクは次の Update で読み込まれる
+	/// </summary>
+	void Initialize(const MapChipField* mapChipField);
+
+	/// <summary>
+	/// 中心座標から読み込み半径内のチャンクを読み込み、範囲外のチャンクを解放する
+	/// </summary>
+	/// <param name="center">ワールド座標（通常はカメラ位置）</param>
+	void Update(const KamataEngine::Vector3& center);
+
+	/// <summary>
+	/// タイルが書き換わったときに、常駐チャンクのそのタイルのブロックだけを追加・削除・差し替える
+	/// 1 タイルあたりの手間はチャンク 1 つ分までで、マップの大きさに依らない
+	/// </summary>
+	void InvalidateTiles(std::span<const MapChipTileChange> changes);
+
+	/// <summary>
+	/// 常駐チャンクのブロックを描画する（当たり判定レイヤーに加えて decoration レイヤーのタイルも描く）
+	/// </summary>
+	void Draw(KamataEngine::Model* blockModel, KamataEngine::Model* iceModel, const KamataEngine::Camera& camera);
+
+	/// <summary>
+	/// 常駐チャンクと WorldTransform のプールをすべて破棄する
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 読み込み半径（ワールド座標）。解放はこれに BlockChunkStreamer::kUnloadMargin を足した範囲の外で行う
+	/// </summary>
+	void SetLoadRadius(float radius) { streamer_.SetLoadRadius(radius); }
+
+	size_t GetResidentChunkCount() const { return streamer_.GetResidentChunkCount(); }
+	size_t GetResidentBlockCount() const { return streamer_.GetResidentBlockCount(); }
+	size_t GetPooledTransformCount() const { return streamer_.GetFreeSlotCount(); }
+
+private:
+	/// <summary>
+	/// 新しく作られたスロットの WorldTransform を用意し、直前に置かれたブロックの行列を転送する
+	/// ブロックは動かないので、行列は置いたときに 1 回だけ転送する
+	/// </summary>
+	void PlaceBlocks();
+
+	const MapChipField* mapChipField_ = nullptr;
+
+	BlockChunkStreamer streamer_;
+
+	// スロット番号ごとの WorldTransform（常駐していないスロットのものは次に置かれるまで使わない）
+	std::vector<KamataEngine::WorldTransform*> transforms_;
+};
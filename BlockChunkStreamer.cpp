@@ -0,0 +1,191 @@
+#include "BlockChunkStreamer.h"
+
+#include "MapChipFormat.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace KamataEngine;
+
+void BlockChunkStreamer::Reset() {
+	for (Chunk& chunk : chunks_) {
+		UnloadChunk(chunk);
+	}
+	chunks_.clear();
+	placedBlocks_.clear();
+	hasLoadedRange_ = false;
+}
+
+void BlockChunkStreamer::Clear() {
+	Reset();
+	freeSlots_.clear();
+	slotCount_ = 0;
+}
+
+void BlockChunkStreamer::Update(const MapChipSnapshot& map, const Vector3& center) {
+	placedBlocks_.clear();
+
+	ChunkRange loadRange;
+	bool inMap = ComputeChunkRange(map, center, loadRadius_, loadRange);
+	if (inMap && hasLoadedRange_ && loadRange == loadedRange_) {
+		return;
+	}
+
+	// 解放は読み込み範囲より広い範囲で判定し、境界付近での読み込み・解放の繰り返しを防ぐ
+	ChunkRange keepRange;
+	bool keep = ComputeChunkRange(map, center, loadRadius_ + kUnloadMargin, keepRange);
+	for (size_t i = 0; i < chunks_.size();) {
+		if (!keep || !keepRange.Contains(chunks_[i].chunkX, chunks_[i].chunkY)) {
+			UnloadChunk(chunks_[i]);
+			chunks_[i] = std::move(chunks_.back());
+			chunks_.pop_back();
+		} else {
+			++i;
+		}
+	}
+
+	if (!inMap) {
+		hasLoadedRange_ = false;
+		return;
+	}
+
+	for (uint32_t chunkY = loadRange.minY; chunkY <= loadRange.maxY; ++chunkY) {
+		for (uint32_t chunkX = loadRange.minX; chunkX <= loadRange.maxX; ++chunkX) {
+			bool resident = std::any_of(chunks_.begin(), chunks_.end(), [&](const Chunk& c) { return c.chunkX == chunkX && c.chunkY == chunkY; });
+			if (!resident) {
+				LoadChunk(map, chunkX, chunkY);
+			}
+		}
+	}
+
+	loadedRange_ = loadRange;
+	hasLoadedRange_ = true;
+}
+
+void BlockChunkStreamer::InvalidateTiles(const MapChipSnapshot& map, std::span<const MapChipTileChange> changes) {
+	placedBlocks_.clear();
+
+	// 未読み込みのチャンクは読み込み時に最新の内容になるので、常駐チャンクだけを直す
+	for (const MapChipTileChange& change : changes) {
+		uint32_t chunkX = change.index.xIndex / kChunkSize;
+		uint32_t chunkY = change.index.yIndex / kChunkSize;
+		auto it = std::find_if(chunks_.begin(), chunks_.end(), [&](const Chunk& c) { return c.chunkX == chunkX && c.chunkY == chunkY; });
+		if (it != chunks_.end()) {
+			UpdateBlock(map, *it, change.index.xIndex, change.index.yIndex);
+		}
+	}
+}
+
+size_t BlockChunkStreamer::GetResidentBlockCount() const {
+	size_t count = 0;
+	for (const Chunk& chunk : chunks_) {
+		count += chunk.blocks.size();
+	}
+	return count;
+}
+
+size_t BlockChunkStreamer::GetResidentBytes() const {
+	size_t bytes = chunks_.capacity() * sizeof(Chunk) + freeSlots_.capacity() * sizeof(uint32_t) + placedBlocks_.capacity() * sizeof(Block);
+	for (const Chunk& chunk : chunks_) {
+		bytes += chunk.blocks.capacity() * sizeof(Block);
+	}
+	return bytes;
+}
+
+bool BlockChunkStreamer::ComputeChunkRange(const MapChipSnapshot& map, const Vector3& center, float radius, ChunkRange& range) {
+	const float blockWidth = MapChipSnapshot::GetBlockWidth();
+	const float blockHeight = MapChipSnapshot::GetBlockHeight();
+	const int64_t width = map.GetNumBlockHorizontal();
+	const int64_t height = map.GetNumBlockVertical();
+
+	// GetMapChipIndexSetByPosition と同じ計算を符号付きで行う（y は上の行が 0）
+	int64_t x0 = static_cast<int64_t>(std::floor((center.x - radius + blockWidth * 0.5f) / blockWidth));
+	int64_t x1 = static_cast<int64_t>(std::floor((center.x + radius + blockWidth * 0.5f) / blockWidth));
+	int64_t y0 = height - 1 - static_cast<int64_t>(std::floor((center.y + radius + blockHeight * 0.5f) / blockHeight));
+	int64_t y1 = height - 1 - static_cast<int64_t>(std::floor((center.y - radius + blockHeight * 0.5f) / blockHeight));
+
+	x0 = std::max<int64_t>(x0, 0);
+	y0 = std::max<int64_t>(y0, 0);
+	x1 = std::min<int64_t>(x1, width - 1);
+	y1 = std::min<int64_t>(y1, height - 1);
+	if (x0 > x1 || y0 > y1) {
+		return false;
+	}
+
+	range.minX = static_cast<uint32_t>(x0) / kChunkSize;
+	range.maxX = static_cast<uint32_t>(x1) / kChunkSize;
+	range.minY = static_cast<uint32_t>(y0) / kChunkSize;
+	range.maxY = static_cast<uint32_t>(y1) / kChunkSize;
+	return true;
+}
+
+void BlockChunkStreamer::LoadChunk(const MapChipSnapshot& map, uint32_t chunkX, uint32_t chunkY) {
+	Chunk chunk = {chunkX, chunkY, {}};
+
+	uint32_t beginX = chunkX * kChunkSize;
+	uint32_t beginY = chunkY * kChunkSize;
+	uint32_t endX = std::min(beginX + kChunkSize, map.GetNumBlockHorizontal());
+	uint32_t endY = std::min(beginY + kChunkSize, map.GetNumBlockVertical());
+
+	const MapChipLayer* decoration = map.FindLayer(kMapChipDecorationLayerName);
+	for (uint32_t y = beginY; y < endY; ++y) {
+		for (uint32_t x = beginX; x < endX; ++x) {
+			MapChipModel model = GetMapChipProperty(map.GetMapChipTypeByIndexUnchecked(x, y)).model;
+			if (model != MapChipModel::kNone) {
+				AddBlock(chunk, x, y, model == MapChipModel::kIce, false);
+			}
+			if (decoration) {
+				MapChipModel decorationModel = GetMapChipProperty(decoration->tiles.Get(x, y)).model;
+				if (decorationModel != MapChipModel::kNone) {
+					AddBlock(chunk, x, y, decorationModel == MapChipModel::kIce, true);
+				}
+			}
+		}
+	}
+
+	chunks_.push_back(std::move(chunk));
+}
+
+void BlockChunkStreamer::UnloadChunk(Chunk& chunk) {
+	for (const Block& block : chunk.blocks) {
+		freeSlots_.push_back(block.slot);
+	}
+	chunk.blocks.clear();
+}
+
+void BlockChunkStreamer::UpdateBlock(const MapChipSnapshot& map, Chunk& chunk, uint32_t xIndex, uint32_t yIndex) {
+	MapChipModel model = GetMapChipProperty(map.GetMapChipTypeByIndex(xIndex, yIndex)).model;
+	auto it = std::find_if(chunk.blocks.begin(), chunk.blocks.end(), [&](const Block& b) { return b.xIndex == xIndex && b.yIndex == yIndex && !b.isDecoration; });
+
+	if (model == MapChipModel::kNone) {
+		// ブロックがなくなった
+		if (it != chunk.blocks.end()) {
+			freeSlots_.push_back(it->slot);
+			*it = chunk.blocks.back();
+			chunk.blocks.pop_back();
+		}
+		return;
+	}
+
+	if (it != chunk.blocks.end()) {
+		// 位置は変わらないので、モデルの切り替えだけ
+		it->isIce = model == MapChipModel::kIce;
+		return;
+	}
+
+	AddBlock(chunk, xIndex, yIndex, model == MapChipModel::kIce, false);
+}
+
+void BlockChunkStreamer::AddBlock(Chunk& chunk, uint32_t xIndex, uint32_t yIndex, bool isIce, bool isDecoration) {
+	uint32_t slot;
+	if (!freeSlots_.empty()) {
+		slot = freeSlots_.back();
+		freeSlots_.pop_back();
+	} else {
+		slot = slotCount_++;
+	}
+
+	Block block = {slot, xIndex, yIndex, isIce, isDecoration};
+	chunk.blocks.push_back(block);
+	placedBlocks_.push_back(block);
+}
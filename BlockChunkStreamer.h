@@ -0,0 +1,129 @@
+#pragma once
+
+#include "MapChipSnapshot.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// ブロック描画のチャンク単位のストリーミングのうち、エンジンに依存しない部分
+/// カメラ周辺のチャンクのブロックを管理し、ブロックごとに描画リソースの番号（スロット）を割り当てる
+/// 解放したチャンクのスロットは空きに戻して再利用するので、スロットの総数は同時に常駐したブロック数の最大値を超えない
+/// 描画リソースはスロットごとに BlockChunkManager が持つ（Tools/BlockChunkBench はこれだけで常駐数・常駐バイト数を確かめる）
+/// ストリーミングするのはブロックの描画リソースだけで、マップのデータ（MapChipSnapshot）はステージ全体を常駐させる
+/// プレイヤー・敵の当たり判定、経路探索のグラフ、出現位置、ホットリロードの差分はカメラから離れたタイルも参照するため
+/// 横に長いマップでは MAPCHIP_STORE_RUN_LENGTH でタイルを連長圧縮して常駐サイズを抑える
+/// </summary>
+class BlockChunkStreamer {
+public:
+	// 1 チャンクの縦横タイル数
+	static inline const uint32_t kChunkSize = 32;
+
+	// 読み込み半径（20 タイル分）と解放までの余裕（半チャンク分）
+	static inline const float kDefaultLoadRadius = 40.0f;
+	static inline const float kUnloadMargin = 32.0f;
+
+	struct Block {
+		uint32_t slot;
+		uint32_t xIndex;
+		uint32_t yIndex;
+		bool isIce;
+		bool isDecoration; // decoration レイヤーのタイル（タイルの書き換えでは変わらない）
+	};
+
+	struct Chunk {
+		uint32_t chunkX;
+		uint32_t chunkY;
+		std::vector<Block> blocks;
+	};
+
+	/// <summary>
+	/// 常駐チャンクをすべて解放する（スロットは空きに戻し、次のマップで再利用する）
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 常駐チャンクを解放し、スロットもすべて捨てる
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 中心座標から読み込み半径内のチャンクを読み込み、範囲外のチャンクを解放する
+	/// </summary>
+	/// <param name="center">ワールド座標（通常はカメラ位置）</param>
+	void Update(const MapChipSnapshot& map, const KamataEngine::Vector3& center);
+
+	/// <summary>
+	/// タイルが書き換わったときに、常駐チャンクのそのタイルのブロックだけを追加・削除・差し替える
+	/// 1 タイルあたりの手間はチャンク 1 つ分までで、マップの大きさに依らない
+	/// </summary>
+	void InvalidateTiles(const MapChipSnapshot& map, std::span<const MapChipTileChange> changes);
+
+	/// <summary>
+	/// 直前の Update / InvalidateTiles で新しく置いたブロック（このスロットの描画リソースを置き直す）
+	/// </summary>
+	std::span<const Block> GetPlacedBlocks() const { return placedBlocks_; }
+
+	std::span<const Chunk> GetChunks() const { return chunks_; }
+
+	/// <summary>
+	/// 読み込み半径（ワールド座標）。解放はこれに kUnloadMargin を足した範囲の外で行う
+	/// </summary>
+	void SetLoadRadius(float radius) { loadRadius_ = radius; }
+	float GetLoadRadius() const { return loadRadius_; }
+
+	size_t GetResidentChunkCount() const { return chunks_.size(); }
+	size_t GetResidentBlockCount() const;
+
+	/// <summary>
+	/// このクラスが確保しているバイト数（チャンク・ブロック・空きスロット・直前に置いたブロックの配列を容量で数える）
+	/// 描画リソースとマップのデータは含まない
+	/// </summary>
+	size_t GetResidentBytes() const;
+
+	// これまでに作ったスロットの数（スロット番号は 0 ～ GetSlotCount() - 1）と、そのうち空いている数
+	uint32_t GetSlotCount() const { return slotCount_; }
+	size_t GetFreeSlotCount() const { return freeSlots_.size(); }
+
+private:
+	// チャンク番号の閉区間
+	struct ChunkRange {
+		uint32_t minX;
+		uint32_t maxX;
+		uint32_t minY;
+		uint32_t maxY;
+
+		bool Contains(uint32_t x, uint32_t y) const { return x >= minX && x <= maxX && y >= minY && y <= maxY; }
+		bool operator==(const ChunkRange&) const = default;
+	};
+
+	/// <summary>
+	/// 中心と半径からマップ内のチャンク範囲を求める（マップ外なら false）
+	/// </summary>
+	static bool ComputeChunkRange(const MapChipSnapshot& map, const KamataEngine::Vector3& center, float radius, ChunkRange& range);
+
+	void LoadChunk(const MapChipSnapshot& map, uint32_t chunkX, uint32_t chunkY);
+	void UnloadChunk(Chunk& chunk);
+
+	/// <summary>
+	/// チャンクのタイル (x, y) のブロックを現在の種別に合わせる
+	/// </summary>
+	void UpdateBlock(const MapChipSnapshot& map, Chunk& chunk, uint32_t xIndex, uint32_t yIndex);
+
+	/// <summary>
+	/// ブロックを追加し、スロットを割り当てて placedBlocks_ に記録する
+	/// </summary>
+	void AddBlock(Chunk& chunk, uint32_t xIndex, uint32_t yIndex, bool isIce, bool isDecoration);
+
+	float loadRadius_ = kDefaultLoadRadius;
+
+	std::vector<Chunk> chunks_;
+	std::vector<uint32_t> freeSlots_;
+	uint32_t slotCount_ = 0;
+	std::vector<Block> placedBlocks_;
+
+	// 前回読み込んだ範囲（変わらなければ何もしない）
+	ChunkRange loadedRange_ = {};
+	bool hasLoadedRange_ = false;
+};
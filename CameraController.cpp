@@ -1,5 +1,6 @@
 #include "CameraController.h"
 #include "MathUtl.h"
+#include "FrameClock.h"
 #include "Player.h"
 
 #include <algorithm>
@@ -65,8 +66,8 @@ void CameraController::Update() {
         camera_->translation_.y += oy;
         camera_->translation_.z += oz;
 
-        // 残り時間を減らす（60FPS想定の簡易更新)
-        shakeRemaining_ -= 1.0f / 60.0f;
+        // 残り時間を減らす
+        shakeRemaining_ -= FrameClock::GetInstance()->GetDeltaTime();
         if (shakeRemaining_ <= 0.0f) {
             isShaking_ = false;
             shakeRemaining_ = 0.0f;
@@ -3,6 +3,7 @@
 
 #include<algorithm>
 #include"MathUtl.h"
+#include "FrameClock.h"
 
 using namespace KamataEngine;
 
@@ -105,7 +106,7 @@ void DeathParticle::Update() {
 		return;
 	}
 
-	const float dt = 1.0f / 60.0f;
+	const float dt = FrameClock::GetInstance()->GetDeltaTime();
 	counter_ += dt;
 	if (counter_ >= duration_) {
 		counter_ = duration_;
@@ -4,6 +4,8 @@
 #include"../MathUtl.h"
 #include"../Player.h"
 #include"../MapChipField.h"
+#include"../MapChipNavGraph.h"
+#include<algorithm>
 
 using namespace KamataEngine;
 
@@ -46,10 +48,17 @@ void Enemy::Initialize(KamataEngine::Camera* camera, const KamataEngine::Vector3
     UpdateAABB();
 }
 
-void Enemy::SetMapChipField(MapChipField* map) {
+void Enemy::SetMapChipField(const MapChipField* map) {
     mapChipField_ = map;
 }
 
+void Enemy::SetNavigation(const MapChipNavGraph* graph, const MapChipNavFlowField* flowField) {
+    navGraph_ = graph;
+    navFlowField_ = flowField;
+    navNode_ = kMapChipNavNone;
+    traversing_ = false;
+}
+
 void Enemy::SetFacingRight(bool facing) {
     facingRight_ = facing;
     velocityX_ = (facingRight_ ? std::fabs(velocityX_) : -std::fabs(velocityX_));
@@ -68,6 +77,14 @@ void Enemy::Update() {
 		return;
 	}
 
+	// With a navigation graph the enemy only compares against its span bounds; no per-tile probing
+	if (navGraph_ && navFlowField_ && mapChipField_ && UpdateNavigation()) {
+		worldTransform_.matWorld_ = MakeAffineMatrix(worldTransform_.scale_, worldTransform_.rotation_, worldTransform_.translation_);
+		worldTransform_.TransferMatrix();
+		UpdateAABB();
+		return;
+	}
+
 	// Apply horizontal movement
 	// Move by velocityX_ each frame
 	worldTransform_.translation_.x += velocityX_;
@@ -82,19 +99,15 @@ void Enemy::Update() {
 		int checkY = static_cast<int>(idxMin.yIndex);
 
 		// If there's a block at the index we occupy, then we collided horizontally with block; reverse
-		MapChipType t = mapChipField_->GetMapChipTypeByIndex(checkX, checkY);
-		if (t == MapChipType::kBlock || t == MapChipType::kIce) {
+		if (mapChipField_->TestPlane(MapChipPlane::kSolid, checkX, checkY)) {
 			// Move back and reverse
 			worldTransform_.translation_.x -= velocityX_;
 			SetFacingRight(!facingRight_);
 		} else {
 			// additionally check one tile ahead in facing direction at foot level to detect cliffs
 			int aheadX = checkX + (facingRight_ ? 1 : -1);
-			int belowAheadY = checkY + 1; // below in grid coordinates (since map's yIndex increases downward)
-			// If tile ahead is blank (fall) and tile below ahead is also blank, reverse to avoid walking off cliffs
-			MapChipType aheadType = mapChipField_->GetMapChipTypeByIndex(aheadX, checkY);
-			MapChipType belowAheadType = mapChipField_->GetMapChipTypeByIndex(aheadX, belowAheadY);
-			if ((aheadType == MapChipType::kBlank) && (belowAheadType == MapChipType::kBlank)) {
+			// If there is no ground in the tile ahead or the one below it (distance field lookup), reverse to avoid walking off cliffs
+			if (mapChipField_->GetGroundDistance(aheadX, checkY) > 1) {
 				// reverse instead of falling
 				worldTransform_.translation_.x -= velocityX_;
 				SetFacingRight(!facingRight_);
@@ -108,6 +121,96 @@ void Enemy::Update() {
 	UpdateAABB();
 }
 
+bool Enemy::UpdateNavigation() {
+    Vector3& position = worldTransform_.translation_;
+
+    if (traversing_) {
+        // Scripted arc along a drop/jump link; the link was validated against the map when the graph was built
+        traverseT_ = std::min(traverseT_ + traverseStep_, 1.0f);
+        float t = traverseT_;
+        position.x = traverseFrom_.x + (traverseTo_.x - traverseFrom_.x) * t;
+        position.y = traverseFrom_.y + (traverseTo_.y - traverseFrom_.y) * t + traverseArc_ * 4.0f * t * (1.0f - t);
+        if (t >= 1.0f) {
+            traversing_ = false;
+            // look up the landing span next frame
+            navNode_ = kMapChipNavNone;
+        }
+        return true;
+    }
+
+    // Only look the span up after landing or when the graph was rebuilt
+    if (navNode_ == kMapChipNavNone || navGraphVersion_ != navGraph_->GetVersion()) {
+        IndexSet index = mapChipField_->GetMapChipIndexSetByPosition(position);
+        navNode_ = navGraph_->FindNode(index.xIndex, index.yIndex);
+        navGraphVersion_ = navGraph_->GetVersion();
+        if (navNode_ == kMapChipNavNone) {
+            return false;
+        }
+        const MapChipNavNode& node = navGraph_->GetNode(navNode_);
+        navMinX_ = mapChipField_->GetMapChipPositionByIndex(node.x0, node.yIndex).x;
+        navMaxX_ = mapChipField_->GetMapChipPositionByIndex(node.x1, node.yIndex).x;
+    }
+
+    const float minX = navMinX_;
+    const float maxX = navMaxX_;
+
+    if (navFlowField_->GetCost(navNode_) == kMapChipNavNone) {
+        // Target out of reach: patrol the span. Walls and cliffs both end a span, so turning at its ends replaces the probes
+        position.x += velocityX_;
+        if (position.x < minX || position.x > maxX) {
+            position.x = std::clamp(position.x, minX, maxX);
+            SetFacingRight(position.x <= minX);
+        }
+        return true;
+    }
+
+    // Chase: walk to the next link's takeoff tile, or to the target inside the target span
+    uint32_t link = navFlowField_->GetNextLink(navNode_);
+    float goalX;
+    if (link != kMapChipNavNone) {
+        const MapChipNavLink& next = navGraph_->GetLink(link);
+        goalX = mapChipField_->GetMapChipPositionByIndex(next.takeoff.xIndex, next.takeoff.yIndex).x;
+    } else {
+        goalX = std::clamp(mapChipField_->GetMapChipPositionByIndex(navFlowField_->GetTargetXIndex(), navGraph_->GetNode(navNode_).yIndex).x, minX, maxX);
+    }
+
+    float dx = goalX - position.x;
+    if (std::fabs(dx) <= speed_) {
+        position.x = goalX;
+        if (link != kMapChipNavNone) {
+            StartTraverse(link);
+        }
+        return true;
+    }
+    if ((dx > 0.0f) != facingRight_) {
+        SetFacingRight(dx > 0.0f);
+    }
+    position.x = std::clamp(position.x + velocityX_, minX, maxX);
+    return true;
+}
+
+void Enemy::StartTraverse(uint32_t link) {
+    const MapChipNavLink& l = navGraph_->GetLink(link);
+    traverseFrom_ = worldTransform_.translation_;
+    traverseTo_ = mapChipField_->GetMapChipPositionByIndex(l.landing.xIndex, l.landing.yIndex);
+    traverseTo_.z = traverseFrom_.z;
+
+    // Jumps clear one tile above the higher end; drops just hop off the ledge
+    float rise = std::max(0.0f, traverseTo_.y - traverseFrom_.y);
+    traverseArc_ = (l.kind == MapChipNavLinkKind::kJump) ? rise * 0.5f + MapChipField::GetBlockHeight() : MapChipField::GetBlockHeight() * 0.5f;
+
+    float dx = traverseTo_.x - traverseFrom_.x;
+    float dy = traverseTo_.y - traverseFrom_.y;
+    float length = std::sqrt(dx * dx + dy * dy) + traverseArc_;
+    traverseT_ = 0.0f;
+    traverseStep_ = speed_ / std::max(length, speed_);
+    traversing_ = true;
+
+    if ((dx > 0.0f) != facingRight_ && dx != 0.0f) {
+        SetFacingRight(dx > 0.0f);
+    }
+}
+
 void Enemy::Draw() {
 	if (!isAlive_)
 	{
@@ -2,6 +2,9 @@
 
 #include "KamataEngine.h"
 #include "../AABB.h"
+#include "../MapChipNavGraph.h"
+
+#include <cstdint>
 
 class Player;
 class MapChipField;
@@ -21,10 +24,14 @@ public:
 	virtual void OnCollision(Player* player);
 
 	// Movement helpers
-	void SetMapChipField(MapChipField* map);
+	void SetMapChipField(const MapChipField* map);
 	void SetFacingRight(bool facing);
 	void SetSpeed(float s) { speed_ = s; velocityX_ = (facingRight_ ? speed_ : -speed_); }
 
+	// Navigation: patrol within the current platform span and chase along the shared flow field.
+	// Both must outlive the enemy; pass nullptr to fall back to per-tile probing.
+	void SetNavigation(const MapChipNavGraph* graph, const MapChipNavFlowField* flowField);
+
 public:
 	AABB& GetAABB() { return aabb_; }
 
@@ -43,8 +50,26 @@ protected:
 	bool ownsModel_ = false;
 
 	// Movement state
-	MapChipField* mapChipField_ = nullptr;
+	const MapChipField* mapChipField_ = nullptr;
 	float speed_ = 0.12f; // units per frame (simple constant since Update called without dt)
 	float velocityX_ = 0.0f;
 	bool facingRight_ = false;
+
+	// Navigation state
+	const MapChipNavGraph* navGraph_ = nullptr;
+	const MapChipNavFlowField* navFlowField_ = nullptr;
+	uint32_t navNode_ = kMapChipNavNone; // current span (none until looked up)
+	uint32_t navGraphVersion_ = 0;    // graph version navNode_ belongs to
+	float navMinX_ = 0.0f;            // world x range of the span (tile centers)
+	float navMaxX_ = 0.0f;
+	bool traversing_ = false;         // following a drop/jump link
+	KamataEngine::Vector3 traverseFrom_ = {};
+	KamataEngine::Vector3 traverseTo_ = {};
+	float traverseArc_ = 0.0f;        // extra height at the middle of the arc
+	float traverseT_ = 0.0f;
+	float traverseStep_ = 0.0f;       // t advanced per frame
+
+	// Returns false when the enemy is not on the graph (caller falls back to probing)
+	bool UpdateNavigation();
+	void StartTraverse(uint32_t link);
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "ShooterEnemy.h"
 #include "KamataEngine.h"
 #include "../MathUtl.h"
+#include "../FrameClock.h"
 #include "../MapChipField.h"
 #include <cmath>
 #include <numbers>
@@ -121,7 +122,7 @@ void ShooterEnemy::Update() {
 
     // Only advance firing timer when shooting is allowed
     if (allowShooting_) {
-        timer_ += 1.0f / 60.0f;
+        timer_ += FrameClock::GetInstance()->GetDeltaTime();
     }
 
     if (timer_ >= fireInterval_) {
@@ -198,18 +199,25 @@ bool ShooterEnemy::ConsumeBulletCollidingWithAABB(const AABB& aabb) {
     return false;
 }
 
-void ShooterEnemy::CullBulletsByMap(MapChipField* map) {
+void ShooterEnemy::CullBulletsByMap(const MapChipField* map) {
     if (!map) return;
     for (auto b : bullets_) {
         if (!b->alive) continue;
-        IndexSet idx = map->GetMapChipIndexSetByPosition(b->pos);
-        // guard against out-of-range indices
-        uint32_t x = idx.xIndex;
-        uint32_t y = idx.yIndex;
-        if (x >= map->GetNumBlockHorizontal() || y >= map->GetNumBlockVertical()) continue;
-        MapChipType t = map->GetMapChipTypeByIndex(x, y);
-        if (t == MapChipType::kBlock || t == MapChipType::kIce) {
-            b->alive = false;
+        // this frame's movement (previous position -> current position) is traced through the map,
+        // so a fast bullet cannot pass through a wall corner between two samples
+        float speed = std::sqrt(b->vel.x * b->vel.x + b->vel.y * b->vel.y);
+        KamataEngine::Vector3 prev = {b->pos.x - b->vel.x, b->pos.y - b->vel.y, b->pos.z};
+        MapChipRaycastHit hit;
+        if (speed > 0.0f) {
+            if (map->Raycast(prev, b->vel, speed, MapChipPlaneMask(MapChipPlane::kSolid), hit)) {
+                b->alive = false;
+            }
+        } else {
+            // not moving: cull if the bullet's box overlaps a solid tile
+            constexpr uint32_t kSolidMask = MapChipTypeMaskOf(&MapChipProperty::solid);
+            if (map->ForEachTileInAABB(b->aabb, kSolidMask, [](IndexSet, MapChipType) { return true; })) {
+                b->alive = false;
+            }
         }
     }
 }
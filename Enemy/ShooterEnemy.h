@@ -32,7 +32,7 @@ public:
     bool ConsumeBulletCollidingWithAABB(const AABB& aabb);
 
     // Cull bullets that hit map blocks (mark them not alive)
-    void CullBulletsByMap(MapChipField* map);
+    void CullBulletsByMap(const MapChipField* map);
 
 private:
     struct Bullet {
@@ -1,5 +1,6 @@
 #include "EnemyDeathParticle.h"
 #include "MathUtl.h"
+#include "FrameClock.h"
 
 using namespace KamataEngine;
 
@@ -61,7 +62,7 @@ void EnemyDeathParticle::Initialize(Model* model, Camera* camera, const Vector3&
 void EnemyDeathParticle::Update() {
     if (isFinish_) return;
 
-    const float dt = 1.0f / 60.0f;
+    const float dt = FrameClock::GetInstance()->GetDeltaTime();
     counter_ += dt;
     if (counter_ >= kDuration) {
         counter_ = kDuration;
@@ -1,4 +1,5 @@
 #include "Fade.h"
+#include "FrameClock.h"
 
 #include <algorithm>
 
@@ -19,7 +20,7 @@ void Fade::Update() {
 	case Status::None:
 		break;
 	case Status::FadeIn:
-		counter_ += 1.0f / 60.0f;
+		counter_ += FrameClock::GetInstance()->GetDeltaTime();
 		// フェード継続時間に達したらフェード終了
 		if (counter_ >= duration_) {
 			counter_ = duration_;
@@ -28,7 +29,7 @@ void Fade::Update() {
 		fadeSprite_->SetColor(Vector4(0, 0, 0, 1.0f - std::clamp(counter_ / duration_, 0.0f, 1.0f)));
 		break;
 	case Status::FadeOut:
-		counter_ += 1.0f / 60.0f;
+		counter_ += FrameClock::GetInstance()->GetDeltaTime();
 		// フェード継続時間に達したらフェード終了
 		if (counter_ >= duration_) {
 			counter_ = duration_;
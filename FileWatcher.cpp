@@ -0,0 +1,44 @@
+#include "FileWatcher.h"
+
+void FileWatcher::Watch(const std::string& filename) {
+	filename_ = filename;
+	hasPending_ = false;
+	nextPoll_ = Clock::now() + kPollInterval;
+
+	std::error_code ec;
+	lastWriteTime_ = std::filesystem::last_write_time(filename_, ec);
+	if (ec) {
+		lastWriteTime_ = {};
+	}
+}
+
+bool FileWatcher::Poll() {
+	if (filename_.empty()) {
+		return false;
+	}
+
+	Clock::time_point now = Clock::now();
+	if (now < nextPoll_) {
+		return false;
+	}
+	nextPoll_ = now + kPollInterval;
+
+	std::error_code ec;
+	std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(filename_, ec);
+	if (ec || writeTime == lastWriteTime_) {
+		// 保存中にファイルが一時的に消える場合もあるので、読めなければ次回に回す
+		hasPending_ = false;
+		return false;
+	}
+
+	// 前回のポーリングから時刻が変わっていなければ書き込み完了とみなす
+	if (hasPending_ && writeTime == pendingWriteTime_) {
+		hasPending_ = false;
+		lastWriteTime_ = writeTime;
+		return true;
+	}
+
+	pendingWriteTime_ = writeTime;
+	hasPending_ = true;
+	return false;
+}
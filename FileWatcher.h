@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+/// <summary>
+/// ファイルの更新を監視する（更新時刻のポーリング）
+/// 一定間隔でしか確認しないので毎フレーム Poll を呼んでよい
+/// </summary>
+class FileWatcher {
+public:
+	/// <summary>
+	/// 監視するファイルを設定する（現在の更新時刻を基準にする）
+	/// </summary>
+	void Watch(const std::string& filename);
+
+	/// <summary>
+	/// ファイルが更新されていれば true を返す
+	/// 保存途中のファイルを読まないよう、更新を検出してから時刻が落ち着くまで待つ
+	/// </summary>
+	bool Poll();
+
+	const std::string& GetFilename() const { return filename_; }
+	bool IsWatching() const { return !filename_.empty(); }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	// 更新時刻を確認する間隔
+	static inline const std::chrono::milliseconds kPollInterval{250};
+
+	std::string filename_;
+	std::filesystem::file_time_type lastWriteTime_ = {};
+	// 検出したがまだ報告していない更新時刻
+	std::filesystem::file_time_type pendingWriteTime_ = {};
+	bool hasPending_ = false;
+	Clock::time_point nextPoll_ = {};
+};
@@ -0,0 +1,53 @@
+#include "FrameClock.h"
+
+#include <thread>
+
+namespace {
+
+// 残りがこれより長いときだけスリープし、最後は細かく待つ（スリープは指定より長く寝ることがあるため）
+constexpr std::chrono::milliseconds kSleepMargin{2};
+
+} // namespace
+
+FrameClock* FrameClock::GetInstance() {
+	static FrameClock instance;
+	return &instance;
+}
+
+void FrameClock::Reset() {
+	last_ = Clock::now();
+	accumulator_ = Clock::duration::zero();
+	stepCount_ = 0;
+	stepsThisFrame_ = 0;
+	droppedStepCount_ = 0;
+}
+
+uint32_t FrameClock::Advance() {
+	Clock::time_point now = Clock::now();
+	accumulator_ += now - last_;
+	last_ = now;
+
+	// 1 ステップ分溜まるまで待つ（描画だけ先に進めても同じ絵になるだけなので）
+	while (accumulator_ < kStep) {
+		Clock::duration remaining = kStep - accumulator_;
+		if (remaining > kSleepMargin) {
+			std::this_thread::sleep_for(remaining - kSleepMargin);
+		} else {
+			std::this_thread::yield();
+		}
+		now = Clock::now();
+		accumulator_ += now - last_;
+		last_ = now;
+	}
+
+	uint64_t steps = static_cast<uint64_t>(accumulator_ / kStep);
+	accumulator_ -= kStep * steps;
+	if (steps > kMaxCatchUpSteps) {
+		droppedStepCount_ += steps - kMaxCatchUpSteps;
+		steps = kMaxCatchUpSteps;
+	}
+
+	stepsThisFrame_ = static_cast<uint32_t>(steps);
+	stepCount_ += steps;
+	return stepsThisFrame_;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+/// <summary>
+/// 実時間を測り、シミュレーションを固定ステップで進めるための時計
+/// 描画のフレームレートが 60Hz でなくても（144Hz・240Hz やフレーム落ち時でも）ゲームの進む速さを一定に保つ
+/// </summary>
+class FrameClock {
+public:
+	// 1 ステップで進める時間（秒）。各 Update はこの時間だけ進める前提で作られている
+	static constexpr float kFixedDeltaTime = 1.0f / 60.0f;
+
+	// 1 回の Advance で進めるステップ数の上限。これを超えて遅れた分は捨てる（ブレークポイントや長いロードで一気に進まないように）
+	static constexpr uint32_t kMaxCatchUpSteps = 5;
+
+	static FrameClock* GetInstance();
+
+	/// <summary>
+	/// 計測をやり直す（ゲームループ開始前やロード直後に呼ぶ）
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 前回からの実時間を溜め、今回進めるステップ数を返す
+	/// 1 ステップ分も溜まっていなければ溜まるまで待つので、戻り値は 1 ～ kMaxCatchUpSteps
+	/// </summary>
+	uint32_t Advance();
+
+	/// <summary>
+	/// 1 ステップの時間（秒）。各サブシステムの Update はこれを使って時間を進める
+	/// </summary>
+	float GetDeltaTime() const { return kFixedDeltaTime; }
+
+	// Reset から進めたステップの総数
+	uint64_t GetStepCount() const { return stepCount_; }
+
+	// 直前の Advance で進めたステップ数
+	uint32_t GetStepsThisFrame() const { return stepsThisFrame_; }
+
+	// 上限を超えて捨てたステップの総数
+	uint64_t GetDroppedStepCount() const { return droppedStepCount_; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr Clock::duration kStep = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(kFixedDeltaTime));
+
+	FrameClock() = default;
+
+	Clock::time_point last_ = Clock::now();
+
+	// まだステップとして消費していない実時間
+	Clock::duration accumulator_ = Clock::duration::zero();
+
+	uint64_t stepCount_ = 0;
+	uint32_t stepsThisFrame_ = 0;
+	uint64_t droppedStepCount_ = 0;
+};
@@ -10,7 +10,9 @@
 #include "Key.h"
 #include "Ladder.h"
 #include "Fade.h"
+#include "FrameClock.h"
 #include <algorithm>
+#include <chrono>
 #include "Enemy/ShooterEnemy.h"
 #include <cmath>
 #include <mmsystem.h>
@@ -59,12 +61,7 @@ GameScene::~GameScene() {
 		delete enemyDeathParticle;
 	}
 
-	for (std::vector<WorldTransform*>& row : worldTransformBlocks_) {
-		for (WorldTransform* wt : row) {
-			delete wt;
-		}
-	}
-	worldTransformBlocks_.clear();
+	blockChunkManager_.Clear();
 
 	delete skydome_;
 	
@@ -178,24 +175,16 @@ void GameScene::Initialize() {
 		idx = 0;
 	if (idx >= numMapFiles)
 		idx = numMapFiles - 1;
-	mapChipField_->LoadMapChipCsv(mapFiles[idx]);
+	mapFilePath_ = mapFiles[idx];
+	mapChipField_->LoadMapChip(mapFilePath_);
+	RebuildNavigation();
+#ifdef _DEBUG
+	// 編集中の CSV を監視し、保存されたら差分だけを反映する
+	mapFileWatcher_.Watch(mapFilePath_);
+#endif // _DEBUG
 
 	player_ = new Player();
-	Vector3 playerPosition = {4.0f, 4.0f, 0.0f};
-	if (mapChipField_) {
-		uint32_t vh = mapChipField_->GetNumBlockVertical();
-		uint32_t wh = mapChipField_->GetNumBlockHorizontal();
-		bool found = false;
-		for (uint32_t y = 0; y < vh && !found; ++y) {
-			for (uint32_t x = 0; x < wh; ++x) {
-				if (mapChipField_->GetMapChipTypeByIndex(x, y) == MapChipType::kReserved2) {
-					playerPosition = mapChipField_->GetMapChipPositionByIndex(x, y);
-					found = true;
-					break;
-				}
-			}
-		}
-	}
+	Vector3 playerPosition = FindPlayerStartPosition();
 	player_->Initialize(&camera_, playerPosition);
 	player_->SetMapChipField(mapChipField_);
 
@@ -223,99 +212,8 @@ void GameScene::Initialize() {
 		lastPlayerHP_ = hp;
 	}
 
-	if (mapChipField_) {
-		uint32_t vh = mapChipField_->GetNumBlockVertical();
-		uint32_t wh = mapChipField_->GetNumBlockHorizontal();
-		bool goalSpawned = false;
-		for (uint32_t y = 0; y < vh; ++y) {
-			for (uint32_t x = 0; x < wh; ++x) {
-				MapChipType t = mapChipField_->GetMapChipTypeByIndex(x, y);
-				if (t == MapChipType::kEnemySpawn) {
-					Vector3 enemyPosition = mapChipField_->GetMapChipPositionByIndex(x, y);
-					Enemy* enemy = new Enemy();
-
-					enemy->Initialize(&camera_, enemyPosition);
-					// provide map reference for patrol behavior
-					enemy->SetMapChipField(mapChipField_);
-					enemies_.push_back(enemy);
-				} else if (t == MapChipType::kEnemySpawnShield) {
-					Vector3 enemyPosition = mapChipField_->GetMapChipPositionByIndex(x, y);
-					FrontShieldEnemy* fse = new FrontShieldEnemy();
-					fse->Initialize(&camera_, enemyPosition);
-					fse->SetFrontDotThreshold(0.6f);
-					// enable patrol map awareness
-					fse->SetMapChipField(mapChipField_);
-					enemies_.push_back(fse);
-				} else if (t == MapChipType::kEnemySpawnShieldRight) {
-					Vector3 enemyPosition = mapChipField_->GetMapChipPositionByIndex(x, y);
-					FrontShieldEnemy* fse = new FrontShieldEnemy();
-					fse->Initialize(&camera_, enemyPosition, false); // face right
-					fse->SetFrontDotThreshold(0.6f);
-					fse->SetMapChipField(mapChipField_);
-					enemies_.push_back(fse);
-				} else if (t == MapChipType::kShooter) {
-					Vector3 enemyPosition = mapChipField_->GetMapChipPositionByIndex(x, y);
-					ShooterEnemy* se = new ShooterEnemy();
-					se->Initialize(&camera_, enemyPosition);
-					se->SetBulletSpeed(0.2f);
-					se->SetFireInterval(2.0f);
-					se->SetMapChipField(mapChipField_);
-					enemies_.push_back(se);
-				} else if (t == MapChipType::kShooterRight) {
-					Vector3 enemyPosition = mapChipField_->GetMapChipPositionByIndex(x, y);
-					ShooterEnemy* se = new ShooterEnemy();
-					se->Initialize(&camera_, enemyPosition);
-					se->SetFacingRight(true); // face right
-					se->SetBulletSpeed(0.2f);
-					se->SetFireInterval(2.0f);
-					se->SetMapChipField(mapChipField_);
-					enemies_.push_back(se);
-				} else if (t == MapChipType::kSpike) {
-					Spike* s = new Spike();
-					Vector3 pos = mapChipField_->GetMapChipPositionByIndex(x, y);
-					s->SetPosition(pos);
-					s->Initialize();
-					spikes_.push_back(s);
-				} else if (t == MapChipType::kGoal && !goalSpawned) {
-					Goal* g = new Goal();
-					Vector3 pos = mapChipField_->GetMapChipPositionByIndex(x, y);
-					g->SetPosition(pos);
-					g->Initialize();
-					goals_.push_back(g);
-					goalSpawned = true;
-				} else if (t == MapChipType::kLadder) {
-					Ladder* l = new Ladder();
-					Vector3 pos = mapChipField_->GetMapChipPositionByIndex(x, y);
-					l->SetPosition(pos);
-					l->Initialize();
-					ladders_.push_back(l);
-				} else if (t == MapChipType::kEnemySpawnLeft) {
-					Vector3 enemyPosition = mapChipField_->GetMapChipPositionByIndex(x, y);
-					Enemy* enemy = new Enemy();
-					enemy->Initialize(&camera_, enemyPosition, true); // face left
-					enemies_.push_back(enemy);
-				}
-			}
-			// Do not break here; continue scanning to spawn all spikes and enemies
-		}
-	}
-
-	// spawn keys
-	if (mapChipField_) {
-		uint32_t vh = mapChipField_->GetNumBlockVertical();
-		uint32_t wh = mapChipField_->GetNumBlockHorizontal();
-		for (uint32_t y = 0; y < vh; ++y) {
-			for (uint32_t x = 0; x < wh; ++x) {
-				if (mapChipField_->GetMapChipTypeByIndex(x, y) == MapChipType::kKey) {
-					Key* k = new Key();
-					Vector3 pos = mapChipField_->GetMapChipPositionByIndex(x, y);
-					k->SetPosition(pos);
-					k->Initialize();
-					keys_.push_back(k);
-				}
-			}
-		}
-	}
+	// 敵・棘・ゴール・鍵・ハシゴをマップから生成
+	SpawnMapObjects();
 
 	if (!spikes_.empty()) {
 		DebugText::GetInstance()->ConsolePrintf("GameScene: created %u spikes\n", static_cast<uint32_t>(spikes_.size()));
@@ -615,6 +513,10 @@ void GameScene::Update() {
 		bgmStarted_ = true;
 	}
 
+#ifdef _DEBUG
+	HotReloadMap();
+#endif // _DEBUG
+
 	// If a reset is already pending, ignore additional reset requests
 	if (resetPending_) {
 		if (fade_) fade_->Update();
@@ -801,6 +703,7 @@ void GameScene::Update() {
 		skydome_->Update();
 
 		// update enemies during countdown so they appear behind fade
+		UpdateNavigationTarget();
 		for (Enemy* enemy : enemies_) {
 			if (enemy) enemy->Update();
 		}
@@ -812,14 +715,7 @@ void GameScene::Update() {
 			}
 		}
 
-		for (auto& row : worldTransformBlocks_) {
-			for (WorldTransform* wt : row) {
-				if (!wt) continue;
-				wt->matWorld_ = MakeAffineMatrix(wt->scale_, wt->rotation_, wt->translation_);
-				if (wt->parent_) wt->matWorld_ = Multiply(wt->parent_->matWorld_, wt->matWorld_);
-				wt->TransferMatrix();
-			}
-		}
+		UpdateBlockChunks();
 
 		if (player_) {
 			KamataEngine::WorldTransform& pwt = player_->GetWorldTransform();
@@ -861,7 +757,7 @@ void GameScene::Update() {
  		}
 
 		// ensure countdown proceeds at real time now that fade has finished
-		countdownTime_ -= 1.0f / 60.0f;
+		countdownTime_ -= FrameClock::GetInstance()->GetDeltaTime();
  		
  		break;
  	}
@@ -902,7 +798,7 @@ void GameScene::Update() {
 
 		skydome_->Update();
 
-		
+		UpdateNavigationTarget();
 		for (Enemy* enemy : enemies_) {
 			if (enemy)
 				enemy->Update();
@@ -918,37 +814,26 @@ void GameScene::Update() {
 		
 		if (!spikes_.empty()) {
 			for (Spike* s : spikes_) {
-				if (s) s->Update(1.0f / 60.0f);
+				if (s) s->Update(FrameClock::GetInstance()->GetDeltaTime());
 			}
 		}
 		if (!ladders_.empty()) {
 			for (Ladder* l : ladders_) {
-				if (l) l->Update(1.0f / 60.0f);
+				if (l) l->Update(FrameClock::GetInstance()->GetDeltaTime());
 			}
 		}
 		for (Goal* g : goals_) {
-			if (g) g->Update(1.0f / 60.0f);
+			if (g) g->Update(FrameClock::GetInstance()->GetDeltaTime());
 		}
 
 		player_->Update();
 
-		for (auto& row : worldTransformBlocks_) {
-			for (WorldTransform* wt : row) {
-				if (!wt) {
-					continue;
-				}
-				wt->matWorld_ = MakeAffineMatrix(wt->scale_, wt->rotation_, wt->translation_);
-				if (wt->parent_) {
-					wt->matWorld_ = Multiply(wt->parent_->matWorld_, wt->matWorld_);
-				}
-				wt->TransferMatrix();
-			}
-		}
+		UpdateBlockChunks();
 
 		// Update keys
 		if (!keys_.empty()) {
             for (Key* k : keys_) {
-                if (k) k->Update(1.0f / 60.0f);
+                if (k) k->Update(FrameClock::GetInstance()->GetDeltaTime());
             }
         }
 
@@ -1042,7 +927,7 @@ void GameScene::Update() {
 					if (!h.sprite) continue;
 					if (h.removing) {
 						// progress timer
-						h.animTimer += 1.0f / 60.0f;
+						h.animTimer += FrameClock::GetInstance()->GetDeltaTime();
 						float t = h.animTimer / heartRemoveDuration_;
 						if (t > 1.0f) t = 1.0f;
 						// scale down and fade out
@@ -1108,6 +993,7 @@ void GameScene::Update() {
 
 		skydome_->Update();
 		// Update all enemies
+		UpdateNavigationTarget();
 		for (Enemy* enemy : enemies_) {
 			if (enemy)
 				enemy->Update();
@@ -1149,18 +1035,7 @@ void GameScene::Update() {
 		camera_.UpdateMatrix();
 #endif //  _DEBUG
 
-		for (auto& row : worldTransformBlocks_) {
-			for (WorldTransform* wt : row) {
-				if (!wt) {
-					continue;
-				}
-				wt->matWorld_ = MakeAffineMatrix(wt->scale_, wt->rotation_, wt->translation_);
-				if (wt->parent_) {
-					wt->matWorld_ = Multiply(wt->parent_->matWorld_, wt->matWorld_);
-				}
-				wt->TransferMatrix();
-			}
-		}
+		UpdateBlockChunks();
 
 		break;
 	case Phase::kVictory:
@@ -1192,20 +1067,13 @@ void GameScene::Update() {
 		}
 
 		// simple timer to delay scene change
-		victoryTimer_ += 1.0f / 60.0f;
+		victoryTimer_ += FrameClock::GetInstance()->GetDeltaTime();
 		if (victoryTimer_ >= victoryDuration_) {
 			finished_ = true; // signal main to change to GameClear
 		}
 
 		// keep world transforms updated for visuals
-		for (auto& row : worldTransformBlocks_) {
-			for (WorldTransform* wt : row) {
-				if (!wt) continue;
-				wt->matWorld_ = MakeAffineMatrix(wt->scale_, wt->rotation_, wt->translation_);
-				if (wt->parent_) wt->matWorld_ = Multiply(wt->parent_->matWorld_, wt->matWorld_);
-				wt->TransferMatrix();
-			}
-		}
+		UpdateBlockChunks();
 
 		break;
 	case Phase::kPause:
@@ -1230,14 +1098,7 @@ void GameScene::Update() {
 		camera_.UpdateMatrix();
 #endif
 		// ワールド変換のみ反映（オブジェクトは更新しない）
-		for (auto& row : worldTransformBlocks_) {
-			for (WorldTransform* wt : row) {
-				if (!wt) continue;
-				wt->matWorld_ = MakeAffineMatrix(wt->scale_, wt->rotation_, wt->translation_);
-				if (wt->parent_) wt->matWorld_ = Multiply(wt->parent_->matWorld_, wt->matWorld_);
-				wt->TransferMatrix();
-			}
-		}
+		UpdateBlockChunks();
 		// UIの位置だけ維持
 		if (hudSprite_) {
 			const float hudMargin = 20.0f;
@@ -1379,21 +1240,7 @@ void GameScene::Draw() {
         player_->Draw();
     }
 
-    for (auto& row : worldTransformBlocks_) {
-        for (WorldTransform* wt : row) {
-            if (!wt) {
-                continue;
-            }
-		
-			IndexSet idx = mapChipField_->GetMapChipIndexSetByPosition(wt->translation_);
-			MapChipType t = mapChipField_->GetMapChipTypeByIndex(idx.xIndex, idx.yIndex);
-			if (t == MapChipType::kIce && iceModel_) {
-				iceModel_->Draw(*wt, camera_);
-			} else {
-				blockModel_->Draw(*wt, camera_);
-			}
-        }
-    }
+    blockChunkManager_.Draw(blockModel_, iceModel_, camera_);
 
     // Particle関係
     if ((phase_ == Phase::kDeath || phase_ == Phase::kVictory) && deathParticle_) {
@@ -1475,30 +1322,277 @@ for (auto it = enemyDeathParticles_.begin(); it != enemyDeathParticles_.end();)
 }
 
 void GameScene::GenerateBlocks() {
+	// ブロックはカメラ周辺のチャンクだけ生成する（実際の生成は UpdateBlockChunks で行う）
+	// マップのデータは当たり判定・経路探索がステージ全体を参照するので、ストリーミングせずに常駐させる
+	blockChunkManager_.Initialize(mapChipField_);
+}
+
+void GameScene::UpdateBlockChunks() {
+	// SetTile で書き換わったタイルのブロックだけを直す
+	if (mapChipField_ && !mapChipField_->GetPendingTileChanges().empty()) {
+		blockChunkManager_.InvalidateTiles(mapChipField_->GetPendingTileChanges());
+		// 経路探索のグラフも書き換わったタイルの周辺だけを直す
+		navGraph_.Update(*mapChipField_->GetSnapshot(), mapChipField_->GetPendingTileChanges());
+		mapChipField_->ClearPendingTileChanges();
+	}
+
+	// カメラ周辺のチャンクを読み込み、離れたチャンクを解放する
+	// ブロックの行列は読み込み時に転送済みなので、毎フレームの再計算は不要
+	blockChunkManager_.Update(camera_.translation_);
+}
+
+void GameScene::RebuildNavigation() {
+	if (!mapChipField_) {
+		return;
+	}
+	// 敵・フローフィールドはグラフの版の変化を見て、次の更新でノードを引き直す
+	navGraph_.Build(*mapChipField_->GetSnapshot());
+}
+
+void GameScene::UpdateNavigationTarget() {
+	if (!mapChipField_ || !player_) {
+		return;
+	}
+	// ジャンプ中は着地する先の区間を目的地にする（見つからなければ前回のまま）
+	const Vector3& position = player_->GetWorldTransform().translation_;
+	uint32_t node = navGraph_.FindNodeBelow(*mapChipField_->GetSnapshot(), position);
+	navFlowField_.Update(navGraph_, node, mapChipField_->GetMapChipIndexSetByPosition(position).xIndex);
+}
+
+Vector3 GameScene::FindPlayerStartPosition() const {
+	// マップ上の最初のプレイヤー開始位置 (chip 2)。なければ既定位置
+	if (mapChipField_) {
+		std::span<const IndexSet> starts = mapChipField_->GetSpawnTiles(MapChipType::kReserved2);
+		if (!starts.empty()) {
+			return mapChipField_->GetMapChipPositionByIndex(starts.front().xIndex, starts.front().yIndex);
+		}
+	}
+	return {4.0f, 4.0f, 0.0f};
+}
+
+void GameScene::ClearMapObjects() {
+	// Delete old enemies
+	for (Enemy* e : enemies_) {
+		if (e) delete e;
+	}
+	enemies_.clear();
+	// Delete spikes
+	for (Spike* s : spikes_) {
+		if (s) delete s;
+	}
+	spikes_.clear();
+	// Delete goals
+	for (Goal* g : goals_) {
+		if (g) delete g;
+	}
+	goals_.clear();
+	// Delete keys
+	for (Key* k : keys_) {
+		if (k) delete k;
+	}
+	keys_.clear();
+	// Delete ladders
+	for (Ladder* l : ladders_) {
+		if (l) delete l;
+	}
+	ladders_.clear();
+	mapObjectOrigins_.clear();
+}
+
+void GameScene::HotReloadMap() {
+	if (!mapChipField_ || !mapFileWatcher_.Poll()) {
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
 
-	uint32_t numBlockVirtical = mapChipField_->GetNumBlockVertical();
-	uint32_t numBlockHorizontal = mapChipField_->GetNumBlockHorizontal();
+	std::vector<MapChipTileChange> changes;
+	MapChipReloadResult result = mapChipField_->ReloadMapChipCsv(mapFilePath_, changes);
+	if (result == MapChipReloadResult::kFailed || result == MapChipReloadResult::kUnchanged) {
+		return;
+	}
+
+	bool respawn = true;
+	if (result == MapChipReloadResult::kResized || result == MapChipReloadResult::kReplaced) {
+		// サイズや装飾・生成対象のレイヤーが変わったらブロックとカメラ範囲・経路探索のグラフを作り直す
+		RebuildNavigation();
+		GenerateBlocks();
+		if (cameraController_) {
+			cameraController_->SetMovableArea(mapChipField_->GetMovableArea());
+		}
+		ClearMapObjects();
+		SpawnMapObjects();
+	} else {
+		// 変わったタイルを含むチャンクと、その周辺の経路探索のグラフだけ作り直す
+		blockChunkManager_.InvalidateTiles(changes);
+		navGraph_.Update(*mapChipField_->GetSnapshot(), changes);
+		// 生成対象のタイルが変わったときだけ、そのタイルの敵などを作り直す
+		respawn = std::any_of(changes.begin(), changes.end(), [](const MapChipTileChange& c) {
+			return GetMapChipProperty(c.before).spawnKind != MapChipSpawnKind::kNone || GetMapChipProperty(c.after).spawnKind != MapChipSpawnKind::kNone;
+		});
+		if (respawn) {
+			RespawnMapObjectsAt(changes);
+		}
+	}
 
-	// 既存を破棄しクリア
-	for (auto& row : worldTransformBlocks_) {
-		for (WorldTransform* wt : row) {
-			delete wt;
+	if (respawn) {
+		for (Enemy* e : enemies_) {
+			ShooterEnemy* se = dynamic_cast<ShooterEnemy*>(e);
+			if (se) se->SetAllowShooting(phase_ != Phase::kCountdown);
 		}
 	}
-	worldTransformBlocks_.clear();
 
-	// 要素数を設定し、nullptr で初期化
-	worldTransformBlocks_.assign(numBlockVirtical, std::vector<WorldTransform*>(numBlockHorizontal, nullptr));
+	double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	DebugText::GetInstance()->ConsolePrintf(
+	    "GameScene: hot-reloaded %s (%s, %u tiles changed%s) in %.3f ms\n", mapFilePath_.c_str(), result == MapChipReloadResult::kResized ? "resized" : result == MapChipReloadResult::kReplaced ? "layers replaced" : "diff",
+	    static_cast<uint32_t>(changes.size()), respawn ? ", objects respawned" : "", elapsedMs);
+}
+
+void GameScene::SpawnMapObjects() {
+	if (!mapChipField_) {
+		return;
+	}
 
-	for (uint32_t i = 0; i < numBlockVirtical; ++i) {
-		for (uint32_t j = 0; j < numBlockHorizontal; ++j) {
-			MapChipType t = mapChipField_->GetMapChipTypeByIndex(j, i);
-			if (t == MapChipType::kBlock || t == MapChipType::kIce) {
-				WorldTransform* worldTransform = new WorldTransform();
-				worldTransform->Initialize();
-				worldTransform->translation_ = mapChipField_->GetMapChipPositionByIndex(j, i);
-				worldTransformBlocks_[i][j] = worldTransform;
+	// 生成位置の索引から、生成対象のタイルだけを種別ごとにたどる
+	for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+		MapChipType type = static_cast<MapChipType>(i);
+		for (const IndexSet& index : mapChipField_->GetSpawnTiles(type)) {
+			SpawnMapObject(type, index);
+		}
+	}
+}
+
+void GameScene::SpawnMapObject(MapChipType type, const IndexSet& index) {
+	const MapChipProperty& property = GetMapChipProperty(type);
+	Vector3 pos = mapChipField_->GetMapChipPositionByIndex(index.xIndex, index.yIndex);
+
+	const void* object = nullptr;
+	switch (property.spawnKind) {
+	case MapChipSpawnKind::kEnemy: {
+		Enemy* enemy = new Enemy();
+		enemy->Initialize(&camera_, pos, property.facing == MapChipFacing::kLeft);
+		// provide map reference for patrol behavior
+		enemy->SetMapChipField(mapChipField_);
+		enemy->SetNavigation(&navGraph_, &navFlowField_);
+		enemies_.push_back(enemy);
+		object = enemies_.back();
+		break;
+	}
+	case MapChipSpawnKind::kShieldEnemy: {
+		// シールド持ちは既定で左向き
+		// 置いた場所で正面を守る敵なので移動せず、経路探索も使わない（Update も Enemy::Update を呼ばない）
+		FrontShieldEnemy* fse = new FrontShieldEnemy();
+		fse->Initialize(&camera_, pos, property.facing != MapChipFacing::kRight);
+		fse->SetFrontDotThreshold(0.6f);
+		fse->SetMapChipField(mapChipField_);
+		enemies_.push_back(fse);
+		object = enemies_.back();
+		break;
+	}
+	case MapChipSpawnKind::kShooterEnemy: {
+		// 砲台として固定の向きへ撃つ敵なので、シールド持ちと同じく移動せず経路探索も使わない
+		ShooterEnemy* se = new ShooterEnemy();
+		se->Initialize(&camera_, pos);
+		if (property.facing == MapChipFacing::kRight) {
+			se->SetFacingRight(true);
+		}
+		se->SetBulletSpeed(0.2f);
+		se->SetFireInterval(2.0f);
+		se->SetMapChipField(mapChipField_);
+		enemies_.push_back(se);
+		object = enemies_.back();
+		break;
+	}
+	case MapChipSpawnKind::kSpike: {
+		Spike* sp = new Spike();
+		sp->SetPosition(pos);
+		sp->Initialize();
+		spikes_.push_back(sp);
+		object = sp;
+		break;
+	}
+	case MapChipSpawnKind::kGoal:
+		// ゴールは最初の 1 つだけ
+		if (goals_.empty()) {
+			Goal* g = new Goal();
+			g->SetPosition(pos);
+			g->Initialize();
+			goals_.push_back(g);
+			object = g;
+		}
+		break;
+	case MapChipSpawnKind::kKey: {
+		Key* k = new Key();
+		k->SetPosition(pos);
+		k->Initialize();
+		keys_.push_back(k);
+		object = k;
+		break;
+	}
+	case MapChipSpawnKind::kLadder: {
+		Ladder* l = new Ladder();
+		l->SetPosition(pos);
+		l->Initialize();
+		ladders_.push_back(l);
+		object = l;
+		break;
+	}
+	default:
+		// プレイヤー開始位置・ステージノードはここでは生成しない
+		break;
+	}
+
+	if (object) {
+		mapObjectOrigins_[object] = {index, type};
+	}
+}
+
+void GameScene::RespawnMapObjectsAt(std::span<const MapChipTileChange> changes) {
+	// 生成対象の種別から変わったタイルを、座標で引けるようにする
+	auto key = [](const IndexSet& index) { return static_cast<uint64_t>(index.yIndex) << 32 | index.xIndex; };
+	std::unordered_map<uint64_t, MapChipType> removed;
+	for (const MapChipTileChange& change : changes) {
+		if (GetMapChipProperty(change.before).spawnKind != MapChipSpawnKind::kNone) {
+			removed.emplace(key(change.index), change.before);
+		}
+	}
+
+	// 変わったタイルから生成したオブジェクトだけを破棄する（倒した敵・取った鍵など、他のオブジェクトの状態は保つ）
+	auto removeChanged = [&](auto& objects) {
+		std::erase_if(objects, [&](auto* object) {
+			auto origin = mapObjectOrigins_.find(object);
+			if (origin == mapObjectOrigins_.end()) {
+				return false;
+			}
+			auto it = removed.find(key(origin->second.index));
+			if (it == removed.end() || it->second != origin->second.type) {
+				return false;
 			}
+			// 1 つのタイルから生成するのは 1 つだけ
+			removed.erase(it);
+			mapObjectOrigins_.erase(origin);
+			delete object;
+			return true;
+		});
+	};
+	removeChanged(enemies_);
+	removeChanged(spikes_);
+	removeChanged(goals_);
+	removeChanged(keys_);
+	removeChanged(ladders_);
+
+	for (const MapChipTileChange& change : changes) {
+		if (GetMapChipProperty(change.after).spawnKind != MapChipSpawnKind::kNone) {
+			SpawnMapObject(change.after, change.index);
+		}
+	}
+
+	// ゴールを消した場合は、残っているゴールのタイルのうち SpawnMapObjects と同じ順で最初のものに置き直す
+	for (uint32_t i = 0; i < kMapChipTypeCount && goals_.empty(); ++i) {
+		MapChipType type = static_cast<MapChipType>(i);
+		std::span<const IndexSet> tiles = mapChipField_->GetSpawnTiles(type);
+		if (GetMapChipProperty(type).spawnKind == MapChipSpawnKind::kGoal && !tiles.empty()) {
+			SpawnMapObject(type, tiles.front());
 		}
 	}
 }
@@ -1633,6 +1727,7 @@ for (Spike* s : spikes_) {
 		// If key already finished its collection animation, give it to player and remove
 		if (k->IsCollected()) {
 			player_->ConsumeKey();
+			mapObjectOrigins_.erase(k);
 			delete k;
 			it = keys_.erase(it);
 			continue;
@@ -1708,22 +1803,8 @@ void GameScene::PerformResetNow() {
 		delete player_;
 		player_ = nullptr;
 	}
-	Vector3 playerPosition = {4.0f, 4.0f, 0.0f};
 	// Recompute spawn position from map chip 2 if available
-	if (mapChipField_) {
-		uint32_t vh = mapChipField_->GetNumBlockVertical();
-		uint32_t wh = mapChipField_->GetNumBlockHorizontal();
-		bool found = false;
-		for (uint32_t y = 0; y < vh && !found; ++y) {
-			for (uint32_t x = 0; x < wh; ++x) {
-				if (mapChipField_->GetMapChipTypeByIndex(x, y) == MapChipType::kReserved2) {
-					playerPosition = mapChipField_->GetMapChipPositionByIndex(x, y);
-					found = true;
-					break;
-				}
-			}
-			}
-	}
+	Vector3 playerPosition = FindPlayerStartPosition();
 	player_ = new Player();
 	player_->Initialize(&camera_, playerPosition);
 	player_->SetMapChipField(mapChipField_);
@@ -1962,102 +2043,10 @@ void GameScene::PerformResetNow() {
 	}
 
 	// Ensure existing dynamic objects are cleared and respawned so reset creates fresh enemies, spikes, goals, keys, ladders
-	// Delete old enemies
-	for (Enemy* e : enemies_) {
-		if (e) delete e;
-	}
-	enemies_.clear();
-	// Delete spikes
-	for (Spike* s : spikes_) {
-		if (s) delete s;
-	}
-	spikes_.clear();
-	// Delete goals
-	for (Goal* g : goals_) {
-		if (g) delete g;
-	}
-	goals_.clear();
-	// Delete keys
-	for (Key* k : keys_) {
-		if (k) delete k;
-	}
-	keys_.clear();
-	// Delete ladders
-for (Ladder* l : ladders_) {
-		if (l) delete l;
-	}
-	ladders_.clear();
+	ClearMapObjects();
 
 	// Respawn entities from the map
-	if (mapChipField_) {
-		uint32_t vh = mapChipField_->GetNumBlockVertical();
-		uint32_t wh = mapChipField_->GetNumBlockHorizontal();
-		bool goalSpawned = false;
-		for (uint32_t y = 0; y < vh; ++y) {
-			for (uint32_t x = 0; x < wh; ++x) {
-				MapChipType t = mapChipField_->GetMapChipTypeByIndex(x, y);
-				Vector3 pos = mapChipField_->GetMapChipPositionByIndex(x, y);
-				if (t == MapChipType::kEnemySpawn) {
-					Enemy* enemy = new Enemy();
-					enemy->Initialize(&camera_, pos);
-					enemy->SetMapChipField(mapChipField_);
-					enemies_.push_back(enemy);
-				} else if (t == MapChipType::kEnemySpawnShield) {
-					FrontShieldEnemy* fse = new FrontShieldEnemy();
-					fse->Initialize(&camera_, pos);
-					fse->SetFrontDotThreshold(0.6f);
-					fse->SetMapChipField(mapChipField_);
-					enemies_.push_back(fse);
-				} else if (t == MapChipType::kEnemySpawnShieldRight) {
-					FrontShieldEnemy* fse = new FrontShieldEnemy();
-					fse->Initialize(&camera_, pos, false); // face right
-					fse->SetFrontDotThreshold(0.6f);
-					fse->SetMapChipField(mapChipField_);
-					enemies_.push_back(fse);
-				} else if (t == MapChipType::kShooter) {
-					ShooterEnemy* se = new ShooterEnemy();
-					se->Initialize(&camera_, pos);
-					se->SetBulletSpeed(0.2f);
-					se->SetFireInterval(2.0f);
-					se->SetMapChipField(mapChipField_);
-					enemies_.push_back(se);
-				} else if (t == MapChipType::kShooterRight) {
-					ShooterEnemy* se = new ShooterEnemy();
-					se->Initialize(&camera_, pos);
-					se->SetFacingRight(true); // face right
-					se->SetBulletSpeed(0.2f);
-					se->SetFireInterval(2.0f);
-					se->SetMapChipField(mapChipField_);
-					enemies_.push_back(se);
-				} else if (t == MapChipType::kSpike) {
-					Spike* s = new Spike();
-					s->SetPosition(pos);
-					s->Initialize();
-					spikes_.push_back(s);
-				} else if (t == MapChipType::kGoal && !goalSpawned) {
-					Goal* g = new Goal();
-					g->SetPosition(pos);
-					g->Initialize();
-					goals_.push_back(g);
-					goalSpawned = true;
-				} else if (t == MapChipType::kLadder) {
-					Ladder* l = new Ladder();
-					l->SetPosition(pos);
-					l->Initialize();
-					ladders_.push_back(l);
-				} else if (t == MapChipType::kKey) {
-					Key* k = new Key();
-					k->SetPosition(pos);
-					k->Initialize();
-					keys_.push_back(k);
-				} else if (t == MapChipType::kEnemySpawnLeft) {
-					Enemy* enemy = new Enemy();
-					enemy->Initialize(&camera_, pos, true); 
-					enemies_.push_back(enemy);
-				}
-			}
-		}
-	}
+	SpawnMapObjects();
 
 	
 	for (Enemy* e : enemies_) {
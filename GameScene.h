@@ -2,13 +2,19 @@
 
 #include "KamataEngine.h"
 
+#include "BlockChunkManager.h"
 #include "CameraController.h"
 #include "DeathParticle.h"
+#include "FileWatcher.h"
 #include "Enemy.h"
+#include "MapChipNavGraph.h"
 #include"EnemyDeathParticle.h"
 #include "Player.h"
 #include "Skydome.h"
 
+#include <span>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 class MapChipField_;
@@ -38,6 +44,21 @@ public:
 
 	void GenerateBlocks();
 
+	/// <summary>
+	/// 実行中に書き換わったタイルをブロックへ反映し、カメラ位置に合わせてチャンクを読み込み・解放する
+	/// </summary>
+	void UpdateBlockChunks();
+
+	/// <summary>
+	/// 現在のマップから敵の経路探索用のグラフを作り直す（マップを読み込んだ・書き換えたとき）
+	/// </summary>
+	void RebuildNavigation();
+
+	/// <summary>
+	/// 敵が追う目的地（プレイヤーの足元の区間）を更新する。区間が変わったときだけ探索し直す
+	/// </summary>
+	void UpdateNavigationTarget();
+
 	/// <summary>
 	/// マップチップ以外の当たり判定をすべてチェックする
 	/// </summary>
@@ -70,6 +91,38 @@ private:
 	
 	void PerformResetNow();
 
+	/// <summary>
+	/// マップ上のプレイヤー開始位置を返す（なければ既定位置）
+	/// </summary>
+	KamataEngine::Vector3 FindPlayerStartPosition() const;
+
+	/// <summary>
+	/// マップの生成位置の索引から敵・棘・ゴール・鍵・ハシゴを生成する
+	/// </summary>
+	void SpawnMapObjects();
+
+	/// <summary>
+	/// 指定タイルの種別に応じて敵・棘・ゴール・鍵・ハシゴを 1 つ生成し、生成元として記録する（生成対象でなければ何もしない）
+	/// </summary>
+	void SpawnMapObject(MapChipType type, const IndexSet& index);
+
+	/// <summary>
+	/// 差分リロードで変わったタイルから生成したオブジェクトだけを破棄し、変わった後の種別で生成し直す
+	/// 他のタイルのオブジェクト（倒した敵・取った鍵など）はそのままにする
+	/// </summary>
+	void RespawnMapObjectsAt(std::span<const MapChipTileChange> changes);
+
+	/// <summary>
+	/// マップから生成した敵・棘・ゴール・鍵・ハシゴをすべて破棄する
+	/// </summary>
+	void ClearMapObjects();
+
+	/// <summary>
+	/// 監視中のマップ CSV が保存されていれば差分を反映する（デバッグ用）
+	/// プレイヤー・カメラ・フェーズはそのままにする。敵などは変わったタイルの分だけ作り直す（サイズ・レイヤーが変わったときはすべて）
+	/// </summary>
+	void HotReloadMap();
+
 	bool finished_ = false;
 	int startingStage_ = 0; 
 
@@ -100,6 +153,10 @@ private:
 	CameraController* cameraController_ = nullptr;
 	MapChipField* mapChipField_ = nullptr;
 
+	// 読み込んだマップのパスと、ホットリロード用の監視
+	std::string mapFilePath_;
+	FileWatcher mapFileWatcher_;
+
 	// Particle関係
 	DeathParticle* deathParticle_ = nullptr;
 	std::vector<EnemyDeathParticle*> enemyDeathParticles_;
@@ -112,9 +169,21 @@ private:
 	std::vector<Goal*> goals_;     
 	std::vector<Key*> keys_;       
 	std::vector<Ladder*> ladders_; 
+
+	// マップから生成したオブジェクトの生成元のタイルと種別（差分リロードで変わったタイルの分だけ作り直すため）
+	struct MapObjectOrigin {
+		IndexSet index;
+		MapChipType type;
+	};
+	std::unordered_map<const void*, MapObjectOrigin> mapObjectOrigins_;
 	Player* player_ = nullptr;
 
-	std::vector<std::vector<KamataEngine::WorldTransform*>> worldTransformBlocks_;
+	// ブロックの描画リソース（カメラ周辺のチャンクのみ常駐）
+	BlockChunkManager blockChunkManager_;
+
+	// 敵の経路探索。グラフはマップから作り、プレイヤーへの経路はすべての敵で共有する
+	MapChipNavGraph navGraph_;
+	MapChipNavFlowField navFlowField_;
 
 	Phase phase_ = Phase::kPlay;
 
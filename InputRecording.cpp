@@ -0,0 +1,231 @@
+#include "InputRecording.h"
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace {
+
+/// <summary>
+/// 左スティックの値を -1.0f ～ 1.0f にし、デッドゾーン内は 0 にする
+/// </summary>
+float NormalizeLeftStick(int16_t rawValue) {
+	const float denom = 32767.0f;
+	float v = 0.0f;
+	if (rawValue == -32768) {
+		v = -1.0f;
+	} else {
+		v = static_cast<float>(rawValue) / denom;
+	}
+	v = std::clamp(v, -1.0f, 1.0f);
+	const float deadzone = static_cast<float>(kInputLeftThumbDeadzone) / denom;
+	if (std::fabs(v) < deadzone) {
+		return 0.0f;
+	}
+	return v;
+}
+
+} // namespace
+
+PlayerInput ToPlayerInput(const InputRecordFrame& frame) {
+	auto pushed = [&frame](uint16_t keys) { return (frame.keys & keys) != 0; };
+
+	PlayerInput result;
+	result.stickX = NormalizeLeftStick(frame.thumbLX);
+	result.stickY = NormalizeLeftStick(frame.thumbLY);
+	result.left = pushed(kInputKeyLeft | kInputKeyA);
+	result.right = pushed(kInputKeyRight | kInputKeyD);
+	result.up = pushed(kInputKeyW);
+	result.down = pushed(kInputKeyS);
+	result.jumpKey = pushed(kInputKeyUp | kInputKeySpace);
+	result.jumpButton = (frame.buttons & kInputGamepadButtonA) != 0;
+	result.dodgeKey = pushed(kInputKeyQ);
+	result.dodgeButton = frame.leftTrigger > kInputTriggerThreshold;
+	result.attackKey = pushed(kInputKeyE);
+	result.attackButton = frame.rightTrigger > kInputTriggerThreshold;
+	return result;
+}
+
+void InputTrajectoryHash::Add(const PlayerVector2& position, const PlayerVector2& velocity) {
+	const float values[] = {position.x, position.y, velocity.x, velocity.y};
+	for (float value : values) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		value_ = (value_ ^ bits) * 1099511628211ull;
+	}
+}
+
+bool SaveInputRecording(const std::string& path, const InputRecording& recording) {
+	// 同じ入力が続く間を 1 つの InputRecordRun にまとめる
+	std::vector<InputRecordRun> runs;
+	for (const InputRecordFrame& frame : recording.frames) {
+		if (!runs.empty() && runs.back().frame == frame && runs.back().count < UINT16_MAX) {
+			++runs.back().count;
+		} else {
+			InputRecordRun run = {};
+			run.frame = frame;
+			run.count = 1;
+			runs.push_back(run);
+		}
+	}
+
+	InputRecordFileHeader header = {};
+	std::memcpy(header.magic, "PINP", sizeof(header.magic));
+	header.version = kInputRecordFileVersion;
+	header.frameCount = static_cast<uint32_t>(recording.frames.size());
+	header.runCount = static_cast<uint32_t>(runs.size());
+	header.startX = recording.start.x;
+	header.startY = recording.start.y;
+	header.trajectoryHash = recording.trajectoryHash;
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(runs.data()), static_cast<std::streamsize>(runs.size() * sizeof(InputRecordRun)));
+	return file.good();
+}
+
+bool LoadInputRecording(const std::string& path, InputRecording& recording) {
+	MappedFile file;
+	if (!file.Open(path)) {
+		return false;
+	}
+	InputRecordFileHeader header = {};
+	if (file.GetSize() < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, file.GetData(), sizeof(header));
+	if (std::memcmp(header.magic, "PINP", sizeof(header.magic)) != 0 || header.version != kInputRecordFileVersion) {
+		return false;
+	}
+	if (file.GetSize() < sizeof(header) + static_cast<size_t>(header.runCount) * sizeof(InputRecordRun)) {
+		return false;
+	}
+
+	// 展開する前に、各 run の長さの合計がヘッダーと合い、上限に収まることを確かめる（壊れたファイルで巨大な確保をしないように）
+	const char* data = file.GetData() + sizeof(header);
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < header.runCount; ++i) {
+		InputRecordRun run;
+		std::memcpy(&run, data + static_cast<size_t>(i) * sizeof(run), sizeof(run));
+		total += run.count;
+	}
+	if (total != header.frameCount || total > kInputRecordMaxFrames) {
+		return false;
+	}
+
+	recording.start = {header.startX, header.startY};
+	recording.trajectoryHash = header.trajectoryHash;
+	recording.frames.clear();
+	recording.frames.reserve(header.frameCount);
+	for (uint32_t i = 0; i < header.runCount; ++i) {
+		InputRecordRun run;
+		std::memcpy(&run, data + static_cast<size_t>(i) * sizeof(run), sizeof(run));
+		recording.frames.insert(recording.frames.end(), run.count, run.frame);
+	}
+	return true;
+}
+
+InputRecorder* InputRecorder::GetInstance() {
+	static InputRecorder instance;
+	return &instance;
+}
+
+const char* InputRecorder::GetResultText(SessionResult result) {
+	switch (result) {
+	case SessionResult::kSaved:
+		return "recording saved";
+	case SessionResult::kSaveFailed:
+		return "failed to save the recording";
+	case SessionResult::kReplayMatched:
+		return "replay finished, trajectory matches the recording";
+	case SessionResult::kReplayDiverged:
+		return "replay finished, trajectory DIFFERS from the recording";
+	case SessionResult::kReplayCut:
+		return "replay stopped before the end";
+	default:
+		return nullptr;
+	}
+}
+
+InputRecorder::SessionResult InputRecorder::ToggleRecording(const std::string& path) {
+	if (mode_ == Mode::kRecording) {
+		pending_ = Mode::kLive;
+		return EndSession();
+	}
+	if (pending_ == Mode::kRecording) {
+		pending_ = Mode::kLive;
+		return SessionResult::kNone;
+	}
+	pending_ = Mode::kRecording;
+	recordPath_ = path;
+	return SessionResult::kNone;
+}
+
+bool InputRecorder::ArmReplay(const std::string& path) {
+	if (!LoadInputRecording(path, pendingReplay_)) {
+		return false;
+	}
+	pending_ = Mode::kReplaying;
+	return true;
+}
+
+InputRecorder::SessionResult InputRecorder::BeginSession(const PlayerVector2& start) {
+	SessionResult result = EndSession();
+
+	frameIndex_ = 0;
+	hash_ = InputTrajectoryHash();
+	if (pending_ == Mode::kRecording) {
+		recording_.start = start;
+		recording_.trajectoryHash = 0;
+		recording_.frames.clear();
+		mode_ = Mode::kRecording;
+	} else if (pending_ == Mode::kReplaying && !pendingReplay_.frames.empty()) {
+		recording_ = std::move(pendingReplay_);
+		pendingReplay_ = InputRecording();
+		mode_ = Mode::kReplaying;
+	}
+	pending_ = Mode::kLive;
+	return result;
+}
+
+InputRecordFrame InputRecorder::Filter(const InputRecordFrame& live) {
+	if (mode_ == Mode::kRecording) {
+		recording_.frames.push_back(live);
+	} else if (mode_ == Mode::kReplaying && frameIndex_ < recording_.frames.size()) {
+		return recording_.frames[frameIndex_];
+	}
+	return live;
+}
+
+InputRecorder::SessionResult InputRecorder::EndStep(const PlayerVector2& position, const PlayerVector2& velocity) {
+	if (mode_ == Mode::kLive) {
+		return SessionResult::kNone;
+	}
+	hash_.Add(position, velocity);
+	++frameIndex_;
+	if (mode_ == Mode::kReplaying && frameIndex_ >= recording_.frames.size()) {
+		mode_ = Mode::kLive;
+		return hash_.GetValue() == recording_.trajectoryHash ? SessionResult::kReplayMatched : SessionResult::kReplayDiverged;
+	}
+	return SessionResult::kNone;
+}
+
+InputRecorder::SessionResult InputRecorder::EndSession() {
+	Mode mode = mode_;
+	mode_ = Mode::kLive;
+	if (mode == Mode::kRecording) {
+		recording_.trajectoryHash = hash_.GetValue();
+		return SaveInputRecording(recordPath_, recording_) ? SessionResult::kSaved : SessionResult::kSaveFailed;
+	}
+	if (mode == Mode::kReplaying) {
+		return SessionResult::kReplayCut;
+	}
+	return SessionResult::kNone;
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "PlayerPhysics.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// プレイヤー操作の記録と再生（エンジン非依存）
+// Player が読むパッドの生の状態 (XINPUT_STATE の Gamepad) と、Player が見るキーの押下を 1 ステップごとに記録し、
+// 再生中は実際の入力の代わりにそれを渡す。PlayerPhysics は入力とマップが同じなら必ず同じ動きをするので、軌跡がそのまま再現される
+// 記録したファイルは Tools/PlayerPhysicsBench --replay でも読め、ビルド間の性能比較の標準の入力にもなる
+
+// Player が見るキー（InputRecordFrame::keys のビット）。値はファイルに残るので、既存のビットは変えない
+enum InputRecordKey : uint16_t {
+	kInputKeyLeft = 1u << 0,  // ←
+	kInputKeyRight = 1u << 1, // →
+	kInputKeyUp = 1u << 2,    // ↑
+	kInputKeyA = 1u << 3,
+	kInputKeyD = 1u << 4,
+	kInputKeyW = 1u << 5,
+	kInputKeyS = 1u << 6,
+	kInputKeyQ = 1u << 7,
+	kInputKeyE = 1u << 8,
+	kInputKeySpace = 1u << 9,
+};
+
+// XInput の定数（Xinput.h を含めずに PlayerInput へ変換するため。Player.cpp で Xinput.h の値と一致することを確かめる）
+inline constexpr uint16_t kInputGamepadButtonA = 0x1000;
+inline constexpr int16_t kInputLeftThumbDeadzone = 7849;
+inline constexpr uint8_t kInputTriggerThreshold = 30;
+
+/// <summary>
+/// 1 ステップ分の入力（10 バイト）。パッドの値は XINPUT_GAMEPAD のまま持つ
+/// </summary>
+struct InputRecordFrame {
+	int16_t thumbLX;
+	int16_t thumbLY;
+	uint16_t buttons;     // wButtons
+	uint8_t leftTrigger;  // bLeftTrigger
+	uint8_t rightTrigger; // bRightTrigger
+	uint16_t keys;        // InputRecordKey の組み合わせ
+};
+static_assert(sizeof(InputRecordFrame) == 10);
+
+inline bool operator==(const InputRecordFrame& a, const InputRecordFrame& b) {
+	return a.thumbLX == b.thumbLX && a.thumbLY == b.thumbLY && a.buttons == b.buttons && a.leftTrigger == b.leftTrigger && a.rightTrigger == b.rightTrigger &&
+	       a.keys == b.keys;
+}
+
+/// <summary>
+/// 記録したパッド・キーの状態を PlayerInput にする（Player と PlayerPhysicsBench で同じ変換を使う）
+/// </summary>
+PlayerInput ToPlayerInput(const InputRecordFrame& frame);
+
+/// <summary>
+/// 1 回分の記録（Player の Initialize から次の Initialize まで）
+/// </summary>
+struct InputRecording {
+	PlayerVector2 start = {};      // 記録を始めたときのプレイヤーの位置
+	uint64_t trajectoryHash = 0;   // 全ステップの位置・速度から作ったハッシュ（InputTrajectoryHash）
+	std::vector<InputRecordFrame> frames;
+};
+
+/// <summary>
+/// ステップごとの位置・速度から作るハッシュ（FNV-1a）。再生で同じ値になれば軌跡が一致している
+/// </summary>
+class InputTrajectoryHash {
+public:
+	static constexpr uint64_t kOffsetBasis = 1469598103934665603ull;
+
+	void Add(const PlayerVector2& position, const PlayerVector2& velocity);
+
+	uint64_t GetValue() const { return value_; }
+
+private:
+	uint64_t value_ = kOffsetBasis;
+};
+
+// ---- ファイル ----
+//
+// 先頭に InputRecordFileHeader、続いて runCount 個の InputRecordRun（同じ入力が続く間を 1 つにまとめる）
+// ボタンを押しっぱなしにしている間はほとんど同じ値が続くので、1 分（3600 ステップ）で数 KB に収まる
+
+/// <summary>
+/// 記録ファイルの先頭
+/// </summary>
+struct InputRecordFileHeader {
+	char magic[4];       // "PINP"
+	uint32_t version;    // kInputRecordFileVersion
+	uint32_t frameCount; // 展開後のステップ数
+	uint32_t runCount;   // 続く InputRecordRun の数
+	float startX;
+	float startY;
+	uint64_t trajectoryHash;
+};
+static_assert(sizeof(InputRecordFileHeader) == 32);
+
+/// <summary>
+/// 同じ入力が count ステップ続く
+/// </summary>
+struct InputRecordRun {
+	InputRecordFrame frame;
+	uint16_t count; // 1 ～ 65535
+};
+static_assert(sizeof(InputRecordRun) == 12);
+
+inline constexpr uint32_t kInputRecordFileVersion = 1;
+
+// 読み込む記録の長さの上限（60 ステップ/秒で 10 時間。InputRecordFrame 10 バイトで 20 MiB 強）
+inline constexpr uint32_t kInputRecordMaxFrames = 60u * 60u * 60u * 10u;
+
+/// <summary>
+/// 記録をファイルに書く
+/// </summary>
+/// <returns>書けなければ false</returns>
+bool SaveInputRecording(const std::string& path, const InputRecording& recording);
+
+/// <summary>
+/// ファイルから記録を読む
+/// </summary>
+/// <returns>開けない・形式が違う・途中で切れていれば false</returns>
+bool LoadInputRecording(const std::string& path, InputRecording& recording);
+
+/// <summary>
+/// ゲーム中の記録・再生の切り替え
+/// F10・F11（main.cpp）で「次に Player が Initialize されたときから」の記録・再生を予約し、Player が毎ステップ Filter を通す
+/// </summary>
+class InputRecorder {
+public:
+	enum class Mode {
+		kLive,      // 実際の入力をそのまま使う
+		kRecording, // 実際の入力を使い、記録する
+		kReplaying, // 記録した入力を使う
+	};
+
+	/// <summary>
+	/// Player の Initialize から 1 回の記録・再生が終わったときの結果（Player が表示する）
+	/// </summary>
+	enum class SessionResult {
+		kNone,
+		kSaved,           // 記録をファイルに書いた
+		kSaveFailed,      // 記録をファイルに書けなかった
+		kReplayMatched,   // 最後まで再生し、軌跡が記録と一致した
+		kReplayDiverged,  // 最後まで再生したが、軌跡が記録と違った
+		kReplayCut,       // 最後まで再生する前に次の Initialize が来た
+	};
+
+	static InputRecorder* GetInstance();
+
+	/// <summary>
+	/// SessionResult を表示用の文にする（kNone なら nullptr）
+	/// </summary>
+	static const char* GetResultText(SessionResult result);
+
+	/// <summary>
+	/// 次の BeginSession から記録する。記録中なら止めて path に書き、予約中なら予約を取り消す
+	/// </summary>
+	/// <returns>止めて書いたときの結果（予約・取り消しだけなら kNone）</returns>
+	SessionResult ToggleRecording(const std::string& path);
+
+	/// <summary>
+	/// path の記録を読み、次の BeginSession から再生する
+	/// </summary>
+	/// <returns>読めなければ false</returns>
+	bool ArmReplay(const std::string& path);
+
+	/// <summary>
+	/// Player の Initialize で呼ぶ。予約があれば記録・再生を始め、前の記録・再生はそこで終える
+	/// </summary>
+	/// <returns>前の記録・再生を終えた結果</returns>
+	SessionResult BeginSession(const PlayerVector2& start);
+
+	/// <summary>
+	/// 1 ステップ分の入力を通す。記録中は live を残してそのまま、再生中は記録した入力を返す
+	/// 再生が最後まで進んだら実際の入力に戻す
+	/// </summary>
+	InputRecordFrame Filter(const InputRecordFrame& live);
+
+	/// <summary>
+	/// Filter の入力で PlayerPhysics を 1 ステップ進めた結果を渡す
+	/// </summary>
+	/// <returns>再生が最後まで進んだ結果（途中なら kNone）</returns>
+	SessionResult EndStep(const PlayerVector2& position, const PlayerVector2& velocity);
+
+	Mode GetMode() const { return mode_; }
+
+	// 次の BeginSession で始める記録・再生（予約がなければ kLive）
+	Mode GetPendingMode() const { return pending_; }
+
+	// 記録中・再生中の記録（再生では start が Initialize の位置と同じかの確認に使う）
+	const InputRecording& GetRecording() const { return recording_; }
+
+	// 今の記録・再生で進めたステップ数
+	uint32_t GetFrameIndex() const { return frameIndex_; }
+
+private:
+	InputRecorder() = default;
+
+	SessionResult EndSession();
+
+	Mode mode_ = Mode::kLive;
+	Mode pending_ = Mode::kLive;
+
+	std::string recordPath_;
+	InputRecording recording_;
+	InputRecording pendingReplay_;
+
+	uint32_t frameIndex_ = 0;
+	InputTrajectoryHash hash_;
+};
@@ -0,0 +1,104 @@
+#include "MapChipBitPlanes.h"
+
+#include <algorithm>
+#include <bit>
+
+void MapChipBitPlanes::Update(uint32_t xIndex, uint32_t yIndex, MapChipType type) {
+	uint32_t mask = GetMapChipPlaneMask(type);
+	size_t word = static_cast<size_t>(yIndex) * wordsPerRow_ + (xIndex >> 6);
+	uint64_t bit = 1ull << (xIndex & 63);
+	for (uint32_t plane = 0; plane < kMapChipPlaneCount; ++plane) {
+		if (mask & (1u << plane)) {
+			planes_[plane][word] |= bit;
+		} else {
+			planes_[plane][word] &= ~bit;
+		}
+	}
+	UpdateDistanceFieldAt(xIndex, yIndex);
+}
+
+size_t MapChipBitPlanes::GetPlaneBytes() const {
+	size_t bytes = 0;
+	for (const std::vector<uint64_t>& plane : planes_) {
+		bytes += plane.capacity() * sizeof(uint64_t);
+	}
+	return bytes;
+}
+
+void MapChipBitPlanes::Reset(uint32_t width, uint32_t height) {
+	width_ = width;
+	height_ = height;
+	wordsPerRow_ = (width + 63) / 64;
+	size_t wordCount = static_cast<size_t>(wordsPerRow_) * height;
+	for (std::vector<uint64_t>& plane : planes_) {
+		plane.assign(wordCount, 0);
+	}
+}
+
+void MapChipBitPlanes::SetRun(uint32_t first, uint32_t count, uint32_t yIndex, uint32_t planeMask) {
+	for (uint32_t plane = 0; plane < kMapChipPlaneCount; ++plane) {
+		if (planeMask & (1u << plane)) {
+			SetMapChipPlaneBits(planes_[plane].data() + static_cast<size_t>(yIndex) * wordsPerRow_, first, count);
+		}
+	}
+}
+
+void MapChipBitPlanes::RebuildDistanceField() {
+	const size_t width = width_;
+	groundDistance_.assign(width * height_, kMapChipDistanceNone);
+	ceilingDistance_.assign(width * height_, kMapChipDistanceNone);
+	if (height_ == 0) {
+		return;
+	}
+
+	// 1 つ下（上）の行の値 + 1 を行単位で伝播させ、プレーンのビットが立つタイルだけ 0 にする
+	// min(d, 254) + 1 は 255 で飽和するので「なし」と「遠い」は区別しない
+	auto propagate = [&](std::vector<uint8_t>& field, MapChipPlane plane, uint32_t y, const uint8_t* prevRow) {
+		uint8_t* row = field.data() + y * width;
+		if (prevRow) {
+			for (size_t x = 0; x < width; ++x) {
+				row[x] = static_cast<uint8_t>(std::min<uint8_t>(prevRow[x], kMapChipDistanceNone - 1) + 1);
+			}
+		}
+		const uint64_t* bits = GetRow(plane, y);
+		for (uint32_t w = 0; w < wordsPerRow_; ++w) {
+			for (uint64_t word = bits[w]; word != 0; word &= word - 1) {
+				row[(static_cast<size_t>(w) << 6) + std::countr_zero(word)] = 0;
+			}
+		}
+	};
+
+	for (uint32_t y = height_; y-- > 0;) {
+		propagate(groundDistance_, MapChipPlane::kGround, y, y + 1 < height_ ? groundDistance_.data() + (y + 1) * width : nullptr);
+	}
+	for (uint32_t y = 0; y < height_; ++y) {
+		propagate(ceilingDistance_, MapChipPlane::kSolid, y, y > 0 ? ceilingDistance_.data() + (y - 1) * width : nullptr);
+	}
+}
+
+void MapChipBitPlanes::UpdateDistanceFieldAt(uint32_t xIndex, uint32_t yIndex) {
+	const size_t width = width_;
+	auto next = [](uint8_t d) { return static_cast<uint8_t>(std::min<uint8_t>(d, kMapChipDistanceNone - 1) + 1); };
+
+	// 真下の ground までの距離は、そのタイルから上へ伝わる
+	for (int64_t y = yIndex; y >= 0; --y) {
+		uint8_t below = static_cast<uint32_t>(y) + 1 < height_ ? groundDistance_[(y + 1) * width + xIndex] : kMapChipDistanceNone;
+		uint8_t value = TestMask(MapChipPlaneMask(MapChipPlane::kGround), xIndex, static_cast<uint32_t>(y)) ? 0 : next(below);
+		uint8_t& current = groundDistance_[y * width + xIndex];
+		if (current == value) {
+			break;
+		}
+		current = value;
+	}
+
+	// 真上の solid までの距離は、そのタイルから下へ伝わる
+	for (uint32_t y = yIndex; y < height_; ++y) {
+		uint8_t above = y > 0 ? ceilingDistance_[(y - 1) * width + xIndex] : kMapChipDistanceNone;
+		uint8_t value = TestMask(MapChipPlaneMask(MapChipPlane::kSolid), xIndex, y) ? 0 : next(above);
+		uint8_t& current = ceilingDistance_[y * width + xIndex];
+		if (current == value) {
+			break;
+		}
+		current = value;
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "MapChipType.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 距離場で「遠すぎる、またはその方向に該当タイルがない」ことを表す値
+inline constexpr uint8_t kMapChipDistanceNone = 255;
+
+/// <summary>
+/// 1 行分のビット列（64 タイルずつのワード）の [first, first + count) のビットを立てる（count は 1 以上）
+/// </summary>
+inline void SetMapChipPlaneBits(uint64_t* words, uint32_t first, uint32_t count) {
+	uint32_t last = first + count - 1;
+	uint32_t firstWord = first >> 6;
+	uint32_t lastWord = last >> 6;
+	uint64_t firstMask = ~0ull << (first & 63);
+	uint64_t lastMask = ~0ull >> (63 - (last & 63));
+	if (firstWord == lastWord) {
+		words[firstWord] |= firstMask & lastMask;
+		return;
+	}
+	words[firstWord] |= firstMask;
+	for (uint32_t w = firstWord + 1; w < lastWord; ++w) {
+		words[w] = ~0ull;
+	}
+	words[lastWord] |= lastMask;
+}
+
+/// <summary>
+/// 当たり判定レイヤーから作る、全タイル分のビットプレーンと、真下の ground・真上の solid までの距離場
+/// 既定の格納方式の MapChipSnapshot が持つ（連長圧縮では持たない。kMapChipStoreBitPlanes を参照）
+/// </summary>
+class MapChipBitPlanes {
+public:
+	/// <summary>
+	/// タイルから作り直す（Store は ForEachRun を持つタイルの格納方式）
+	/// 同じ種別が続く区間ごとにビットを立てるので、圧縮した格納方式では空白の区間をまとめて飛ばせる
+	/// </summary>
+	template <typename Store> void Build(const Store& tiles, uint32_t width, uint32_t height) {
+		Reset(width, height);
+		for (uint32_t y = 0; y < height; ++y) {
+			tiles.ForEachRun(y, [&](uint32_t first, uint32_t count, MapChipType type) { SetRun(first, count, y, GetMapChipPlaneMask(type)); });
+		}
+		RebuildDistanceField();
+	}
+
+	/// <summary>
+	/// 1 タイルの種別の変更を反映する。ビットプレーンはそのタイルだけ、距離場は値が変わらなくなるまで上下へ伝える（最大でも 255 タイル分）
+	/// </summary>
+	void Update(uint32_t xIndex, uint32_t yIndex, MapChipType type);
+
+	/// <summary>
+	/// 指定タイルがマスク内のいずれかのビットプレーンに含まれるか（範囲チェックなし）
+	/// </summary>
+	bool TestMask(uint32_t planeMask, uint32_t xIndex, uint32_t yIndex) const {
+		for (uint32_t plane = 0; plane < kMapChipPlaneCount; ++plane) {
+			if ((planeMask >> plane) & 1) {
+				const uint64_t* row = GetRow(static_cast<MapChipPlane>(plane), yIndex);
+				if ((row[xIndex >> 6] >> (xIndex & 63)) & 1) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// 行 y のタイル範囲 [first, last] にビットプレーンのタイルが 1 つでもあるか（範囲はマップ内であること）。64 タイル単位のワード演算で判定する
+	/// </summary>
+	bool AnyInRowSpan(MapChipPlane plane, uint32_t first, uint32_t last, uint32_t yIndex) const {
+		const uint64_t* row = GetRow(plane, yIndex);
+		uint32_t firstWord = first >> 6;
+		uint32_t lastWord = last >> 6;
+		uint64_t firstMask = ~0ull << (first & 63);
+		uint64_t lastMask = ~0ull >> (63 - (last & 63));
+		if (firstWord == lastWord) {
+			return (row[firstWord] & firstMask & lastMask) != 0;
+		}
+		if (row[firstWord] & firstMask) {
+			return true;
+		}
+		for (uint32_t w = firstWord + 1; w < lastWord; ++w) {
+			if (row[w]) {
+				return true;
+			}
+		}
+		return (row[lastWord] & lastMask) != 0;
+	}
+
+	/// <summary>
+	/// 行 y のビット列（タイル x は [x / 64] の bit (x % 64)、幅より右のビットは 0）
+	/// </summary>
+	std::span<const uint64_t> GetRowWords(MapChipPlane plane, uint32_t yIndex) const { return {GetRow(plane, yIndex), wordsPerRow_}; }
+
+	/// <summary>
+	/// 真下の ground・真上の solid までのタイル数（範囲チェックなし。値の意味は MapChipSnapshot::GetGroundDistance を参照）
+	/// </summary>
+	uint8_t GetGroundDistance(uint32_t xIndex, uint32_t yIndex) const { return groundDistance_[static_cast<size_t>(yIndex) * width_ + xIndex]; }
+	uint8_t GetCeilingDistance(uint32_t xIndex, uint32_t yIndex) const { return ceilingDistance_[static_cast<size_t>(yIndex) * width_ + xIndex]; }
+
+	/// <summary>
+	/// 確保しているバイト数（ビットプレーン・距離場それぞれ）
+	/// </summary>
+	size_t GetPlaneBytes() const;
+	size_t GetDistanceFieldBytes() const { return (groundDistance_.capacity() + ceilingDistance_.capacity()) * sizeof(uint8_t); }
+
+private:
+	// 行ごとのビットプレーン。タイル (x, y) は planes_[plane][y * wordsPerRow_ + x / 64] の bit (x % 64)
+	std::array<std::vector<uint64_t>, kMapChipPlaneCount> planes_;
+	uint32_t wordsPerRow_ = 0;
+	uint32_t width_ = 0;
+	uint32_t height_ = 0;
+
+	// タイルごとの真下の ground・真上の solid までの距離（行優先、kMapChipDistanceNone で飽和）
+	std::vector<uint8_t> groundDistance_;
+	std::vector<uint8_t> ceilingDistance_;
+
+	const uint64_t* GetRow(MapChipPlane plane, uint32_t yIndex) const {
+		assert(yIndex < height_);
+		return planes_[static_cast<uint32_t>(plane)].data() + static_cast<size_t>(yIndex) * wordsPerRow_;
+	}
+
+	/// <summary>
+	/// 大きさを合わせて全ビットを 0 にする
+	/// </summary>
+	void Reset(uint32_t width, uint32_t height);
+
+	/// <summary>
+	/// 行 y の [first, first + count) に、マスク内のビットプレーンのビットを立てる
+	/// </summary>
+	void SetRun(uint32_t first, uint32_t count, uint32_t yIndex, uint32_t planeMask);
+
+	void RebuildDistanceField();
+	void UpdateDistanceFieldAt(uint32_t xIndex, uint32_t yIndex);
+};
@@ -0,0 +1,210 @@
+#include "MapChipColliders.h"
+
+namespace {
+
+// 矩形にまとめられない（solid でない）タイルの印
+constexpr float kNotSolid = -1.0f;
+
+} // namespace
+
+void MapChipColliderSet::Clear() {
+	colliders_.clear();
+	freeSlots_.clear();
+	width_ = 0;
+	height_ = 0;
+	cellsX_ = 0;
+	cellsY_ = 0;
+	cells_.clear();
+}
+
+size_t MapChipColliderSet::GetMemoryBytes() const {
+	size_t bytes = colliders_.capacity() * sizeof(MapChipCollider) + freeSlots_.capacity() * sizeof(uint32_t);
+	bytes += cells_.capacity() * sizeof(std::vector<uint32_t>);
+	for (const std::vector<uint32_t>& cell : cells_) {
+		bytes += cell.capacity() * sizeof(uint32_t);
+	}
+	return bytes;
+}
+
+void MapChipColliderSet::Build(const MapChipType* tiles, uint32_t width, uint32_t height) {
+	Clear();
+	width_ = width;
+	height_ = height;
+	if (width == 0 || height == 0) {
+		return;
+	}
+	cellsX_ = (width + kCellSize - 1) / kCellSize;
+	cellsY_ = (height + kCellSize - 1) / kCellSize;
+	cells_.resize(static_cast<size_t>(cellsX_) * cellsY_);
+
+	// 各タイルの摩擦係数（solid でなければ kNotSolid）。同じ値同士だけをまとめる
+	size_t tileCount = static_cast<size_t>(width) * height;
+	std::vector<float> classes(tileCount);
+	for (size_t i = 0; i < tileCount; ++i) {
+		const MapChipProperty& property = GetMapChipProperty(tiles[i]);
+		classes[i] = property.solid ? property.friction : kNotSolid;
+	}
+
+	std::vector<uint8_t> used(tileCount, 0);
+	auto isFree = [&](uint32_t x, uint32_t y, float c) {
+		size_t i = static_cast<size_t>(y) * width + x;
+		return !used[i] && classes[i] == c;
+	};
+
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			size_t start = static_cast<size_t>(y) * width + x;
+			float c = classes[start];
+			if (c == kNotSolid || used[start]) {
+				continue;
+			}
+
+			// 横に伸ばす
+			uint32_t w = 1;
+			while (x + w < width && w < kMaxColliderTiles && isFree(x + w, y, c)) {
+				++w;
+			}
+
+			// 同じ幅のまま下の行へ伸ばす
+			uint32_t h = 1;
+			while (y + h < height && h < kMaxColliderTiles) {
+				bool rowOk = true;
+				for (uint32_t i = 0; i < w; ++i) {
+					if (!isFree(x + i, y + h, c)) {
+						rowOk = false;
+						break;
+					}
+				}
+				if (!rowOk) {
+					break;
+				}
+				++h;
+			}
+
+			for (uint32_t dy = 0; dy < h; ++dy) {
+				std::fill_n(used.begin() + static_cast<size_t>(y + dy) * width + x, w, uint8_t{1});
+			}
+			Insert({x, y, w, h, c});
+		}
+	}
+}
+
+uint32_t MapChipColliderSet::FindCollider(uint32_t x, uint32_t y) const {
+	if (x >= width_ || y >= height_) {
+		return kNoCollider;
+	}
+	for (uint32_t item : cells_[(y / kCellSize) * cellsX_ + x / kCellSize]) {
+		const MapChipCollider& c = colliders_[item];
+		if (x >= c.x && x < c.x + c.width && y >= c.y && y < c.y + c.height) {
+			return item;
+		}
+	}
+	return kNoCollider;
+}
+
+uint32_t MapChipColliderSet::Insert(const MapChipCollider& collider) {
+	uint32_t index;
+	if (!freeSlots_.empty()) {
+		index = freeSlots_.back();
+		freeSlots_.pop_back();
+		colliders_[index] = collider;
+	} else {
+		index = static_cast<uint32_t>(colliders_.size());
+		colliders_.push_back(collider);
+	}
+	ForEachCell(collider, [&](std::vector<uint32_t>& cell) { cell.push_back(index); });
+	return index;
+}
+
+void MapChipColliderSet::Erase(uint32_t index) {
+	ForEachCell(colliders_[index], [&](std::vector<uint32_t>& cell) { cell.erase(std::find(cell.begin(), cell.end(), index)); });
+	colliders_[index].width = 0;
+	colliders_[index].height = 0;
+	freeSlots_.push_back(index);
+}
+
+bool MapChipColliderSet::RemoveTile(uint32_t x, uint32_t y) {
+	uint32_t index = FindCollider(x, y);
+	if (index == kNoCollider) {
+		return false;
+	}
+
+	MapChipCollider c = colliders_[index];
+	Erase(index);
+
+	// 上の行・下の行は元の幅のまま、同じ行は左右に分ける
+	if (y > c.y) {
+		Insert({c.x, c.y, c.width, y - c.y, c.friction});
+	}
+	if (y + 1 < c.y + c.height) {
+		Insert({c.x, y + 1, c.width, c.y + c.height - (y + 1), c.friction});
+	}
+	if (x > c.x) {
+		Insert({c.x, y, x - c.x, 1, c.friction});
+	}
+	if (x + 1 < c.x + c.width) {
+		Insert({x + 1, y, c.x + c.width - (x + 1), 1, c.friction});
+	}
+	return true;
+}
+
+void MapChipColliderSet::AddTile(uint32_t x, uint32_t y, float friction) {
+	if (x >= width_ || y >= height_ || FindCollider(x, y) != kNoCollider) {
+		return;
+	}
+
+	MapChipCollider merged = {x, y, 1, 1, friction};
+	auto canJoin = [&](uint32_t index) {
+		if (index == kNoCollider) {
+			return false;
+		}
+		const MapChipCollider& n = colliders_[index];
+		return n.y == y && n.height == 1 && n.friction == friction && merged.width + n.width <= kMaxColliderTiles;
+	};
+
+	uint32_t left = x > 0 ? FindCollider(x - 1, y) : kNoCollider;
+	if (canJoin(left)) {
+		merged.x = colliders_[left].x;
+		merged.width += colliders_[left].width;
+		Erase(left);
+	}
+	uint32_t right = FindCollider(x + 1, y);
+	if (canJoin(right)) {
+		merged.width += colliders_[right].width;
+		Erase(right);
+	}
+	Insert(merged);
+}
+
+bool MapChipColliderSet::CoversExactly(const MapChipType* tiles, uint32_t width, uint32_t height) const {
+	if (width != width_ || height != height_) {
+		return false;
+	}
+
+	std::vector<uint8_t> coverCount(static_cast<size_t>(width) * height, 0);
+	for (const MapChipCollider& col : colliders_) {
+		if (col.width == 0) {
+			continue; // 空いている場所
+		}
+		if (col.height == 0 || col.x + col.width > width || col.y + col.height > height) {
+			return false;
+		}
+		for (uint32_t y = col.y; y < col.y + col.height; ++y) {
+			for (uint32_t x = col.x; x < col.x + col.width; ++x) {
+				size_t i = static_cast<size_t>(y) * width + x;
+				const MapChipProperty& property = GetMapChipProperty(tiles[i]);
+				// solid でない・摩擦が違う・重複しているタイルがあれば不正
+				if (!property.solid || property.friction != col.friction || coverCount[i]++ != 0) {
+					return false;
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < coverCount.size(); ++i) {
+		if (GetMapChipProperty(tiles[i]).solid && coverCount[i] == 0) {
+			return false;
+		}
+	}
+	return true;
+}
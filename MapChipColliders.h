@@ -0,0 +1,135 @@
+#pragma once
+
+#include "MapChipType.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// 静的な当たり判定用の矩形集合（エンジン非依存）
+// 隣接する solid タイルを摩擦係数ごとに最大の矩形へまとめ、一様グリッドで検索できるようにする
+// 矩形の大きさを kMaxColliderTiles までに抑えているので、タイル 1 つの追加・削除はマップの大きさに依らない手間で済む
+// ゲームの当たり判定はビットプレーン (MapChipSnapshot) で行うので、MapChipSnapshot はこれを作らない
+// 今は Tools/StageProfiler の集計と Tools/MapChipColliderCheck だけが使う
+
+/// <summary>
+/// タイル単位の矩形（x, y は左上のタイル。y は上の行が 0）
+/// </summary>
+struct MapChipCollider {
+	uint32_t x;
+	uint32_t y;
+	uint32_t width;
+	uint32_t height;
+	float friction;
+};
+
+class MapChipColliderSet {
+public:
+	// 検索用グリッドの 1 セルのタイル数（縦横）
+	static inline const uint32_t kCellSize = 16;
+	// 矩形 1 つの最大の縦横タイル数（1 つの矩形が登録されるセルは縦横 3 つまで）
+	static inline const uint32_t kMaxColliderTiles = 32;
+
+	/// <summary>
+	/// 行優先のタイル配列から矩形をまとめ直す
+	/// 各行で横に最大まで伸ばし、同じ幅で下の行へ伸ばす貪欲法
+	/// </summary>
+	void Build(const MapChipType* tiles, uint32_t width, uint32_t height);
+
+	void Clear();
+
+	/// <summary>
+	/// 矩形の配列。RemoveTile で消えた矩形の場所は width == 0 のまま残り、次の追加で再利用される
+	/// </summary>
+	const std::vector<MapChipCollider>& GetColliders() const { return colliders_; }
+
+	/// <summary>
+	/// solid でなくなったタイルを取り除く。そのタイルを含む矩形を最大 4 つ（上・下・左・右）に分割する
+	/// </summary>
+	/// <returns>タイルを含む矩形がなければ false</returns>
+	bool RemoveTile(uint32_t x, uint32_t y);
+
+	/// <summary>
+	/// solid になったタイルを追加する
+	/// 同じ行・同じ摩擦係数の高さ 1 の矩形が左右に接していれば、kMaxColliderTiles まで横につなげる
+	/// </summary>
+	void AddTile(uint32_t x, uint32_t y, float friction);
+
+	/// <summary>
+	/// タイル矩形 [x0, x1] x [y0, y1] と重なる矩形を列挙する（各矩形は 1 回だけ呼ばれる）
+	/// 範囲はマップ内にクリップする（負の値も可）
+	/// </summary>
+	/// <param name="fn">void(const MapChipCollider&)</param>
+	template <typename Fn> void ForEachInTileRect(int32_t x0, int32_t y0, int32_t x1, int32_t y1, Fn&& fn) const {
+		x0 = std::max(x0, 0);
+		y0 = std::max(y0, 0);
+		x1 = std::min(x1, static_cast<int32_t>(width_) - 1);
+		y1 = std::min(y1, static_cast<int32_t>(height_) - 1);
+		if (x0 > x1 || y0 > y1) {
+			return;
+		}
+
+		uint32_t cellX0 = static_cast<uint32_t>(x0) / kCellSize;
+		uint32_t cellY0 = static_cast<uint32_t>(y0) / kCellSize;
+		uint32_t cellX1 = static_cast<uint32_t>(x1) / kCellSize;
+		uint32_t cellY1 = static_cast<uint32_t>(y1) / kCellSize;
+
+		for (uint32_t cy = cellY0; cy <= cellY1; ++cy) {
+			for (uint32_t cx = cellX0; cx <= cellX1; ++cx) {
+				for (uint32_t item : cells_[cy * cellsX_ + cx]) {
+					const MapChipCollider& c = colliders_[item];
+					// 重なり領域の左上
+					int32_t ox = std::max(x0, static_cast<int32_t>(c.x));
+					int32_t oy = std::max(y0, static_cast<int32_t>(c.y));
+					if (ox > std::min(x1, static_cast<int32_t>(c.x + c.width) - 1) || oy > std::min(y1, static_cast<int32_t>(c.y + c.height) - 1)) {
+						continue;
+					}
+					// 複数セルに登録された矩形は、重なり領域の左上を含むセルでだけ報告する
+					if (static_cast<uint32_t>(ox) / kCellSize == cx && static_cast<uint32_t>(oy) / kCellSize == cy) {
+						fn(c);
+					}
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// 矩形集合が元のタイルの solid 部分を過不足なく（重複なく）覆っているか確認する
+	/// </summary>
+	bool CoversExactly(const MapChipType* tiles, uint32_t width, uint32_t height) const;
+
+	/// <summary>
+	/// 矩形と検索用グリッドに使っているメモリ（確保済みの容量で数える）
+	/// </summary>
+	size_t GetMemoryBytes() const;
+
+private:
+	static inline const uint32_t kNoCollider = UINT32_MAX;
+
+	// タイル (x, y) を含む矩形の番号（なければ kNoCollider）
+	uint32_t FindCollider(uint32_t x, uint32_t y) const;
+
+	// 空いている場所に矩形を置き、セルへ登録する
+	uint32_t Insert(const MapChipCollider& collider);
+	// 矩形をセルから外し、場所を空ける
+	void Erase(uint32_t index);
+
+	template <typename Fn> void ForEachCell(const MapChipCollider& collider, Fn&& fn) {
+		for (uint32_t cy = collider.y / kCellSize; cy <= (collider.y + collider.height - 1) / kCellSize; ++cy) {
+			for (uint32_t cx = collider.x / kCellSize; cx <= (collider.x + collider.width - 1) / kCellSize; ++cx) {
+				fn(cells_[cy * cellsX_ + cx]);
+			}
+		}
+	}
+
+	std::vector<MapChipCollider> colliders_;
+	std::vector<uint32_t> freeSlots_;
+
+	uint32_t width_ = 0;
+	uint32_t height_ = 0;
+
+	// セル (cx, cy) に重なる矩形の番号は cells_[cy * cellsX_ + cx]
+	uint32_t cellsX_ = 0;
+	uint32_t cellsY_ = 0;
+	std::vector<std::vector<uint32_t>> cells_;
+};
@@ -1,174 +1,147 @@
 #include "MapChipField.h"
 
-#include <fstream>
-#include <map>
-#include <sstream>
-#include <cmath>
+#include "CameraController.h"
+#include "KamataEngine.h"
+#include "MapChipFormat.h"
+#include "MappedFile.h"
+
+#include <filesystem>
 
 using namespace KamataEngine;
 
 namespace {
-std::map<std::string, MapChipType> mapChipTable = {
-    {"0", MapChipType::kBlank},
-    {"1", MapChipType::kBlock},
-    {"2", MapChipType::kReserved2},
-    {"3", MapChipType::kEnemySpawn},
-    {"4", MapChipType::kEnemySpawnShield},
-    {"5", MapChipType::kSpike},
-    {"6", MapChipType::kGoal}, 
-    {"7", MapChipType::kKey},
-    {"8", MapChipType::kIce},
-    {"9", MapChipType::kLadder},
-    {"10", MapChipType::kStage},
-    {"11", MapChipType::kShooter},
-    {"12", MapChipType::kEnemySpawnLeft},
-    {"13", MapChipType::kEnemySpawnShieldRight},
-    {"14", MapChipType::kShooterRight},
-};
-}
+
+// エラー表示の上限（大量の不正セルでログが埋まらないようにする）
+constexpr uint32_t kMaxReportedCsvErrors = 16;
+
+} // namespace
 
 void MapChipField::Initialize() {}
 void MapChipField::Update() {}
 void MapChipField::Draw() {}
 
-void MapChipField::ResetMapChipData() {
-	mapChipData_.data.clear();
-	mapChipData_.data.resize(numBlockVertical_);
-	for (std::vector<MapChipType>& mapChipDataRow : mapChipData_.data) {
-		mapChipDataRow.resize(numBlockHorizontal_);
+bool MapChipField::LoadMapChip(const std::string& filename) {
+	// コンパイル済みバイナリがあり、CSV より新しければそちらを使う
+	std::string binaryPath = GetMapChipBinaryPath(filename);
+
+	std::error_code ec;
+	auto binaryTime = std::filesystem::last_write_time(binaryPath, ec);
+	if (!ec) {
+		std::error_code csvEc;
+		auto csvTime = std::filesystem::last_write_time(filename, csvEc);
+		if (csvEc || binaryTime >= csvTime) {
+			if (LoadMapChipBinary(binaryPath)) {
+				return true;
+			}
+		} else {
+			DebugText::GetInstance()->ConsolePrintf("MapChipField: %s is older than %s, loading CSV\n", binaryPath.c_str(), filename.c_str());
+		}
 	}
+
+	return LoadMapChipCsv(filename);
 }
 
-void MapChipField::LoadMapChipCsv(const std::string& filename) {
-	// CSVファイルを開く
-	std::ifstream file(filename);
-
-	#ifdef _DEBUG
-	assert(file.is_open());
-	#endif // _DEBUG
-
-	// ファイル内容を文字列に読み込む
-	std::stringstream mapChipCsv;
-	mapChipCsv << file.rdbuf();
-	file.close();
-
-	// 行ごとに分割してサイズを決定
-	std::vector<std::string> lines;
-	std::string line;
-	while (std::getline(mapChipCsv, line)) {
-		// 空行は無視
-		if (line.empty()) continue;
-		lines.push_back(line);
+bool MapChipField::LoadMapChipBinary(const std::string& filename) {
+	MappedFile file;
+	if (!file.Open(filename)) {
+		DebugText::GetInstance()->ConsolePrintf("MapChipField: failed to open %s\n", filename.c_str());
+		return false;
 	}
 
-	if (lines.empty()) {
-		// CSV にデータがなければ初期化のみ
-		numBlockHorizontal_ = 1;
-		numBlockVertical_ = 1;
-		ResetMapChipData();
-		return;
+	MapChipBinaryView view;
+	const char* error = nullptr;
+	if (!ReadMapChipBinary(file.GetData(), file.GetSize(), view, error)) {
+		DebugText::GetInstance()->ConsolePrintf("MapChipField: invalid map binary %s (%s)\n", filename.c_str(), error);
+		return false;
 	}
 
-	// 列数は最大のカンマ区切りトークン数に合わせる
-	uint32_t maxCols = 0;
-	for (const auto& ln : lines) {
-		uint32_t cols = 0;
-		std::stringstream ls(ln);
-		std::string word;
-		while (std::getline(ls, word, ',')) {
-			++cols;
-		}
-		if (cols > maxCols) maxCols = cols;
+	// 検証済みのタイル配列をバッファへ取り込む（解析は不要）
+	auto snapshot = std::make_shared<MapChipSnapshot>();
+	snapshot->SetNumBlockHorizontal(view.width);
+	snapshot->SetNumBlockVertical(view.height);
+	snapshot->AssignTiles(view.tiles);
+	for (const MapChipBinaryLayerView& layer : view.layers) {
+		snapshot->AddLayer(layer.name, layer.tiles);
 	}
+	snapshot->RebuildDerivedData();
+	ReplaceSnapshot(std::move(snapshot));
+	return true;
+}
 
-	// インスタンスのブロック数を CSV に合わせて設定
-	SetNumBlockVertical(static_cast<uint32_t>(lines.size()));
-	SetNumBlockHorizontal(maxCols);
-
-	// データ領域をリサイズ
-	ResetMapChipData();
-
-	// helper to trim whitespace
-	auto trim = [](std::string& s) {
-		// remove leading
-		while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.erase(s.begin());
-		// remove trailing
-		while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.pop_back();
-	};
-
-	// データを埋める（CSV は上から下へ）
-	for (uint32_t i = 0; i < numBlockVertical_; ++i) {
-		std::stringstream line_stream(lines[i]);
-		for (uint32_t j = 0; j < numBlockHorizontal_; ++j) {
-			std::string word;
-			if (!std::getline(line_stream, word, ',')) {
-				// 足りない要素はデフォルトのまま
-				break;
-			}
+bool MapChipField::LoadMapChipCsv(const std::string& filename) {
+	// CSVファイルをメモリマップで開く（内容はコピーしない）
+	MappedFile file;
+	bool isOpen = file.Open(filename);
 
-			trim(word);
+#ifdef _DEBUG
+	assert(isOpen);
+#endif // _DEBUG
 
-			if (mapChipTable.contains(word)) {
-				mapChipData_.data[i][j] = mapChipTable[word];
-			} else {
-				// Unknown value: leave as blank
-			}
-		}
+	if (!isOpen) {
+		DebugText::GetInstance()->ConsolePrintf("MapChipField: failed to open %s\n", filename.c_str());
+		ResetToEmptyMap();
+		return false;
 	}
-}
 
-MapChipType MapChipField::GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) {
+	MapChipStage stage;
+	std::vector<MapChipCsvError> errors;
+	uint32_t errorCount = ParseMapChipStageCsv(file.GetData(), file.GetSize(), stage, errors, kMaxReportedCsvErrors);
 
-	if (xIndex >= numBlockHorizontal_) {
-		return MapChipType::kBlank;
+	for (const MapChipCsvError& e : errors) {
+		DebugText::GetInstance()->ConsolePrintf("MapChipField: invalid cell '%s' at row %u, column %u in %s\n", e.text.c_str(), e.row, e.column, filename.c_str());
 	}
-	if (yIndex >= numBlockVertical_) {
-		return MapChipType::kBlank;
+	if (errorCount > kMaxReportedCsvErrors) {
+		DebugText::GetInstance()->ConsolePrintf("MapChipField: %u invalid cells in %s (first %u shown)\n", errorCount, filename.c_str(), kMaxReportedCsvErrors);
 	}
 
-	return mapChipData_.data[yIndex][xIndex];
-}
-
-Vector3 MapChipField::GetMapChipPositionByIndex(uint32_t xIndex, uint32_t yIndex) { return Vector3(kBlockWidth * xIndex, kBlockHeight * (numBlockVertical_ - 1 - yIndex), 0); }
-
-IndexSet MapChipField::GetMapChipIndexSetByPosition(const KamataEngine::Vector3& position) {
-	IndexSet indexSet = {};
-
-	indexSet.xIndex = static_cast<uint32_t>(std::floor((position.x + kBlockWidth * 0.5f) / kBlockWidth));
-
-	// 画像のロジックに従って Y インデックスを計算
-	float preFlipYIndexFloat = (position.y + kBlockHeight * 0.5f) / kBlockHeight;
-	uint32_t preFlipYIndex = static_cast<uint32_t>(std::floor(preFlipYIndexFloat));
-	indexSet.yIndex = numBlockVertical_ - 1 - preFlipYIndex;
+	if (stage.collision.height == 0) {
+		// CSV にデータがなければ初期化のみ
+		ResetToEmptyMap();
+		return errorCount == 0;
+	}
 
-	return indexSet;
+	LoadMapChipStage(stage);
+	return errorCount == 0;
 }
 
-Rects MapChipField::GetRectByIndex(uint32_t xIndex, uint32_t yIndex) {
-
-	Vector3 center = GetMapChipPositionByIndex(xIndex, yIndex);
+MapChipReloadResult MapChipField::ReloadMapChipCsv(const std::string& filename, std::vector<MapChipTileChange>& changes) {
+	changes.clear();
 
-	Rects rect = {};
+	MappedFile file;
+	if (!file.Open(filename)) {
+		DebugText::GetInstance()->ConsolePrintf("MapChipField: reload failed to open %s\n", filename.c_str());
+		return MapChipReloadResult::kFailed;
+	}
 
-	rect.left = center.x - kBlockWidth * 0.5f;
-	rect.right = center.x + kBlockWidth * 0.5f;
-	// top は -
-	rect.top = center.y + kBlockHeight * 0.5f;
-	rect.bottom = center.y - kBlockHeight * 0.5f;
+	MapChipStage stage;
+	std::vector<MapChipCsvError> errors;
+	uint32_t errorCount = ParseMapChipStageCsv(file.GetData(), file.GetSize(), stage, errors, 1);
+	if (errorCount > 0 || stage.collision.height == 0) {
+		// 編集途中のファイルかもしれないので、壊れていれば反映しない
+		if (!errors.empty()) {
+			DebugText::GetInstance()->ConsolePrintf(
+			    "MapChipField: reload skipped, invalid cell '%s' at row %u, column %u in %s\n", errors[0].text.c_str(), errors[0].row, errors[0].column, filename.c_str());
+		}
+		return MapChipReloadResult::kFailed;
+	}
 
-	return rect;
-};
+	return ReloadMapChipStage(stage, changes);
+}
 
 Rect MapChipField::GetMovableArea() const {
+	// カメラの型 (Rect) を使うので MapChipSnapshot ではなくここで計算する
+	const float blockWidth = GetBlockWidth();
+	const float blockHeight = GetBlockHeight();
+
 	// ワールド座標での左端、右端、上端、下端を計算する
 	// マップ左下のタイル中心は (0,0) としているため、左端は -0.5 * width
-	float left = -kBlockWidth * 0.5f; // 左端の中心座標
-	float right = left + static_cast<float>(numBlockHorizontal_) * kBlockWidth - kBlockWidth; // 右端の中心座標
+	float left = -blockWidth * 0.5f; // 左端の中心座標
+	float right = left + static_cast<float>(GetNumBlockHorizontal()) * blockWidth - blockWidth; // 右端の中心座標
 
 	// Y は上が正で、MapChip の実装では上の行(yIndex==0)が一番上になるように反転している
 	// GetMapChipPositionByIndex の計算に合わせる
-	float top = (numBlockVertical_ - 1) * kBlockHeight + kBlockHeight * 0.5f;
-	float bottom = -kBlockHeight * 0.5f;
+	float top = (GetNumBlockVertical() - 1) * blockHeight + blockHeight * 0.5f;
+	float bottom = -blockHeight * 0.5f;
 
 	Rect r;
 	r.left = left;
@@ -177,23 +150,3 @@ Rect MapChipField::GetMovableArea() const {
 	r.bottom = bottom;
 	return r;
 }
-
-float MapChipField::GetFrictionCoefficientByIndex(uint32_t xIndex, uint32_t yIndex) {
-	MapChipType type = GetMapChipTypeByIndex(xIndex, yIndex);
-	switch (type) {
-	case MapChipType::kIce:
-		// Ice: very low friction
-		return 0.05f;
-	case MapChipType::kBlock:
-		// Block: high friction
-		return 0.9f;
-	default:
-		// Default: treat as high friction
-		return 0.9f;
-	}
-}
-
-float MapChipField::GetFrictionCoefficientByPosition(const KamataEngine::Vector3& position) {
-	IndexSet idx = GetMapChipIndexSetByPosition(position);
-	return GetFrictionCoefficientByIndex(idx.xIndex, idx.yIndex);
-}
@@ -1,132 +1,176 @@
 #pragma once
 
-#include"CameraController.h"
-#include "KamataEngine.h"
-
-enum class MapChipType {
-	kBlank = 0, // 0
-	kBlock = 1, // 1
-	kReserved2 = 2, // 2: reserved / kept open
-	kEnemySpawn = 3,       // 3: 敵 スポーン場所 (右向き)
-	kEnemySpawnShield = 4, // 4: シールド持ち敵 スポーン場所
-	kSpike = 5, //5: 棘
-	kGoal = 6,  //6: ゴール
-	kKey = 7,   //7: 鍵
-	kIce = 8,   //8: 氷ブロック（Blockと同じ挙動、モデルのみIce）
-	kLadder = 9, //9: はしご（追加）
-	kStage = 10, //10: ステージノード（SelectScene でステージ選択用）
-	kShooter = 11, //11: 弾を発射する敵（Spikeのようにマップに置く）
-	kEnemySpawnLeft = 12, //12: 敵 スポーン場所 (左向き)
-	kEnemySpawnShieldRight = 13, //13: シールド持ち敵 スポーン場所 (右向き)
-	kShooterRight = 14, //14: 右向きの Shooter 敵 スポーン場所
-};
-
-struct MapChipData {
-	std::vector<std::vector<MapChipType>> data;
-};
-
-struct IndexSet {
-	uint32_t xIndex;
-	uint32_t yIndex;
-};
-
-struct Rects {
-	float left;   // 左端
-	float right;  // 右端
-	float top;    // 下端
-	float bottom; // 上端
+#include "MapChipSnapshot.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+struct MapChipStage;
+struct Rect;
+
+// ReloadMapChipCsv の結果
+enum class MapChipReloadResult {
+	kFailed,       // 読めない、または不正なセルがある（データは変更しない）
+	kUnchanged,    // 内容に変化なし
+	kTilesChanged, // 同じサイズで一部のタイルが変わった
+	kResized,      // サイズが変わったので全体を差し替えた
+	kReplaced,     // 当たり判定以外のレイヤーが変わったので全体を差し替えた（サイズは同じ）
 };
 
+/// <summary>
+/// マップの読み込み・書き換えを行い、結果を MapChipSnapshot として公開する
+/// 読み込みは新しいスナップショットを作って差し替え、SetTile・差分リロードは GetSnapshot で渡したスナップショットが
+/// 残っていれば複製してから書き換える（渡したものは変わらない）。MapChipField 自体は 1 スレッドから使う
+/// 問い合わせは現在のスナップショットへそのまま委譲する（説明は MapChipSnapshot を参照）
+/// </summary>
 class MapChipField {
 
 public:
-	
-
-public:
+	MapChipField() : snapshot_(std::make_shared<MapChipSnapshot>()) {}
 
 	void Initialize();
 	void Update();
 	void Draw();
 
+	/// <summary>
+	/// 現在のマップの読み取り専用スナップショット
+	/// 受け取った側は、以降の読み込みや SetTile に影響されずにロックなしで複数スレッドから参照できる
+	/// </summary>
+	std::shared_ptr<const MapChipSnapshot> GetSnapshot() const { return snapshot_; }
+
 	/// <summary>
 	/// マップチップのデータをリセットする
 	/// </summary>
 	void ResetMapChipData();
 
 	/// <summary>
-	/// CSVファイルからマップチップデータを読み込む
+	/// マップを読み込む
+	/// 同じ場所に CSV より新しいコンパイル済みバイナリ (.mcb) があればそれを、なければ CSV を読む
 	/// </summary>
 	/// <param name="filename">CSVの名前</param>
-	void LoadMapChipCsv(const std::string& filename);
+	/// <returns>読み込みに失敗した、または CSV に不正なセルがあれば false</returns>
+	bool LoadMapChip(const std::string& filename);
 
 	/// <summary>
-	/// マップチップ種別の取得
+	/// 解析済みのステージを読み込む（stage のタイルは移動する）。ファイルを介さないので、エンジンなしのツールからも使える
 	/// </summary>
-	/// <param name="xIndex">横</param>
-	/// <param name="yIndex">縦</param>
-	/// <returns>マップチップに対応したモデルの描画が可能になる</returns>
-	MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex);
+	void LoadMapChipStage(MapChipStage& stage);
 
 	/// <summary>
-	/// マップチップ座標の取得
+	/// コンパイル済みバイナリ (.mcb) からマップチップデータを読み込む
+	/// 変換は Tools/MapChipConverter で行う
 	/// </summary>
-	/// <param name="Index">横</param>
-	/// <param name="yIndex">縦</param>
-	/// <returns>マップチップのワールド座標を取得する関数</returns>
-	KamataEngine::Vector3 GetMapChipPositionByIndex(uint32_t Index, uint32_t yIndex);
+	/// <param name="filename">バイナリの名前</param>
+	/// <returns>ファイルが開けない、または検証に失敗すれば false（その場合データは変更しない）</returns>
+	bool LoadMapChipBinary(const std::string& filename);
 
 	/// <summary>
-	/// 座標からマップチップ番号を計算
+	/// CSVファイルからマップチップデータを読み込む
+	/// ファイルはメモリマップし、1 パスでセルを数値として解釈する
 	/// </summary>
-	/// <param name="position">座標指定</param>
-	/// <returns></returns>
-	IndexSet GetMapChipIndexSetByPosition(const KamataEngine::Vector3& position);
+	/// <param name="filename">CSVの名前</param>
+	/// <returns>ファイルが開けない、または不正なセルがあれば false（不正なセルは blank として読み込む）</returns>
+	bool LoadMapChipCsv(const std::string& filename);
 
-	Rects GetRectByIndex(uint32_t xIndex, uint32_t yIndex);
+	/// <summary>
+	/// CSV を読み直し、現在のデータとの差分だけを反映する（ホットリロード用）
+	/// 変わったタイルを SetTile と同じく 1 タイルずつ書き換え、派生データは全体を作り直さない
+	/// 差分を取るのは当たり判定レイヤーだけで、他のレイヤーが変わっていれば全体を差し替える
+	/// </summary>
+	/// <param name="filename">CSVの名前</param>
+	/// <param name="changes">kTilesChanged のとき、変わったタイルと前後の種別</param>
+	MapChipReloadResult ReloadMapChipCsv(const std::string& filename, std::vector<MapChipTileChange>& changes);
 
 	/// <summary>
-	/// CSV のサイズに基づいてカメラの移動可能領域を返す
+	/// 解析済みのステージで読み込み直す（ReloadMapChipCsv の解析後の処理。サイズとレイヤーが同じなら差分だけを反映する）
+	/// stage のタイルは、全体を差し替えるときだけ移動する
 	/// </summary>
-	/// <returns>CameraController::Rect と同等の構造体 (left,right,top,bottom)</returns>
-	Rect GetMovableArea() const;
+	/// <param name="changes">kTilesChanged のとき、変わったタイルと前後の種別（行優先）</param>
+	MapChipReloadResult ReloadMapChipStage(MapChipStage& stage, std::vector<MapChipTileChange>& changes);
 
 	/// <summary>
-	/// 指定インデックスに対応する摩擦係数を取得する
-	/// 返り値は 0.0f (滑りやすい/氷) から 1.0f (摩擦が高い/普通のブロック) を想定
+	/// 実行中にタイルを書き換える（壊れるブロック・出現するブロックなど）
+	/// ビットプレーン・距離場・生成位置の索引は、そのタイルと周辺だけを更新する
+	/// 描画などマップの外の派生データへは GetPendingTileChanges で通知する
 	/// </summary>
-	float GetFrictionCoefficientByIndex(uint32_t xIndex, uint32_t yIndex);
+	/// <returns>範囲外、または同じ種別なら何もせず false</returns>
+	bool SetTile(uint32_t xIndex, uint32_t yIndex, MapChipType type);
 
 	/// <summary>
-	/// 指定ワールド座標の下にあるマップチップの摩擦係数を取得する
+	/// 前回 ClearPendingTileChanges を呼んでから SetTile で書き換わったタイル（書き換えた順）
+	/// 同じタイルを何度も書き換えた場合はその回数分並ぶ
 	/// </summary>
-	float GetFrictionCoefficientByPosition(const KamataEngine::Vector3& position);
+	std::span<const MapChipTileChange> GetPendingTileChanges() const { return pendingTileChanges_; }
 
-public:
-	uint32_t GetNumBlockHorizontal() const { return numBlockHorizontal_; }
-	uint32_t GetNumBlockVertical() const { return numBlockVertical_; }
-
-	void SetNumBlockHorizontal(uint32_t count) {
-		if (count == 0) {
-			count = 1;
-		}
-		numBlockHorizontal_ = count;
-	}
+	/// <summary>
+	/// 通知済みの変更を捨てる（容量は残すので、毎フレーム呼んでも確保し直さない）
+	/// </summary>
+	void ClearPendingTileChanges() { pendingTileChanges_.clear(); }
+
+	MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) const { return snapshot_->GetMapChipTypeByIndex(xIndex, yIndex); }
+	MapChipType GetMapChipTypeByIndexUnchecked(uint32_t xIndex, uint32_t yIndex) const { return snapshot_->GetMapChipTypeByIndexUnchecked(xIndex, yIndex); }
 
-	void SetNumBlockVertical(uint32_t count) {
-		if (count == 0) {
-			count = 1;
-		}
-		numBlockVertical_ = count;
+	bool TestPlane(MapChipPlane plane, uint32_t xIndex, uint32_t yIndex) const { return snapshot_->TestPlane(plane, xIndex, yIndex); }
+	bool AnyInRowSpan(MapChipPlane plane, int32_t x0, int32_t x1, int32_t y) const { return snapshot_->AnyInRowSpan(plane, x0, x1, y); }
+	bool AnyInRect(MapChipPlane plane, int32_t x0, int32_t y0, int32_t x1, int32_t y1) const { return snapshot_->AnyInRect(plane, x0, y0, x1, y1); }
+
+	bool Raycast(const KamataEngine::Vector3& origin, const KamataEngine::Vector3& direction, float maxDistance, uint32_t planeMask, MapChipRaycastHit& hit) const {
+		return snapshot_->Raycast(origin, direction, maxDistance, planeMask, hit);
 	}
+	uint32_t RaycastBatch(std::span<const MapChipRay> rays, uint32_t planeMask, std::span<MapChipRaycastHit> hits) const { return snapshot_->RaycastBatch(rays, planeMask, hits); }
+
+	uint8_t GetGroundDistance(uint32_t xIndex, uint32_t yIndex) const { return snapshot_->GetGroundDistance(xIndex, yIndex); }
+	uint8_t GetCeilingDistance(uint32_t xIndex, uint32_t yIndex) const { return snapshot_->GetCeilingDistance(xIndex, yIndex); }
+	bool FindGroundBelow(const KamataEngine::Vector3& position, float& groundY) const { return snapshot_->FindGroundBelow(position, groundY); }
+
+	MapChipTileRange GetTileRangeInAABB(const AABB& aabb) const { return snapshot_->GetTileRangeInAABB(aabb); }
+	template <typename Fn> bool ForEachTileInAABB(const AABB& aabb, uint32_t typeMask, Fn&& fn) const { return snapshot_->ForEachTileInAABB(aabb, typeMask, std::forward<Fn>(fn)); }
+
+	std::span<const MapChipLayer> GetLayers() const { return snapshot_->GetLayers(); }
+	const MapChipLayer* FindLayer(std::string_view name) const { return snapshot_->FindLayer(name); }
+
+	std::span<const IndexSet> GetSpawnTiles(MapChipType type) const { return snapshot_->GetSpawnTiles(type); }
+
+	KamataEngine::Vector3 GetMapChipPositionByIndex(uint32_t xIndex, uint32_t yIndex) const { return snapshot_->GetMapChipPositionByIndex(xIndex, yIndex); }
+	IndexSet GetMapChipIndexSetByPosition(const KamataEngine::Vector3& position) const { return snapshot_->GetMapChipIndexSetByPosition(position); }
+	Rects GetRectByIndex(uint32_t xIndex, uint32_t yIndex) const { return snapshot_->GetRectByIndex(xIndex, yIndex); }
+
+	/// <summary>
+	/// CSV のサイズに基づいてカメラの移動可能領域を返す
+	/// </summary>
+	/// <returns>CameraController.h の Rect (left,right,top,bottom)。使う側で CameraController.h を include する</returns>
+	Rect GetMovableArea() const;
+
+	float GetFrictionCoefficientByIndex(uint32_t xIndex, uint32_t yIndex) const { return snapshot_->GetFrictionCoefficientByIndex(xIndex, yIndex); }
+	float GetFrictionCoefficientByPosition(const KamataEngine::Vector3& position) const { return snapshot_->GetFrictionCoefficientByPosition(position); }
+
+public:
+	static float GetBlockWidth() { return MapChipSnapshot::GetBlockWidth(); }
+	static float GetBlockHeight() { return MapChipSnapshot::GetBlockHeight(); }
+
+	uint32_t GetNumBlockHorizontal() const { return snapshot_->GetNumBlockHorizontal(); }
+	uint32_t GetNumBlockVertical() const { return snapshot_->GetNumBlockVertical(); }
 
 private:
-	// ブロックのサイズ
-	static inline const float kBlockWidth = 2.0f;
-	static inline const float kBlockHeight = 2.0f;
+	// 現在のマップ。GetSnapshot で渡したものと共有されている間は書き換えない
+	std::shared_ptr<MapChipSnapshot> snapshot_;
+
+	// SetTile で書き換えたが、まだ通知していないタイル
+	std::vector<MapChipTileChange> pendingTileChanges_;
+
+	/// <summary>
+	/// 書き換え用のスナップショット。GetSnapshot で渡したものがまだ残っていれば複製して差し替える
+	/// </summary>
+	MapChipSnapshot& MutableSnapshot();
 
-	// ブロック数はインスタンスメンバにして CSV に合わせて変更可能にする
-	uint32_t numBlockHorizontal_ = 20;
-	uint32_t numBlockVertical_ = 10;
+	/// <summary>
+	/// 新しく作ったスナップショットに差し替える（データごと変わるので未通知の書き換えも捨てる）
+	/// </summary>
+	void ReplaceSnapshot(std::shared_ptr<MapChipSnapshot> snapshot);
 
-	MapChipData mapChipData_;
-};
\ No newline at end of file
+	/// <summary>
+	/// 読み込みに失敗したときの 1x1 の空のマップに差し替える
+	/// </summary>
+	void ResetToEmptyMap();
+};
@@ -0,0 +1,123 @@
+// MapChipField のうち、スナップショットの差し替えとタイルの書き換え（エンジンに依存しない部分）
+// ファイルの読み込みとログ出力は MapChipField.cpp。ツールからもリンクできるよう分けている
+
+#include "MapChipField.h"
+
+#include "MapChipFormat.h"
+
+#include <algorithm>
+
+namespace {
+
+/// <summary>
+/// 当たり判定以外のレイヤーが、名前・順番・タイルともに解析結果と同じか
+/// </summary>
+bool LayersMatch(std::span<const MapChipLayer> layers, const std::vector<MapChipLayerGrid>& loaded, uint32_t width, uint32_t height) {
+	if (layers.size() != loaded.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < layers.size(); ++i) {
+		if (layers[i].name != loaded[i].name) {
+			return false;
+		}
+		for (uint32_t y = 0; y < height; ++y) {
+			const MapChipType* row = loaded[i].tiles.data() + static_cast<size_t>(y) * width;
+			bool same = true;
+			layers[i].tiles.ForEachRun(y, [&](uint32_t x, uint32_t count, MapChipType type) {
+				same = same && std::all_of(row + x, row + x + count, [type](MapChipType t) { return t == type; });
+			});
+			if (!same) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+void MapChipField::ResetMapChipData() {
+	// 同じ大きさの空のマップを新しく作る（渡したスナップショットは変えない）
+	auto snapshot = std::make_shared<MapChipSnapshot>();
+	snapshot->SetNumBlockHorizontal(snapshot_->numBlockHorizontal_);
+	snapshot->SetNumBlockVertical(snapshot_->numBlockVertical_);
+	snapshot->ResetTiles();
+	ReplaceSnapshot(std::move(snapshot));
+}
+
+void MapChipField::LoadMapChipStage(MapChipStage& stage) {
+	ReplaceSnapshot(MapChipSnapshot::CreateFromStage(stage));
+}
+
+void MapChipField::ResetToEmptyMap() {
+	auto snapshot = std::make_shared<MapChipSnapshot>();
+	snapshot->SetNumBlockHorizontal(1);
+	snapshot->SetNumBlockVertical(1);
+	snapshot->ResetTiles();
+	ReplaceSnapshot(std::move(snapshot));
+}
+
+MapChipReloadResult MapChipField::ReloadMapChipStage(MapChipStage& stage, std::vector<MapChipTileChange>& changes) {
+	changes.clear();
+
+	const MapChipGrid& grid = stage.collision;
+	if (grid.width != snapshot_->numBlockHorizontal_ || grid.height != snapshot_->numBlockVertical_) {
+		LoadMapChipStage(stage);
+		return MapChipReloadResult::kResized;
+	}
+	if (!LayersMatch(snapshot_->GetLayers(), stage.layers, grid.width, grid.height)) {
+		// 装飾・生成対象のレイヤーは描画や生成の作り直しが必要なので、差分は取らずに差し替える
+		LoadMapChipStage(stage);
+		return MapChipReloadResult::kReplaced;
+	}
+
+	// 同じサイズなら差分だけを反映する。変化がなければスナップショットは複製しない
+	const uint32_t width = grid.width;
+	for (uint32_t y = 0; y < grid.height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			MapChipType current = snapshot_->GetMapChipTypeByIndexUnchecked(x, y);
+			MapChipType loaded = grid.tiles[static_cast<size_t>(y) * width + x];
+			if (current != loaded) {
+				changes.push_back({{x, y}, current, loaded});
+			}
+		}
+	}
+
+	if (changes.empty()) {
+		return MapChipReloadResult::kUnchanged;
+	}
+
+	// SetTile と同じく 1 タイルずつ書き換え、派生データはそのタイルと周辺だけを更新する
+	MapChipSnapshot& snapshot = MutableSnapshot();
+	for (const MapChipTileChange& change : changes) {
+		snapshot.ReplaceTile(change.index.xIndex, change.index.yIndex, change.after);
+	}
+	return MapChipReloadResult::kTilesChanged;
+}
+
+MapChipSnapshot& MapChipField::MutableSnapshot() {
+	// 新しい参照は GetSnapshot（このスレッド）からしか増えないので、1 なら他に持ち主はいない
+	if (snapshot_.use_count() > 1) {
+		snapshot_ = std::make_shared<MapChipSnapshot>(*snapshot_);
+	}
+	return *snapshot_;
+}
+
+void MapChipField::ReplaceSnapshot(std::shared_ptr<MapChipSnapshot> snapshot) {
+	snapshot_ = std::move(snapshot);
+	// データごと差し替えたので、未通知の書き換えは意味を失う
+	pendingTileChanges_.clear();
+}
+
+bool MapChipField::SetTile(uint32_t xIndex, uint32_t yIndex, MapChipType type) {
+	if (xIndex >= snapshot_->numBlockHorizontal_ || yIndex >= snapshot_->numBlockVertical_ || static_cast<uint32_t>(type) >= kMapChipTypeCount) {
+		return false;
+	}
+	if (snapshot_->GetMapChipTypeByIndexUnchecked(xIndex, yIndex) == type) {
+		return false;
+	}
+
+	MapChipType before = MutableSnapshot().ReplaceTile(xIndex, yIndex, type);
+	pendingTileChanges_.push_back({{xIndex, yIndex}, before, type});
+	return true;
+}
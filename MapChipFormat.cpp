@@ -0,0 +1,415 @@
+#include "MapChipFormat.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+// バイナリはメモリ上の表現をそのまま読み書きする
+static_assert(std::endian::native == std::endian::little, "MapChip binary format assumes a little-endian host");
+
+namespace {
+
+bool IsCsvSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+/// <summary>
+/// 1 セル分の文字列を MapChipType に変換する
+/// 空セルは kBlank、数字以外や範囲外の値は false を返す
+/// </summary>
+bool ParseMapChipCell(const char* begin, const char* end, MapChipType& out) {
+	while (begin < end && IsCsvSpace(*begin)) ++begin;
+	while (end > begin && IsCsvSpace(end[-1])) --end;
+
+	out = MapChipType::kBlank;
+	if (begin == end) {
+		return true;
+	}
+
+	uint32_t value = 0;
+	for (const char* c = begin; c < end; ++c) {
+		if (*c < '0' || *c > '9') {
+			return false;
+		}
+		value = value * 10 + static_cast<uint32_t>(*c - '0');
+		if (value >= kMapChipTypeCount) {
+			return false;
+		}
+	}
+	out = static_cast<MapChipType>(value);
+	return true;
+}
+
+bool IsLayerNameChar(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-'; }
+
+/// <summary>
+/// 行が "[名前]" の見出しかどうか。'[' で始まる行は見出しとみなし、名前が不正なら name を空にする
+/// </summary>
+bool ParseLayerHeader(const char* begin, const char* end, std::string& name) {
+	while (begin < end && IsCsvSpace(*begin)) ++begin;
+	while (end > begin && IsCsvSpace(end[-1])) --end;
+	if (begin == end || *begin != '[') {
+		return false;
+	}
+
+	name.clear();
+	if (end - begin < 3 || end[-1] != ']') {
+		return true;
+	}
+	for (const char* c = begin + 1; c < end - 1; ++c) {
+		if (!IsLayerNameChar(*c)) {
+			return true;
+		}
+	}
+	name.assign(begin + 1, end - 1);
+	return true;
+}
+
+/// <summary>
+/// 行優先のタイルを width x height に広げる（増えた分は blank）
+/// </summary>
+void ResizeTiles(std::vector<MapChipType>& tiles, uint32_t oldWidth, uint32_t oldHeight, uint32_t width, uint32_t height) {
+	if (oldWidth == width && oldHeight == height) {
+		return;
+	}
+	std::vector<MapChipType> resized(static_cast<size_t>(width) * height, MapChipType::kBlank);
+	for (uint32_t y = 0; y < oldHeight; ++y) {
+		std::memcpy(resized.data() + static_cast<size_t>(y) * width, tiles.data() + static_cast<size_t>(y) * oldWidth, oldWidth * sizeof(MapChipType));
+	}
+	tiles = std::move(resized);
+}
+
+/// <summary>
+/// タイル列のチェックサムと最大値を 1 パスで求める
+/// </summary>
+uint32_t ScanTiles(const uint8_t* bytes, size_t count, uint8_t& maxValue) {
+	uint32_t hash = 2166136261u;
+	maxValue = 0;
+	for (size_t i = 0; i < count; ++i) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+		maxValue = bytes[i] > maxValue ? bytes[i] : maxValue;
+	}
+	return hash;
+}
+
+} // namespace
+
+uint32_t ParseMapChipCsv(const char* data, size_t size, MapChipGrid& grid, std::vector<MapChipCsvError>& errors, uint32_t maxErrors) {
+	const char* cursor = data;
+	const char* fileEnd = data + size;
+
+	// 1 パスで全セルを読み、行ごとの列数を記録する
+	// セル数はおおよそ「ファイルサイズ / 2」（1 桁 + カンマ）なので先に確保しておく
+	std::vector<MapChipType> cells;
+	cells.reserve(size / 2 + 1);
+	std::vector<uint32_t> rowLengths;
+	uint32_t maxCols = 0;
+	uint32_t errorCount = 0;
+
+	while (cursor < fileEnd) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(fileEnd - cursor)));
+		if (!lineEnd) {
+			lineEnd = fileEnd;
+		}
+		const char* lineBegin = cursor;
+		cursor = (lineEnd < fileEnd) ? lineEnd + 1 : fileEnd;
+
+		// 空行（空白のみの行を含む）は無視
+		const char* contentEnd = lineEnd;
+		while (contentEnd > lineBegin && IsCsvSpace(contentEnd[-1])) --contentEnd;
+		if (contentEnd == lineBegin) {
+			continue;
+		}
+
+		uint32_t cols = 0;
+		const char* cell = lineBegin;
+		while (cell < contentEnd) {
+			const char* cellEnd = static_cast<const char*>(std::memchr(cell, ',', static_cast<size_t>(contentEnd - cell)));
+			if (!cellEnd) {
+				cellEnd = contentEnd;
+			}
+
+			MapChipType type;
+			if (!ParseMapChipCell(cell, cellEnd, type)) {
+				// 不正な値は blank のまま読み進め、位置を記録する
+				if (errorCount < maxErrors) {
+					errors.push_back({static_cast<uint32_t>(rowLengths.size()) + 1, cols + 1, std::string(cell, cellEnd)});
+				}
+				++errorCount;
+			}
+			cells.push_back(type);
+			++cols;
+
+			// 行末のカンマの後ろは空セルとして数えない
+			cell = cellEnd + 1;
+		}
+
+		rowLengths.push_back(cols);
+		if (cols > maxCols) {
+			maxCols = cols;
+		}
+	}
+
+	grid.width = maxCols;
+	grid.height = static_cast<uint32_t>(rowLengths.size());
+
+	if (cells.size() == static_cast<size_t>(grid.height) * grid.width) {
+		// 全行が同じ列数ならそのまま行優先バッファになっている
+		grid.tiles = std::move(cells);
+	} else {
+		// 列数の足りない行は blank で埋める
+		grid.tiles.assign(static_cast<size_t>(grid.height) * grid.width, MapChipType::kBlank);
+		size_t source = 0;
+		for (uint32_t y = 0; y < grid.height; ++y) {
+			std::memcpy(grid.tiles.data() + static_cast<size_t>(y) * grid.width, cells.data() + source, rowLengths[y] * sizeof(MapChipType));
+			source += rowLengths[y];
+		}
+	}
+
+	return errorCount;
+}
+
+uint32_t ParseMapChipStageCsv(const char* data, size_t size, MapChipStage& stage, std::vector<MapChipCsvError>& errors, uint32_t maxErrors) {
+	stage.collision = {};
+	stage.layers.clear();
+
+	struct Section {
+		std::string name; // 不正・重複した見出しの区間は空（セルの不正は数えるが読み捨てる）
+		MapChipGrid grid;
+	};
+	std::vector<Section> sections;
+	uint32_t errorCount = 0;
+	const size_t errorsBegin = errors.size();
+
+	// 見出しの位置で区切り、区間ごとに ParseMapChipCsv で読む
+	// 区間内の行番号をファイル全体の（空でない）行番号にずらすため、区間の手前までの行数を数えておく
+	std::string sectionName = kMapChipCollisionLayerName;
+	const char* sectionBegin = data;
+	uint32_t sectionFirstRow = 0;
+	bool beforeFirstHeader = true;
+	auto flush = [&](const char* sectionEnd) {
+		size_t firstError = errors.size();
+		uint32_t stored = static_cast<uint32_t>(firstError - errorsBegin);
+		uint32_t budget = maxErrors > stored ? maxErrors - stored : 0;
+		Section section{sectionName, {}};
+		errorCount += ParseMapChipCsv(sectionBegin, static_cast<size_t>(sectionEnd - sectionBegin), section.grid, errors, budget);
+		for (size_t i = firstError; i < errors.size(); ++i) {
+			errors[i].row += sectionFirstRow;
+		}
+		// 最初の見出しより前に何も書かれていなければ、当たり判定レイヤーは後の見出しで現れるかもしれない
+		if (beforeFirstHeader && section.grid.height == 0) {
+			return;
+		}
+		sections.push_back(std::move(section));
+	};
+
+	const char* cursor = data;
+	const char* fileEnd = data + size;
+	uint32_t row = 0;
+	std::string name;
+	while (cursor < fileEnd) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(fileEnd - cursor)));
+		if (!lineEnd) {
+			lineEnd = fileEnd;
+		}
+		const char* lineBegin = cursor;
+		cursor = (lineEnd < fileEnd) ? lineEnd + 1 : fileEnd;
+
+		const char* contentEnd = lineEnd;
+		while (contentEnd > lineBegin && IsCsvSpace(contentEnd[-1])) --contentEnd;
+		if (contentEnd == lineBegin) {
+			continue;
+		}
+		++row;
+
+		if (!ParseLayerHeader(lineBegin, contentEnd, name)) {
+			continue;
+		}
+		flush(lineBegin);
+		beforeFirstHeader = false;
+
+		for (const Section& section : sections) {
+			if (section.name == name) {
+				name.clear();
+			}
+		}
+		if (name.empty()) {
+			if (errors.size() - errorsBegin < maxErrors) {
+				errors.push_back({row, 1, std::string(lineBegin, contentEnd)});
+			}
+			++errorCount;
+		}
+		sectionName = name;
+		sectionBegin = cursor;
+		sectionFirstRow = row;
+	}
+	flush(fileEnd);
+
+	// 全レイヤーを最も大きいものに揃える
+	uint32_t width = 0;
+	uint32_t height = 0;
+	for (const Section& section : sections) {
+		width = section.grid.width > width ? section.grid.width : width;
+		height = section.grid.height > height ? section.grid.height : height;
+	}
+	stage.collision.width = width;
+	stage.collision.height = height;
+	stage.collision.tiles.assign(static_cast<size_t>(width) * height, MapChipType::kBlank);
+	for (Section& section : sections) {
+		if (section.name.empty()) {
+			continue;
+		}
+		ResizeTiles(section.grid.tiles, section.grid.width, section.grid.height, width, height);
+		if (section.name == kMapChipCollisionLayerName) {
+			stage.collision.tiles = std::move(section.grid.tiles);
+		} else {
+			stage.layers.push_back({std::move(section.name), std::move(section.grid.tiles)});
+		}
+	}
+	return errorCount;
+}
+
+uint32_t ComputeMapChipChecksum(const MapChipType* tiles, size_t count) {
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(tiles);
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < count; ++i) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+bool ReadMapChipBinary(const char* data, size_t size, MapChipBinaryView& view, const char*& error) {
+	if (size < sizeof(MapChipBinaryHeader)) {
+		error = "file is smaller than the header";
+		return false;
+	}
+
+	// マップされた先頭はアラインされているが、念のためコピーして読む
+	MapChipBinaryHeader header;
+	std::memcpy(&header, data, sizeof(header));
+
+	if (std::memcmp(header.magic, kMapChipBinaryMagic, sizeof(kMapChipBinaryMagic)) != 0) {
+		error = "bad magic";
+		return false;
+	}
+	if (header.version != 1 && header.version != kMapChipBinaryVersion) {
+		error = "unsupported version";
+		return false;
+	}
+	if (header.encoding != static_cast<uint16_t>(MapChipTileEncoding::kRaw8)) {
+		error = "unsupported tile encoding";
+		return false;
+	}
+	if (header.width == 0 || header.height == 0) {
+		error = "empty map";
+		return false;
+	}
+
+	uint64_t tileCount = static_cast<uint64_t>(header.width) * header.height;
+	uint64_t remaining = size - sizeof(MapChipBinaryHeader);
+	if (header.version == 1 ? tileCount != remaining : tileCount + sizeof(uint32_t) > remaining) {
+		error = "tile data size does not match the header";
+		return false;
+	}
+
+	const char* cursor = data + sizeof(MapChipBinaryHeader);
+	const char* end = data + size;
+	const MapChipType* tiles = reinterpret_cast<const MapChipType*>(cursor);
+
+	// チェックサムとタイル値の範囲を 1 パスで確認する
+	uint8_t maxValue = 0;
+	if (ScanTiles(reinterpret_cast<const uint8_t*>(tiles), tileCount, maxValue) != header.checksum) {
+		error = "checksum mismatch";
+		return false;
+	}
+	if (maxValue >= kMapChipTypeCount) {
+		error = "tile value out of range";
+		return false;
+	}
+	cursor += tileCount;
+
+	std::vector<MapChipBinaryLayerView> layers;
+	if (header.version >= 2) {
+		uint32_t layerCount;
+		std::memcpy(&layerCount, cursor, sizeof(layerCount));
+		cursor += sizeof(layerCount);
+		for (uint32_t i = 0; i < layerCount; ++i) {
+			MapChipBinaryLayerHeader layerHeader;
+			if (static_cast<size_t>(end - cursor) < sizeof(layerHeader)) {
+				error = "truncated layer header";
+				return false;
+			}
+			std::memcpy(&layerHeader, cursor, sizeof(layerHeader));
+			cursor += sizeof(layerHeader);
+			if (layerHeader.nameLength == 0 || static_cast<uint64_t>(end - cursor) < layerHeader.nameLength + tileCount) {
+				error = "truncated layer";
+				return false;
+			}
+
+			MapChipBinaryLayerView layer;
+			layer.name.assign(cursor, layerHeader.nameLength);
+			cursor += layerHeader.nameLength;
+			layer.tiles = reinterpret_cast<const MapChipType*>(cursor);
+			if (ScanTiles(reinterpret_cast<const uint8_t*>(layer.tiles), tileCount, maxValue) != layerHeader.checksum) {
+				error = "layer checksum mismatch";
+				return false;
+			}
+			if (maxValue >= kMapChipTypeCount) {
+				error = "layer tile value out of range";
+				return false;
+			}
+			cursor += tileCount;
+			layers.push_back(std::move(layer));
+		}
+		if (cursor != end) {
+			error = "trailing data after the last layer";
+			return false;
+		}
+	}
+
+	view.width = header.width;
+	view.height = header.height;
+	view.tiles = tiles;
+	view.layers = std::move(layers);
+	return true;
+}
+
+bool WriteMapChipBinary(const std::string& filename, const MapChipStage& stage) {
+	const MapChipGrid& grid = stage.collision;
+	MapChipBinaryHeader header = {};
+	std::memcpy(header.magic, kMapChipBinaryMagic, sizeof(kMapChipBinaryMagic));
+	header.version = kMapChipBinaryVersion;
+	header.encoding = static_cast<uint16_t>(MapChipTileEncoding::kRaw8);
+	header.width = grid.width;
+	header.height = grid.height;
+	header.checksum = ComputeMapChipChecksum(grid.tiles.data(), grid.tiles.size());
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(grid.tiles.data()), static_cast<std::streamsize>(grid.tiles.size()));
+
+	uint32_t layerCount = static_cast<uint32_t>(stage.layers.size());
+	file.write(reinterpret_cast<const char*>(&layerCount), sizeof(layerCount));
+	for (const MapChipLayerGrid& layer : stage.layers) {
+		MapChipBinaryLayerHeader layerHeader = {};
+		layerHeader.nameLength = static_cast<uint32_t>(layer.name.size());
+		layerHeader.checksum = ComputeMapChipChecksum(layer.tiles.data(), layer.tiles.size());
+		file.write(reinterpret_cast<const char*>(&layerHeader), sizeof(layerHeader));
+		file.write(layer.name.data(), static_cast<std::streamsize>(layer.name.size()));
+		file.write(reinterpret_cast<const char*>(layer.tiles.data()), static_cast<std::streamsize>(layer.tiles.size()));
+	}
+	return file.good();
+}
+
+std::string GetMapChipBinaryPath(const std::string& csvPath) {
+	// ディレクトリ区切りより後ろにある最後の '.' を拡張子とみなす
+	size_t slash = csvPath.find_last_of("/\\");
+	size_t dot = csvPath.find_last_of('.');
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+		return csvPath + kMapChipBinaryExtension;
+	}
+	return csvPath.substr(0, dot) + kMapChipBinaryExtension;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "MapChipType.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// マップデータの読み書き（エンジン非依存）
+// ゲーム本体の MapChipField と Tools/MapChipConverter の両方から使う
+
+/// <summary>
+/// 行優先 (row-major) のマップチップ配列。要素 (x, y) は tiles[y * width + x]
+/// </summary>
+struct MapChipGrid {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<MapChipType> tiles;
+};
+
+/// <summary>
+/// CSV 解析で見つかった不正セル（行・列は 1 始まり）
+/// </summary>
+struct MapChipCsvError {
+	uint32_t row;
+	uint32_t column;
+	std::string text;
+};
+
+/// <summary>
+/// CSV テキストを 1 パスで解析する
+/// 空行は無視し、行末のカンマの後ろは空セルとして数えない。列数の足りない行は blank で埋める
+/// </summary>
+/// <param name="data">CSV テキストの先頭</param>
+/// <param name="size">バイト数</param>
+/// <param name="grid">出力先（データがなければ width == height == 0）</param>
+/// <param name="errors">不正セルの格納先（先頭 maxErrors 件のみ）</param>
+/// <param name="maxErrors">errors に格納する上限</param>
+/// <returns>不正セルの総数（不正セルは blank として読み込む）</returns>
+uint32_t ParseMapChipCsv(const char* data, size_t size, MapChipGrid& grid, std::vector<MapChipCsvError>& errors, uint32_t maxErrors);
+
+// ---- レイヤー付きのステージファイル ----
+//
+// CSV の中で "[名前]" だけの行から次の見出しまでが 1 枚のレイヤーになる
+// 最初の見出しより前の行は当たり判定レイヤー（見出しのない従来の CSV はすべて当たり判定レイヤー）
+// 名前に使えるのは英数字と '_' '-'。同じ名前は 1 回だけ
+// レイヤーごとに大きさが違えば、最も大きいものに合わせて blank で埋める
+
+inline constexpr const char* kMapChipCollisionLayerName = "collision";
+// 生成対象 (MapChipProperty::spawnKind) のタイルを置くレイヤー。当たり判定には使わない
+inline constexpr const char* kMapChipEntityLayerName = "entities";
+// 描画だけするレイヤー。当たり判定にも生成にも使わない
+inline constexpr const char* kMapChipDecorationLayerName = "decoration";
+
+/// <summary>
+/// 当たり判定レイヤー以外の名前付きレイヤー（大きさはステージと同じ、行優先）
+/// </summary>
+struct MapChipLayerGrid {
+	std::string name;
+	std::vector<MapChipType> tiles;
+};
+
+/// <summary>
+/// ステージファイル 1 つ分
+/// </summary>
+struct MapChipStage {
+	MapChipGrid collision;
+	std::vector<MapChipLayerGrid> layers; // ファイルに書かれた順
+};
+
+/// <summary>
+/// レイヤー付きの CSV テキストを解析する。各レイヤーの中身は ParseMapChipCsv と同じ規則で読む
+/// 不正な見出し・重複した名前も不正セルとして数える（row はファイル先頭からの空でない行の番号、column は 1）
+/// </summary>
+/// <returns>不正セルの総数</returns>
+uint32_t ParseMapChipStageCsv(const char* data, size_t size, MapChipStage& stage, std::vector<MapChipCsvError>& errors, uint32_t maxErrors);
+
+// ---- コンパイル済みバイナリ形式 (.mcb) ----
+//
+// [MapChipBinaryHeader][tiles: width * height バイト]
+// バージョン 2 以降はその後ろに [uint32_t レイヤー数] と、レイヤーごとに
+// [MapChipBinaryLayerHeader][名前: nameLength バイト][tiles: width * height バイト] が続く
+// 数値はすべてリトルエンディアン。tiles は行優先で 1 タイル 1 バイト（MapChipType の値そのまま）
+// バージョン 1（レイヤーなし）のファイルもそのまま読める
+
+inline constexpr char kMapChipBinaryMagic[4] = {'M', 'C', 'H', 'P'};
+inline constexpr uint16_t kMapChipBinaryVersion = 2;
+inline constexpr const char* kMapChipBinaryExtension = ".mcb";
+
+// タイル配列の格納方式（将来の圧縮形式用に予約）
+enum class MapChipTileEncoding : uint16_t {
+	kRaw8 = 0, // 1 タイル 1 バイト、行優先
+};
+
+struct MapChipBinaryHeader {
+	char magic[4];
+	uint16_t version;
+	uint16_t encoding;
+	uint32_t width;
+	uint32_t height;
+	uint32_t checksum; // tiles の FNV-1a (32bit)
+	uint32_t reserved;
+};
+static_assert(sizeof(MapChipBinaryHeader) == 24, "MapChipBinaryHeader layout must not change without bumping the version");
+
+struct MapChipBinaryLayerHeader {
+	uint32_t nameLength;
+	uint32_t checksum; // tiles の FNV-1a (32bit)
+};
+static_assert(sizeof(MapChipBinaryLayerHeader) == 8, "MapChipBinaryLayerHeader layout must not change without bumping the version");
+
+/// <summary>
+/// 検証済みバイナリの名前付きレイヤー（tiles は元のバッファを指す）
+/// </summary>
+struct MapChipBinaryLayerView {
+	std::string name;
+	const MapChipType* tiles = nullptr;
+};
+
+/// <summary>
+/// 検証済みバイナリの中身を指すビュー（tiles は元のバッファを指す）
+/// </summary>
+struct MapChipBinaryView {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	const MapChipType* tiles = nullptr; // 当たり判定レイヤー
+	std::vector<MapChipBinaryLayerView> layers;
+};
+
+/// <summary>
+/// タイル配列のチェックサム (FNV-1a 32bit)
+/// </summary>
+uint32_t ComputeMapChipChecksum(const MapChipType* tiles, size_t count);
+
+/// <summary>
+/// バイナリを検証し、タイル配列へのビューを返す
+/// マジック・バージョン・格納方式・サイズ・チェックサム・タイル値の範囲を、レイヤーごとに確認する
+/// </summary>
+/// <param name="error">失敗時に理由を指す（静的文字列）</param>
+/// <returns>検証に成功すれば true</returns>
+bool ReadMapChipBinary(const char* data, size_t size, MapChipBinaryView& view, const char*& error);
+
+/// <summary>
+/// ステージをバイナリ形式でファイルに書き出す
+/// </summary>
+/// <returns>書き込みに失敗すれば false</returns>
+bool WriteMapChipBinary(const std::string& filename, const MapChipStage& stage);
+
+/// <summary>
+/// CSV のパスから対応するバイナリのパスを作る（拡張子を .mcb に置き換える）
+/// </summary>
+std::string GetMapChipBinaryPath(const std::string& csvPath);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// タイル配列のメモリ配置（エンジン非依存）
+// MapChipField はここで選んだ MapChipTileLayout の配置でタイルを持ち、添字はすべて TileOffset で求める
+// ビルド時に MAPCHIP_LAYOUT_MORTON を定義すると Z 順 (Morton) の配置になる。比較は Tools/MapChipLayoutBench で行う
+
+/// <summary>
+/// 行優先。要素 (x, y) は y * 横ブロック数 + x
+/// </summary>
+struct MapChipRowMajorLayout {
+	static inline constexpr bool kIsRowMajor = true;
+
+	static constexpr size_t StorageSize(uint32_t width, uint32_t height) { return static_cast<size_t>(width) * height; }
+
+	static constexpr size_t TileOffset(uint32_t xIndex, uint32_t yIndex, uint32_t width) { return static_cast<size_t>(yIndex) * width + xIndex; }
+};
+
+/// <summary>
+/// 8x8 タイル（64 バイト = キャッシュライン 1 本）のブロックを行優先に並べ、ブロック内を Z 順に並べる
+/// 上下の隣接タイルもほぼ同じキャッシュラインに入る。縦横は 8 の倍数に切り上げて確保し、余りは kBlank で埋める
+/// </summary>
+struct MapChipMortonLayout {
+	static inline constexpr bool kIsRowMajor = false;
+
+	static inline constexpr uint32_t kBlockShift = 3;
+	static inline constexpr uint32_t kBlockSize = 1u << kBlockShift;
+
+	static constexpr uint32_t BlockCount(uint32_t tiles) { return (tiles + kBlockSize - 1) >> kBlockShift; }
+
+	static constexpr size_t StorageSize(uint32_t width, uint32_t height) {
+		return static_cast<size_t>(BlockCount(width)) * BlockCount(height) << (kBlockShift * 2);
+	}
+
+	// 下位 3 ビットを 1 ビットおきに広げる表 (abc -> a0b0c)。ビット演算より速い
+	static inline constexpr uint8_t kSpread3[kBlockSize] = {0, 1, 4, 5, 16, 17, 20, 21};
+
+	static constexpr size_t TileOffset(uint32_t xIndex, uint32_t yIndex, uint32_t width) {
+		size_t block = static_cast<size_t>(yIndex >> kBlockShift) * BlockCount(width) + (xIndex >> kBlockShift);
+		return (block << (kBlockShift * 2)) | kSpread3[xIndex & (kBlockSize - 1)] | (kSpread3[yIndex & (kBlockSize - 1)] << 1);
+	}
+};
+
+#ifdef MAPCHIP_LAYOUT_MORTON
+using MapChipTileLayout = MapChipMortonLayout;
+#else
+using MapChipTileLayout = MapChipRowMajorLayout;
+#endif
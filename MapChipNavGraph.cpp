@@ -0,0 +1,415 @@
+#include "MapChipNavGraph.h"
+
+#include <algorithm>
+#include <bit>
+
+void MapChipNavGraph::Build(const MapChipSnapshot& snapshot) {
+	const uint32_t height = snapshot.GetNumBlockVertical();
+	width_ = snapshot.GetNumBlockHorizontal();
+	nodes_.clear();
+	freeNodes_.clear();
+	rowNodes_.resize(height);
+	for (uint32_t y = 0; y < height; ++y) {
+		const uint32_t first = static_cast<uint32_t>(nodes_.size());
+		ScanRow(snapshot, y, nodes_);
+		rowNodes_[y].clear();
+		for (uint32_t n = first; n < nodes_.size(); ++n) {
+			rowNodes_[y].push_back(n);
+		}
+	}
+	BuildLinks(snapshot);
+	++version_;
+}
+
+void MapChipNavGraph::Update(const MapChipSnapshot& snapshot, std::span<const MapChipTileChange> changes) {
+	if (changes.empty()) {
+		return;
+	}
+	const uint32_t height = snapshot.GetNumBlockVertical();
+	if (width_ != snapshot.GetNumBlockHorizontal() || rowNodes_.size() != height) {
+		Build(snapshot);
+		return;
+	}
+
+	// 書き換わったタイルを囲む範囲
+	uint32_t minX = changes.front().index.xIndex;
+	uint32_t maxX = minX;
+	uint32_t minY = changes.front().index.yIndex;
+	uint32_t maxY = minY;
+	for (const MapChipTileChange& change : changes) {
+		minX = std::min(minX, change.index.xIndex);
+		maxX = std::max(maxX, change.index.xIndex);
+		minY = std::min(minY, change.index.yIndex);
+		maxY = std::max(maxY, change.index.yIndex);
+	}
+
+	// 区間が変わりうるのは、書き換わった行（solid・hazard）とその上の行（真下の ground・hazard）だけ
+	// その行は調べ直して前の区間と突き合わせ、消えた区間・新しい区間が掛かる列まで changedX0 ～ changedX1 を広げる
+	const uint32_t firstRow = minY > 0 ? minY - 1 : 0;
+	int64_t changedX0 = minX;
+	int64_t changedX1 = maxX;
+	dirtyNodes_.clear();
+	affectedNodes_.clear();
+	for (uint32_t y = firstRow; y <= maxY; ++y) {
+		scannedNodes_.clear();
+		ScanRow(snapshot, y, scannedNodes_);
+		std::vector<uint32_t>& row = rowNodes_[y];
+		rowScratch_.clear();
+		// どちらも x0 の昇順で重ならないので、同じ区間は残し、違えば先に終わる方を変わった区間として進める
+		size_t o = 0;
+		size_t s = 0;
+		while (o < row.size() || s < scannedNodes_.size()) {
+			if (o < row.size() && s < scannedNodes_.size() && nodes_[row[o]].x0 == scannedNodes_[s].x0 && nodes_[row[o]].x1 == scannedNodes_[s].x1) {
+				rowScratch_.push_back(row[o++]);
+				++s;
+				continue;
+			}
+			if (o < row.size() && (s == scannedNodes_.size() || nodes_[row[o]].x1 <= scannedNodes_[s].x1)) {
+				const uint32_t removed = row[o++];
+				changedX0 = std::min<int64_t>(changedX0, nodes_[removed].x0);
+				changedX1 = std::max<int64_t>(changedX1, nodes_[removed].x1);
+				// 出るリンクの行き先は入るリンクを直す。入るリンクの出る側は下で求め直す区間に含まれる
+				for (const MapChipNavLink& link : GetLinks(removed)) {
+					affectedNodes_.push_back(link.toNode);
+				}
+				unusedLinks_ += linkRanges_[removed].count;
+				unusedIncomingLinks_ += incomingRanges_[removed].count;
+				linkRanges_[removed] = {0, 0};
+				incomingRanges_[removed] = {0, 0};
+				nodes_[removed].yIndex = kMapChipNavNone;
+				freeNodes_.push_back(removed);
+			} else {
+				const MapChipNavNode& added = scannedNodes_[s++];
+				changedX0 = std::min<int64_t>(changedX0, added.x0);
+				changedX1 = std::max<int64_t>(changedX1, added.x1);
+				const uint32_t node = AllocateNode(added);
+				rowScratch_.push_back(node);
+				affectedNodes_.push_back(node);
+			}
+		}
+		row.swap(rowScratch_);
+	}
+
+	// リンクを求め直す区間（新しい区間はすべて含まれる）
+	//   落下: 横へ 1 歩出た列が changedX0 ～ changedX1 に入る（その列の距離場・着地する区間が変わりうる）
+	//         距離場は 254 タイルまでなので、書き換わった行より上はその範囲だけを調べればよい
+	//   ジャンプ: 跳べる行の範囲に書き換わった行・変わった区間の行が入り、横に届く範囲が changedX0 ～ changedX1 に掛かる
+	const int64_t dropRow0 = static_cast<int64_t>(minY) - 1 - kMapChipDistanceNone;
+	const int64_t jumpRow0 = static_cast<int64_t>(minY) - 1 - kMaxJumpFall;
+	const int64_t jumpRow1 = static_cast<int64_t>(maxY) + kMaxJumpRise + 1;
+	const uint32_t lastRow = static_cast<uint32_t>(std::min<int64_t>(jumpRow1, height - 1));
+	for (uint32_t y = static_cast<uint32_t>(std::max<int64_t>(dropRow0, 0)); y <= lastRow; ++y) {
+		const int64_t reach = (y >= jumpRow0 && y <= jumpRow1) ? kMaxJumpGap + 1 : 1;
+		CollectNodesInRow(y, changedX0 - reach, changedX1 + reach, dirtyNodes_);
+	}
+	std::sort(dirtyNodes_.begin(), dirtyNodes_.end());
+	dirtyNodes_.erase(std::unique(dirtyNodes_.begin(), dirtyNodes_.end()), dirtyNodes_.end());
+
+	const uint32_t addedBegin = static_cast<uint32_t>(links_.size());
+	for (uint32_t node : dirtyNodes_) {
+		for (const MapChipNavLink& link : GetLinks(node)) {
+			affectedNodes_.push_back(link.toNode);
+		}
+		unusedLinks_ += linkRanges_[node].count;
+		AddLinks(snapshot, node);
+	}
+	addedLinks_.clear();
+	for (uint32_t l = addedBegin; l < links_.size(); ++l) {
+		affectedNodes_.push_back(links_[l].toNode);
+		addedLinks_.push_back(l);
+	}
+	std::stable_sort(addedLinks_.begin(), addedLinks_.end(), [&](uint32_t a, uint32_t b) { return links_[a].toNode < links_[b].toNode; });
+
+	// 入るリンクは、前のリンク・新しいリンクの行き先と新しい区間の分だけを作り直す
+	// 前の索引からは今も使われている（出る側の範囲に入っている）リンクだけを残し、新しいリンクを足す
+	std::sort(affectedNodes_.begin(), affectedNodes_.end());
+	affectedNodes_.erase(std::unique(affectedNodes_.begin(), affectedNodes_.end()), affectedNodes_.end());
+	for (uint32_t node : affectedNodes_) {
+		if (nodes_[node].yIndex == kMapChipNavNone) {
+			continue;
+		}
+		const Range previous = incomingRanges_[node];
+		const uint32_t offset = static_cast<uint32_t>(incomingLinks_.size());
+		for (uint32_t i = 0; i < previous.count; ++i) {
+			const uint32_t l = incomingLinks_[previous.offset + i];
+			const Range& from = linkRanges_[links_[l].fromNode];
+			if (l >= from.offset && l < from.offset + from.count) {
+				incomingLinks_.push_back(l);
+			}
+		}
+		auto added = std::lower_bound(addedLinks_.begin(), addedLinks_.end(), node, [&](uint32_t l, uint32_t n) { return links_[l].toNode < n; });
+		for (; added != addedLinks_.end() && links_[*added].toNode == node; ++added) {
+			incomingLinks_.push_back(*added);
+		}
+		unusedIncomingLinks_ += previous.count;
+		incomingRanges_[node] = {offset, static_cast<uint32_t>(incomingLinks_.size()) - offset};
+	}
+
+	// 使われなくなった分が使われている分を超えたら詰め直す
+	if (unusedLinks_ * 2 > links_.size() || unusedIncomingLinks_ * 2 > incomingLinks_.size()) {
+		Build(snapshot);
+		return;
+	}
+	++version_;
+}
+
+uint32_t MapChipNavGraph::AllocateNode(const MapChipNavNode& node) {
+	if (!freeNodes_.empty()) {
+		uint32_t id = freeNodes_.back();
+		freeNodes_.pop_back();
+		nodes_[id] = node;
+		return id;
+	}
+	nodes_.push_back(node);
+	linkRanges_.push_back({0, 0});
+	incomingRanges_.push_back({0, 0});
+	return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void MapChipNavGraph::ScanRow(const MapChipSnapshot& snapshot, uint32_t y, std::vector<MapChipNavNode>& out) {
+	// 最下行の下には地面がないので立てない
+	if (y + 1 >= snapshot.GetNumBlockVertical()) {
+		return;
+	}
+	std::span<const uint64_t> solid = snapshot.GetPlaneWords(MapChipPlane::kSolid, y, planeRowScratch_[0]);
+	std::span<const uint64_t> hazard = snapshot.GetPlaneWords(MapChipPlane::kHazard, y, planeRowScratch_[1]);
+	std::span<const uint64_t> groundBelow = snapshot.GetPlaneWords(MapChipPlane::kGround, y + 1, planeRowScratch_[2]);
+	std::span<const uint64_t> hazardBelow = snapshot.GetPlaneWords(MapChipPlane::kHazard, y + 1, planeRowScratch_[3]);
+
+	// 立てるタイルのビット列から、1 が続く区間を取り出す（幅より右のビットは ground が 0 なので立たない）
+	bool open = false;
+	for (size_t w = 0; w < solid.size(); ++w) {
+		uint64_t stand = ~solid[w] & ~hazard[w] & groundBelow[w] & ~hazardBelow[w];
+		uint32_t base = static_cast<uint32_t>(w) * 64;
+		uint32_t bit = 0;
+		while (bit < 64) {
+			uint64_t rest = stand >> bit;
+			if (!open) {
+				if (rest == 0) {
+					break;
+				}
+				bit += static_cast<uint32_t>(std::countr_zero(rest));
+				out.push_back({y, base + bit, base + bit});
+				open = true;
+			} else {
+				uint32_t run = static_cast<uint32_t>(std::countr_one(rest));
+				bit += run;
+				out.back().x1 = base + bit - 1;
+				if (bit < 64) {
+					open = false;
+				}
+			}
+		}
+	}
+}
+
+void MapChipNavGraph::CollectNodesInRow(uint32_t y, int64_t x0, int64_t x1, std::vector<uint32_t>& out) const {
+	// 区間は重ならず x0 の昇順なので、x1 も昇順
+	const std::vector<uint32_t>& row = rowNodes_[y];
+	auto it = std::lower_bound(row.begin(), row.end(), x0, [&](uint32_t n, int64_t x) { return static_cast<int64_t>(nodes_[n].x1) < x; });
+	for (; it != row.end() && static_cast<int64_t>(nodes_[*it].x0) <= x1; ++it) {
+		out.push_back(*it);
+	}
+}
+
+void MapChipNavGraph::BuildLinks(const MapChipSnapshot& snapshot) {
+	const uint32_t nodeCount = static_cast<uint32_t>(nodes_.size());
+	links_.clear();
+	linkRanges_.assign(nodeCount, {0, 0});
+	for (uint32_t n = 0; n < nodeCount; ++n) {
+		AddLinks(snapshot, n);
+	}
+	unusedLinks_ = 0;
+
+	// 入るリンクの索引（行き先のノード順）
+	incomingRanges_.assign(nodeCount, {0, 0});
+	for (const MapChipNavLink& link : links_) {
+		++incomingRanges_[link.toNode].count;
+	}
+	uint32_t offset = 0;
+	for (Range& range : incomingRanges_) {
+		range.offset = offset;
+		offset += range.count;
+		range.count = 0;
+	}
+	incomingLinks_.resize(links_.size());
+	for (uint32_t i = 0; i < links_.size(); ++i) {
+		Range& range = incomingRanges_[links_[i].toNode];
+		incomingLinks_[range.offset + range.count++] = i;
+	}
+	unusedIncomingLinks_ = 0;
+}
+
+void MapChipNavGraph::AddLinks(const MapChipSnapshot& snapshot, uint32_t node) {
+	const uint32_t offset = static_cast<uint32_t>(links_.size());
+	AddDropLink(snapshot, node, nodes_[node].x0, -1);
+	AddDropLink(snapshot, node, nodes_[node].x1, 1);
+	AddJumpLinks(snapshot, node);
+	linkRanges_[node] = {offset, static_cast<uint32_t>(links_.size()) - offset};
+}
+
+void MapChipNavGraph::AddDropLink(const MapChipSnapshot& snapshot, uint32_t node, uint32_t edgeX, int32_t step) {
+	const MapChipNavNode& from = nodes_[node];
+	int64_t x = static_cast<int64_t>(edgeX) + step;
+	if (x < 0 || x >= snapshot.GetNumBlockHorizontal() || snapshot.TestPlane(MapChipPlane::kSolid, static_cast<uint32_t>(x), from.yIndex)) {
+		return;
+	}
+
+	// 横へ 1 歩出たタイルから、距離場で着地する高さを引く
+	uint8_t distance = snapshot.GetGroundDistance(static_cast<uint32_t>(x), from.yIndex);
+	if (distance == kMapChipDistanceNone || distance < 2) {
+		return;
+	}
+	uint32_t landingY = from.yIndex + distance - 1;
+	uint32_t to = FindNode(static_cast<uint32_t>(x), landingY);
+	if (to == kMapChipNavNone) {
+		// 棘の上などには降りない
+		return;
+	}
+	links_.push_back({MapChipNavLinkKind::kDrop, node, to, {edgeX, from.yIndex}, {static_cast<uint32_t>(x), landingY}, 1 + (landingY - from.yIndex)});
+}
+
+void MapChipNavGraph::AddJumpLinks(const MapChipSnapshot& snapshot, uint32_t node) {
+	const MapChipNavNode from = nodes_[node];
+	const uint32_t height = snapshot.GetNumBlockVertical();
+	uint32_t firstRow = from.yIndex > kMaxJumpRise ? from.yIndex - kMaxJumpRise : 0;
+	uint32_t lastRow = std::min(from.yIndex + kMaxJumpFall, height - 1);
+	int64_t reachLeft = static_cast<int64_t>(from.x0) - kMaxJumpGap - 1;
+	int64_t reachRight = static_cast<int64_t>(from.x1) + kMaxJumpGap + 1;
+
+	for (uint32_t y = firstRow; y <= lastRow; ++y) {
+		// 区間は重ならず x0 の昇順なので、x1 も昇順。届く範囲の最初の区間から調べる
+		const std::vector<uint32_t>& row = rowNodes_[y];
+		auto it = std::lower_bound(row.begin(), row.end(), reachLeft, [&](uint32_t n, int64_t x) { return static_cast<int64_t>(nodes_[n].x1) < x; });
+		for (; it != row.end() && static_cast<int64_t>(nodes_[*it].x0) <= reachRight; ++it) {
+			const MapChipNavNode& to = nodes_[*it];
+			// 真上・真下に重なる区間へは、足場を突き抜けないと届かないのでつながない
+			uint32_t takeoffX;
+			uint32_t landingX;
+			if (to.x0 > from.x1) {
+				takeoffX = from.x1;
+				landingX = to.x0;
+			} else if (to.x1 < from.x0) {
+				takeoffX = from.x0;
+				landingX = to.x1;
+			} else {
+				continue;
+			}
+			// 同じ高さで隣り合う区間は、間に危険なタイルがあって分かれている
+			if (y == from.yIndex && (landingX > takeoffX ? landingX - takeoffX : takeoffX - landingX) <= 1) {
+				continue;
+			}
+
+			// 跳び上がる列・頂点の高さの 2 行・降りる列がすべて空いていれば届く
+			uint32_t top = std::min(from.yIndex, y);
+			if (top == 0) {
+				continue;
+			}
+			int32_t apex = static_cast<int32_t>(top) - 1;
+			int32_t left = static_cast<int32_t>(std::min(takeoffX, landingX));
+			int32_t right = static_cast<int32_t>(std::max(takeoffX, landingX));
+			if (snapshot.AnyInRect(MapChipPlane::kSolid, static_cast<int32_t>(takeoffX), apex, static_cast<int32_t>(takeoffX), static_cast<int32_t>(from.yIndex)) ||
+			    snapshot.AnyInRect(MapChipPlane::kSolid, left, apex, right, apex + 1) ||
+			    snapshot.AnyInRect(MapChipPlane::kSolid, static_cast<int32_t>(landingX), apex, static_cast<int32_t>(landingX), static_cast<int32_t>(y))) {
+				continue;
+			}
+
+			uint32_t dx = right - left;
+			uint32_t dy = y > from.yIndex ? y - from.yIndex : from.yIndex - y;
+			links_.push_back({MapChipNavLinkKind::kJump, node, *it, {takeoffX, from.yIndex}, {landingX, y}, kJumpPenalty + dx + dy});
+		}
+	}
+}
+
+uint32_t MapChipNavGraph::FindNode(uint32_t xIndex, uint32_t yIndex) const {
+	if (yIndex >= rowNodes_.size()) {
+		return kMapChipNavNone;
+	}
+	const std::vector<uint32_t>& row = rowNodes_[yIndex];
+	// x0 が x 以下の最後の区間
+	auto it = std::upper_bound(row.begin(), row.end(), xIndex, [&](uint32_t x, uint32_t n) { return x < nodes_[n].x0; });
+	if (it == row.begin()) {
+		return kMapChipNavNone;
+	}
+	--it;
+	return xIndex <= nodes_[*it].x1 ? *it : kMapChipNavNone;
+}
+
+uint32_t MapChipNavGraph::FindNodeBelow(const MapChipSnapshot& snapshot, const KamataEngine::Vector3& position) const {
+	IndexSet index = snapshot.GetMapChipIndexSetByPosition(position);
+	uint8_t distance = snapshot.GetGroundDistance(index.xIndex, index.yIndex);
+	if (distance == kMapChipDistanceNone || distance == 0) {
+		return kMapChipNavNone;
+	}
+	return FindNode(index.xIndex, index.yIndex + distance - 1);
+}
+
+void MapChipNavFlowField::Update(const MapChipNavGraph& graph, uint32_t targetNode, uint32_t targetXIndex) {
+	bool graphChanged = graph_ != &graph || graphVersion_ != graph.GetVersion();
+	if (targetNode == kMapChipNavNone) {
+		// 目的地が空中などで決まらなければ前回のまま。ただしグラフが変わっていれば前回のノード番号は使えない
+		if (graphChanged) {
+			graph_ = &graph;
+			graphVersion_ = graph.GetVersion();
+			targetNode_ = kMapChipNavNone;
+			cost_.assign(graph.GetNodes().size(), kMapChipNavNone);
+			nextLink_.assign(graph.GetNodes().size(), kMapChipNavNone);
+			reached_.clear();
+		}
+		return;
+	}
+
+	targetXIndex_ = targetXIndex;
+	if (!graphChanged && targetNode == targetNode_) {
+		return;
+	}
+	graph_ = &graph;
+	graphVersion_ = graph.GetVersion();
+	targetNode_ = targetNode;
+	Rebuild(graph);
+}
+
+void MapChipNavFlowField::Rebuild(const MapChipNavGraph& graph) {
+	++rebuildCount_;
+	const size_t nodeCount = graph.GetNodes().size();
+	if (cost_.size() != nodeCount) {
+		cost_.assign(nodeCount, kMapChipNavNone);
+		nextLink_.assign(nodeCount, kMapChipNavNone);
+	} else {
+		// 探索は目的地の周辺で打ち切るので、全ノードではなく前回値を入れたノードだけを戻す
+		for (uint32_t node : reached_) {
+			cost_[node] = kMapChipNavNone;
+			nextLink_[node] = kMapChipNavNone;
+		}
+	}
+	reached_.clear();
+
+	// 目的地から入るリンクを逆にたどる。maxCost_ を超えたところで打ち切るので、広いマップでも手間は目的地の周辺だけ
+	auto greater = [](const QueueEntry& a, const QueueEntry& b) { return a.cost > b.cost; };
+	queue_.clear();
+	cost_[targetNode_] = 0;
+	reached_.push_back(targetNode_);
+	queue_.push_back({0, targetNode_});
+	while (!queue_.empty()) {
+		std::pop_heap(queue_.begin(), queue_.end(), greater);
+		QueueEntry entry = queue_.back();
+		queue_.pop_back();
+		if (entry.cost != cost_[entry.node]) {
+			continue;
+		}
+		for (uint32_t l : graph.GetIncomingLinks(entry.node)) {
+			const MapChipNavLink& link = graph.GetLink(l);
+			uint32_t cost = entry.cost + link.cost;
+			if (cost > maxCost_ || cost >= cost_[link.fromNode]) {
+				continue;
+			}
+			if (cost_[link.fromNode] == kMapChipNavNone) {
+				reached_.push_back(link.fromNode);
+			}
+			cost_[link.fromNode] = cost;
+			nextLink_[link.fromNode] = l;
+			queue_.push_back({cost, link.fromNode});
+			std::push_heap(queue_.begin(), queue_.end(), greater);
+		}
+	}
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "MapChipSnapshot.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ノード・リンクがないことを表す値
+inline constexpr uint32_t kMapChipNavNone = 0xFFFFFFFFu;
+
+/// <summary>
+/// 立てる区間 1 つ（行 yIndex のタイル [x0, x1]。どのタイルも solid でなく、真下が棘以外の ground）
+/// </summary>
+struct MapChipNavNode {
+	uint32_t yIndex;
+	uint32_t x0;
+	uint32_t x1;
+};
+
+enum class MapChipNavLinkKind : uint8_t {
+	kDrop, // 区間の端から横へ 1 歩出て真下へ落ちる
+	kJump, // 区間の端から跳んで、隙間・段差の先の区間へ移る
+};
+
+/// <summary>
+/// 区間から区間への移動 1 つ。takeoff は出発する区間の端のタイル、landing は着地するタイル
+/// </summary>
+struct MapChipNavLink {
+	MapChipNavLinkKind kind;
+	uint32_t fromNode;
+	uint32_t toNode;
+	IndexSet takeoff;
+	IndexSet landing;
+	uint32_t cost; // おおよそのタイル数（跳ぶ場合は kJumpPenalty を足す）
+};
+
+/// <summary>
+/// 地上の敵の経路探索用に、読み込み時にマップから作る区間のグラフ
+/// 区間の中は歩いて移動できるものとし、区間どうしを落下・ジャンプのリンクでつなぐ
+/// Build・Update の間は変更しないので、複数の MapChipNavFlowField・敵から同時に参照してよい
+/// </summary>
+class MapChipNavGraph {
+public:
+	// ジャンプで越えられる範囲（タイル数）
+	static inline const uint32_t kMaxJumpRise = 2; // 上る段差
+	static inline const uint32_t kMaxJumpFall = 4; // 下る段差
+	static inline const uint32_t kMaxJumpGap = 3;  // 横の隙間
+	static inline const uint32_t kJumpPenalty = 2;
+
+	/// <summary>
+	/// スナップショットの当たり判定レイヤーから作り直す。区間はビットプレーンをワード単位で調べて求める
+	/// </summary>
+	void Build(const MapChipSnapshot& snapshot);
+
+	/// <summary>
+	/// SetTile・差分リロードで書き換わったタイルの周辺だけを直す（区間・リンクは Build と同じになるが、番号の付け方は異なる）
+	/// 区間は書き換わった行とその上の行だけを調べ直し、リンクは変わった列に届く区間の分だけを求め直して末尾に足す
+	/// 区間の行の調べ直しはビットプレーンのワード単位なので、手間はほぼ書き換わった範囲の周辺の区間の数で決まる
+	/// 使われなくなったリンクが使われている分を超えたとき、またはマップの大きさが変わっていれば Build する
+	/// </summary>
+	void Update(const MapChipSnapshot& snapshot, std::span<const MapChipTileChange> changes);
+
+	/// <summary>
+	/// Build・Update のたびに増える番号。参照する側はこれが変わったらノード・リンクの番号を引き直す
+	/// </summary>
+	uint32_t GetVersion() const { return version_; }
+
+	/// <summary>
+	/// 全ノード。Update で消えた区間の番号は空き（yIndex が kMapChipNavNone）になり、後で使い回す
+	/// </summary>
+	std::span<const MapChipNavNode> GetNodes() const { return nodes_; }
+	const MapChipNavNode& GetNode(uint32_t node) const { return nodes_[node]; }
+
+	/// <summary>
+	/// ノードから出るリンク
+	/// </summary>
+	std::span<const MapChipNavLink> GetLinks(uint32_t node) const {
+		return std::span<const MapChipNavLink>(links_).subspan(linkRanges_[node].offset, linkRanges_[node].count);
+	}
+	const MapChipNavLink& GetLink(uint32_t link) const { return links_[link]; }
+
+	/// <summary>
+	/// ノードに入るリンクの番号（MapChipNavFlowField が目的地から逆にたどるのに使う）
+	/// </summary>
+	std::span<const uint32_t> GetIncomingLinks(uint32_t node) const {
+		return std::span<const uint32_t>(incomingLinks_).subspan(incomingRanges_[node].offset, incomingRanges_[node].count);
+	}
+
+	/// <summary>
+	/// タイル (x, y) を含む区間（行内の二分探索）
+	/// </summary>
+	/// <returns>立てるタイルでなければ kMapChipNavNone</returns>
+	uint32_t FindNode(uint32_t xIndex, uint32_t yIndex) const;
+
+	/// <summary>
+	/// 指定座標の真下で最初に着地する区間（空中にいる間も、着地する先の区間を返す）
+	/// </summary>
+	/// <returns>下に立てる場所がなければ kMapChipNavNone</returns>
+	uint32_t FindNodeBelow(const MapChipSnapshot& snapshot, const KamataEngine::Vector3& position) const;
+
+private:
+	// links_・incomingLinks_ の中の範囲
+	struct Range {
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	std::vector<MapChipNavNode> nodes_;
+	std::vector<uint32_t> freeNodes_;
+	// 行 y の区間の番号（x0 の昇順）
+	std::vector<std::vector<uint32_t>> rowNodes_;
+
+	// ノード n から出るリンクは links_ の linkRanges_[n]、入るリンクの番号は incomingLinks_ の incomingRanges_[n]
+	// Update では求め直した分を末尾に足して範囲を差し替えるので、前の範囲は使われなくなる（多くなったら Build で詰め直す）
+	std::vector<MapChipNavLink> links_;
+	std::vector<Range> linkRanges_;
+	std::vector<uint32_t> incomingLinks_;
+	std::vector<Range> incomingRanges_;
+	size_t unusedLinks_ = 0;
+	size_t unusedIncomingLinks_ = 0;
+
+	uint32_t width_ = 0;
+	uint32_t version_ = 0;
+
+	// Update の作業用（容量を使い回す）
+	std::vector<MapChipNavNode> scannedNodes_;
+	std::vector<uint32_t> rowScratch_;
+	std::vector<uint32_t> dirtyNodes_;
+	std::vector<uint32_t> affectedNodes_;
+	std::vector<uint32_t> addedLinks_;
+	// ScanRow でビットプレーンの行を作る作業用（ビットプレーンを持たない格納方式のとき）
+	std::array<std::vector<uint64_t>, 4> planeRowScratch_;
+
+	void BuildLinks(const MapChipSnapshot& snapshot);
+
+	/// <summary>
+	/// 行 y の区間を out の末尾に足す
+	/// </summary>
+	void ScanRow(const MapChipSnapshot& snapshot, uint32_t y, std::vector<MapChipNavNode>& out);
+
+	/// <summary>
+	/// 行 y の区間のうち、x0 ～ x1 に掛かるものの番号を out に足す
+	/// </summary>
+	void CollectNodesInRow(uint32_t y, int64_t x0, int64_t x1, std::vector<uint32_t>& out) const;
+
+	/// <summary>
+	/// 新しいノード番号（空きがあれば使い回す）
+	/// </summary>
+	uint32_t AllocateNode(const MapChipNavNode& node);
+
+	/// <summary>
+	/// ノードから出るリンクを求めて links_ の末尾に足し、範囲を差し替える
+	/// </summary>
+	void AddLinks(const MapChipSnapshot& snapshot, uint32_t node);
+	void AddDropLink(const MapChipSnapshot& snapshot, uint32_t node, uint32_t edgeX, int32_t step);
+	void AddJumpLinks(const MapChipSnapshot& snapshot, uint32_t node);
+};
+
+/// <summary>
+/// 1 つの目的地へ向かう、全ノードの次のリンク（目的地から逆向きに Dijkstra で求める）
+/// 目的地のノードとグラフが前回と同じなら計算し直さないので、毎フレーム Update を呼んでよい
+/// 同じ目的地を追う敵はすべて 1 つの MapChipNavFlowField を共有し、自分のノードの次のリンクを引くだけで済む
+/// </summary>
+class MapChipNavFlowField {
+public:
+	// 既定の探索範囲（コスト）。これより遠いノードは到達できないものとして扱う
+	static inline const uint32_t kDefaultMaxCost = 64;
+
+	/// <summary>
+	/// 目的地を設定する。ノードかグラフが変わったときだけ探索し直す
+	/// </summary>
+	/// <param name="targetNode">目的地の区間（kMapChipNavNone なら前回の目的地のまま）</param>
+	/// <param name="targetXIndex">目的地の区間の中で向かうタイル</param>
+	void Update(const MapChipNavGraph& graph, uint32_t targetNode, uint32_t targetXIndex);
+
+	void SetMaxCost(uint32_t maxCost) { maxCost_ = maxCost; }
+
+	uint32_t GetTargetNode() const { return targetNode_; }
+	uint32_t GetTargetXIndex() const { return targetXIndex_; }
+
+	/// <summary>
+	/// 目的地までのコスト（届かなければ kMapChipNavNone）
+	/// </summary>
+	uint32_t GetCost(uint32_t node) const { return node < cost_.size() ? cost_[node] : kMapChipNavNone; }
+
+	/// <summary>
+	/// 目的地へ向かうために次に使うリンクの番号（目的地のノード自身と、届かないノードは kMapChipNavNone）
+	/// </summary>
+	uint32_t GetNextLink(uint32_t node) const { return node < nextLink_.size() ? nextLink_[node] : kMapChipNavNone; }
+
+	/// <summary>
+	/// 探索し直した回数（計測用）
+	/// </summary>
+	uint32_t GetRebuildCount() const { return rebuildCount_; }
+
+private:
+	struct QueueEntry {
+		uint32_t cost;
+		uint32_t node;
+	};
+
+	std::vector<uint32_t> cost_;
+	std::vector<uint32_t> nextLink_;
+	// 探索の優先度付きキュー（容量を使い回す）
+	std::vector<QueueEntry> queue_;
+	// 前回の探索で値を入れたノード（次の探索ではここだけを戻す）
+	std::vector<uint32_t> reached_;
+
+	uint32_t targetNode_ = kMapChipNavNone;
+	uint32_t targetXIndex_ = 0;
+	uint32_t graphVersion_ = 0;
+	uint32_t maxCost_ = kDefaultMaxCost;
+	uint32_t rebuildCount_ = 0;
+	const MapChipNavGraph* graph_ = nullptr;
+
+	void Rebuild(const MapChipNavGraph& graph);
+};
@@ -0,0 +1,359 @@
+#include "MapChipSnapshot.h"
+
+#include "MapChipFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace KamataEngine;
+
+namespace {
+
+// Raycast の始点として受け付けるタイル座標の絶対値の上限（int64 に直しても溢れないように）
+constexpr float kRaycastMaxOriginCell = 1.0e12f;
+
+} // namespace
+
+std::shared_ptr<MapChipSnapshot> MapChipSnapshot::CreateFromStage(MapChipStage& stage) {
+	// ブロック数を CSV に合わせて設定
+	auto snapshot = std::make_shared<MapChipSnapshot>();
+	snapshot->SetNumBlockHorizontal(stage.collision.width);
+	snapshot->SetNumBlockVertical(stage.collision.height);
+	snapshot->AssignTiles(std::move(stage.collision.tiles));
+	for (MapChipLayerGrid& layer : stage.layers) {
+		snapshot->AddLayer(std::move(layer.name), layer.tiles.data());
+	}
+	snapshot->RebuildDerivedData();
+	return snapshot;
+}
+
+MapChipSnapshotMemory MapChipSnapshot::GetMemoryUsage() const {
+	MapChipSnapshotMemory memory = {};
+	memory.tiles = tiles_.GetMemoryBytes();
+	memory.bitPlanes = planes_.GetPlaneBytes();
+	memory.distanceFields = planes_.GetDistanceFieldBytes();
+	memory.layers = layers_.capacity() * sizeof(MapChipLayer);
+	for (const MapChipLayer& layer : layers_) {
+		memory.layers += layer.name.capacity() + layer.tiles.GetMemoryBytes();
+	}
+	memory.spawnIndex = sizeof(spawnTiles_);
+	for (const std::vector<IndexSet>& tiles : spawnTiles_) {
+		memory.spawnIndex += tiles.capacity() * sizeof(IndexSet);
+	}
+	return memory;
+}
+
+void MapChipSnapshot::ResetTiles() {
+	tiles_.Reset(numBlockHorizontal_, numBlockVertical_);
+	RebuildDerivedData();
+}
+
+void MapChipSnapshot::RebuildDerivedData() {
+	if constexpr (kMapChipStoreBitPlanes) {
+		planes_.Build(tiles_, numBlockHorizontal_, numBlockVertical_);
+	}
+	RebuildSpawnIndex();
+}
+
+void MapChipSnapshot::AssignTiles(const MapChipType* rowMajorTiles) { tiles_.Assign(rowMajorTiles, numBlockHorizontal_, numBlockVertical_); }
+
+void MapChipSnapshot::AssignTiles(std::vector<MapChipType>&& rowMajorTiles) { tiles_.Assign(std::move(rowMajorTiles), numBlockHorizontal_, numBlockVertical_); }
+
+void MapChipSnapshot::AddLayer(std::string name, const MapChipType* rowMajorTiles) {
+	MapChipLayer& layer = layers_.emplace_back();
+	layer.name = std::move(name);
+	layer.tiles.Assign(rowMajorTiles, numBlockHorizontal_, numBlockVertical_);
+}
+
+const MapChipLayer* MapChipSnapshot::FindLayer(std::string_view name) const {
+	for (const MapChipLayer& layer : layers_) {
+		if (layer.name == name) {
+			return &layer;
+		}
+	}
+	return nullptr;
+}
+
+std::span<const uint64_t> MapChipSnapshot::BuildPlaneWords(MapChipPlane plane, uint32_t yIndex, std::vector<uint64_t>& buffer) const {
+	const uint32_t planeMask = MapChipPlaneMask(plane);
+	buffer.assign((numBlockHorizontal_ + 63) / 64, 0);
+	tiles_.ForEachRun(yIndex, [&](uint32_t first, uint32_t count, MapChipType type) {
+		if (GetMapChipPlaneMask(type) & planeMask) {
+			SetMapChipPlaneBits(buffer.data(), first, count);
+		}
+	});
+	return buffer;
+}
+
+uint8_t MapChipSnapshot::ScanColumnDistance(MapChipPlane plane, uint32_t xIndex, uint32_t yIndex, int32_t step) const {
+	const uint32_t planeMask = MapChipPlaneMask(plane);
+	int64_t y = yIndex;
+	for (uint32_t distance = 0; distance < kMapChipDistanceNone; ++distance, y += step) {
+		if (y < 0 || y >= numBlockVertical_) {
+			break;
+		}
+		if (GetMapChipPlaneMask(tiles_.Get(xIndex, static_cast<uint32_t>(y))) & planeMask) {
+			return static_cast<uint8_t>(distance);
+		}
+	}
+	return kMapChipDistanceNone;
+}
+
+bool MapChipSnapshot::FindGroundBelow(const Vector3& position, float& groundY) const {
+	// GetMapChipIndexSetByPosition と同じ計算を符号付きで行う
+	int64_t x = static_cast<int64_t>(std::floor((position.x + kBlockWidth * 0.5f) / kBlockWidth));
+	int64_t row = static_cast<int64_t>(std::floor((position.y + kBlockHeight * 0.5f) / kBlockHeight));
+	if (x < 0 || x >= numBlockHorizontal_ || row < 0) {
+		return false;
+	}
+	// マップより上にいる場合は最上段から数える
+	int64_t y = std::max<int64_t>(static_cast<int64_t>(numBlockVertical_) - 1 - row, 0);
+
+	uint8_t distance = GetGroundDistance(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+	if (distance == kMapChipDistanceNone) {
+		return false;
+	}
+	uint32_t groundIndex = static_cast<uint32_t>(y) + distance;
+	groundY = kBlockHeight * (numBlockVertical_ - 1 - groundIndex) + kBlockHeight * 0.5f;
+	return true;
+}
+
+void MapChipSnapshot::RebuildSpawnIndex() {
+	// 当たり判定レイヤーに加えて entities レイヤーからも集める
+	const MapChipLayer* entities = FindLayer(kMapChipEntityLayerName);
+
+	// 1 パス目で種別ごとの個数を数えて確保し、2 パス目で座標を詰める
+	std::array<uint32_t, kMapChipTypeCount> counts = {};
+	auto countRuns = [&](const auto& store) {
+		for (uint32_t y = 0; y < numBlockVertical_; ++y) {
+			store.ForEachRun(y, [&](uint32_t, uint32_t count, MapChipType type) { counts[static_cast<uint8_t>(type)] += count; });
+		}
+	};
+	countRuns(tiles_);
+	if (entities) {
+		countRuns(entities->tiles);
+	}
+
+	std::array<bool, kMapChipTypeCount> spawnable;
+	for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+		spawnable[i] = GetMapChipProperty(static_cast<MapChipType>(i)).spawnKind != MapChipSpawnKind::kNone;
+		spawnTiles_[i].clear();
+		spawnTiles_[i].reserve(spawnable[i] ? counts[i] : 0);
+	}
+
+	auto fillRuns = [&](const auto& store) {
+		for (uint32_t y = 0; y < numBlockVertical_; ++y) {
+			store.ForEachRun(y, [&](uint32_t first, uint32_t count, MapChipType type) {
+				uint8_t t = static_cast<uint8_t>(type);
+				// 生成対象でない種別は区間ごと飛ばす
+				if (!spawnable[t]) {
+					return;
+				}
+				for (uint32_t x = first; x < first + count; ++x) {
+					spawnTiles_[t].push_back({x, y});
+				}
+			});
+		}
+	};
+	fillRuns(tiles_);
+	if (entities) {
+		fillRuns(entities->tiles);
+		// 2 つのレイヤーの分を種別ごとに行優先の出現順へ並べ直す（UpdateSpawnIndexAt の二分探索のため）
+		auto rowMajorLess = [](const IndexSet& a, const IndexSet& b) { return a.yIndex != b.yIndex ? a.yIndex < b.yIndex : a.xIndex < b.xIndex; };
+		for (std::vector<IndexSet>& tiles : spawnTiles_) {
+			std::sort(tiles.begin(), tiles.end(), rowMajorLess);
+		}
+	}
+}
+
+void MapChipSnapshot::UpdateSpawnIndexAt(uint32_t xIndex, uint32_t yIndex, MapChipType before, MapChipType after) {
+	// 各種別の配列は行優先の出現順に並んでいるので、二分探索で位置を決める
+	auto rowMajorLess = [](const IndexSet& a, const IndexSet& b) { return a.yIndex != b.yIndex ? a.yIndex < b.yIndex : a.xIndex < b.xIndex; };
+	const IndexSet index = {xIndex, yIndex};
+
+	if (GetMapChipProperty(before).spawnKind != MapChipSpawnKind::kNone) {
+		std::vector<IndexSet>& tiles = spawnTiles_[static_cast<uint8_t>(before)];
+		auto it = std::lower_bound(tiles.begin(), tiles.end(), index, rowMajorLess);
+		assert(it != tiles.end() && it->xIndex == xIndex && it->yIndex == yIndex);
+		tiles.erase(it);
+	}
+
+	if (GetMapChipProperty(after).spawnKind != MapChipSpawnKind::kNone) {
+		std::vector<IndexSet>& tiles = spawnTiles_[static_cast<uint8_t>(after)];
+		tiles.insert(std::lower_bound(tiles.begin(), tiles.end(), index, rowMajorLess), index);
+	}
+}
+
+MapChipType MapChipSnapshot::ReplaceTile(uint32_t xIndex, uint32_t yIndex, MapChipType type) {
+	MapChipType before = tiles_.Get(xIndex, yIndex);
+	tiles_.Set(xIndex, yIndex, type);
+
+	if constexpr (kMapChipStoreBitPlanes) {
+		planes_.Update(xIndex, yIndex, type);
+	}
+	UpdateSpawnIndexAt(xIndex, yIndex, before, type);
+	return before;
+}
+
+bool MapChipSnapshot::AnyInRect(MapChipPlane plane, int32_t x0, int32_t y0, int32_t x1, int32_t y1) const {
+	if (y0 < 0) {
+		y0 = 0;
+	}
+	if (y1 >= static_cast<int32_t>(numBlockVertical_)) {
+		y1 = static_cast<int32_t>(numBlockVertical_) - 1;
+	}
+	for (int32_t y = y0; y <= y1; ++y) {
+		if (AnyInRowSpan(plane, x0, x1, y)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool MapChipSnapshot::Raycast(const Vector3& origin, const Vector3& direction, float maxDistance, uint32_t planeMask, MapChipRaycastHit& hit) const {
+	hit = {};
+	// 長さ 0・NaN・無限大の向きでは進む量が 0 になり、走査が終わらなくなるので先に弾く
+	float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+	if (!std::isfinite(length) || length == 0.0f || !std::isfinite(origin.x) || !std::isfinite(origin.y) || !(maxDistance >= 0.0f) || tiles_.IsEmpty()) {
+		return false;
+	}
+	const float dirX = direction.x / length;
+	const float dirY = direction.y / length;
+
+	// 横は x、縦は下から数えた行 row で走査し、タイルを調べるときに yIndex = 高さ - 1 - row へ直す
+	// タイル x はワールド座標で [kBlockWidth * (x - 0.5), kBlockWidth * (x + 0.5)) を占める（縦も同様）
+	const int64_t width = numBlockHorizontal_;
+	const int64_t height = numBlockVertical_;
+	const float originX = std::floor((origin.x + kBlockWidth * 0.5f) / kBlockWidth);
+	const float originRow = std::floor((origin.y + kBlockHeight * 0.5f) / kBlockHeight);
+	if (std::fabs(originX) > kRaycastMaxOriginCell || std::fabs(originRow) > kRaycastMaxOriginCell) {
+		return false;
+	}
+	int64_t x = static_cast<int64_t>(originX);
+	int64_t row = static_cast<int64_t>(originRow);
+
+	// 1 ステップで必ず x か row のどちらかが 1 つ進むので、マップまでの距離 + 幅 + 高さで必ずマップを抜ける
+	// 浮動小数の誤差で境界の判定がずれても、これより多くは回らない
+	const int64_t distanceX = x < 0 ? -x : (x >= width ? x - width + 1 : 0);
+	const int64_t distanceRow = row < 0 ? -row : (row >= height ? row - height + 1 : 0);
+	const int64_t maxSteps = distanceX + distanceRow + width + height + 2;
+
+	const float inf = std::numeric_limits<float>::infinity();
+	const int64_t stepX = dirX > 0.0f ? 1 : (dirX < 0.0f ? -1 : 0);
+	const int64_t stepRow = dirY > 0.0f ? 1 : (dirY < 0.0f ? -1 : 0);
+
+	// 次の縦・横の境界までの距離と、境界 1 つ分進むのにかかる距離
+	const float deltaX = stepX != 0 ? kBlockWidth / std::fabs(dirX) : inf;
+	const float deltaRow = stepRow != 0 ? kBlockHeight / std::fabs(dirY) : inf;
+	float nextX = stepX != 0 ? ((static_cast<float>(x) + (stepX > 0 ? 0.5f : -0.5f)) * kBlockWidth - origin.x) / dirX : inf;
+	float nextRow = stepRow != 0 ? ((static_cast<float>(row) + (stepRow > 0 ? 0.5f : -0.5f)) * kBlockHeight - origin.y) / dirY : inf;
+
+	float t = 0.0f;
+	Vector3 normal = {0.0f, 0.0f, 0.0f};
+	for (int64_t steps = 0; steps <= maxSteps; ++steps) {
+		if (x >= 0 && x < width && row >= 0 && row < height) {
+			uint32_t xIndex = static_cast<uint32_t>(x);
+			uint32_t yIndex = static_cast<uint32_t>(height - 1 - row);
+			if (TestPlaneMaskUnchecked(planeMask, xIndex, yIndex)) {
+				hit.hit = true;
+				hit.index = {xIndex, yIndex};
+				hit.point = {origin.x + dirX * t, origin.y + dirY * t, origin.z};
+				hit.normal = normal;
+				hit.distance = t;
+				return true;
+			}
+		} else if ((x < 0 && stepX <= 0) || (x >= width && stepX >= 0) || (row < 0 && stepRow <= 0) || (row >= height && stepRow >= 0)) {
+			// マップ外で、これ以上マップへ近づかない
+			return false;
+		}
+
+		if (nextX < nextRow) {
+			t = nextX;
+			nextX += deltaX;
+			x += stepX;
+			normal = {static_cast<float>(-stepX), 0.0f, 0.0f};
+		} else {
+			t = nextRow;
+			nextRow += deltaRow;
+			row += stepRow;
+			normal = {0.0f, static_cast<float>(-stepRow), 0.0f};
+		}
+		if (t > maxDistance) {
+			return false;
+		}
+	}
+	return false;
+}
+
+uint32_t MapChipSnapshot::RaycastBatch(std::span<const MapChipRay> rays, uint32_t planeMask, std::span<MapChipRaycastHit> hits) const {
+	assert(hits.size() >= rays.size());
+	uint32_t hitCount = 0;
+	for (size_t i = 0; i < rays.size(); ++i) {
+		if (Raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance, planeMask, hits[i])) {
+			++hitCount;
+		}
+	}
+	return hitCount;
+}
+
+MapChipTileRange MapChipSnapshot::GetTileRangeInAABB(const AABB& aabb) const {
+	// GetMapChipIndexSetByPosition と同じ計算を浮動小数のまま行い、int32 へ変換する前にクリップする
+	// 縦は下から数えた行で求めてから、上の行が 0 になるよう反転する
+	const float lastX = static_cast<float>(numBlockHorizontal_) - 1.0f;
+	const float lastRow = static_cast<float>(numBlockVertical_) - 1.0f;
+	float x0 = std::floor((aabb.min.x + kBlockWidth * 0.5f) / kBlockWidth);
+	float x1 = std::floor((aabb.max.x + kBlockWidth * 0.5f) / kBlockWidth);
+	float rowBottom = std::floor((aabb.min.y + kBlockHeight * 0.5f) / kBlockHeight);
+	float rowTop = std::floor((aabb.max.y + kBlockHeight * 0.5f) / kBlockHeight);
+
+	// はみ出した側は「空になる」値で止める（下限側は最大 + 1、上限側は -1）
+	x0 = std::clamp(x0, 0.0f, lastX + 1.0f);
+	x1 = std::clamp(x1, -1.0f, lastX);
+	rowBottom = std::clamp(rowBottom, 0.0f, lastRow + 1.0f);
+	rowTop = std::clamp(rowTop, -1.0f, lastRow);
+
+	MapChipTileRange range;
+	range.x0 = static_cast<int32_t>(x0);
+	range.x1 = static_cast<int32_t>(x1);
+	range.y0 = static_cast<int32_t>(lastRow - rowTop);
+	range.y1 = static_cast<int32_t>(lastRow - rowBottom);
+	return range;
+}
+
+Vector3 MapChipSnapshot::GetMapChipPositionByIndex(uint32_t xIndex, uint32_t yIndex) const { return Vector3(kBlockWidth * xIndex, kBlockHeight * (numBlockVertical_ - 1 - yIndex), 0); }
+
+IndexSet MapChipSnapshot::GetMapChipIndexSetByPosition(const KamataEngine::Vector3& position) const {
+	IndexSet indexSet = {};
+
+	indexSet.xIndex = static_cast<uint32_t>(std::floor((position.x + kBlockWidth * 0.5f) / kBlockWidth));
+
+	// 画像のロジックに従って Y インデックスを計算
+	float preFlipYIndexFloat = (position.y + kBlockHeight * 0.5f) / kBlockHeight;
+	uint32_t preFlipYIndex = static_cast<uint32_t>(std::floor(preFlipYIndexFloat));
+	indexSet.yIndex = numBlockVertical_ - 1 - preFlipYIndex;
+
+	return indexSet;
+}
+
+Rects MapChipSnapshot::GetRectByIndex(uint32_t xIndex, uint32_t yIndex) const {
+
+	Vector3 center = GetMapChipPositionByIndex(xIndex, yIndex);
+
+	Rects rect = {};
+
+	rect.left = center.x - kBlockWidth * 0.5f;
+	rect.right = center.x + kBlockWidth * 0.5f;
+	// top は -
+	rect.top = center.y + kBlockHeight * 0.5f;
+	rect.bottom = center.y - kBlockHeight * 0.5f;
+
+	return rect;
+};
+
+float MapChipSnapshot::GetFrictionCoefficientByIndex(uint32_t xIndex, uint32_t yIndex) const { return GetMapChipProperty(GetMapChipTypeByIndex(xIndex, yIndex)).friction; }
+
+float MapChipSnapshot::GetFrictionCoefficientByPosition(const KamataEngine::Vector3& position) const {
+	IndexSet idx = GetMapChipIndexSetByPosition(position);
+	return GetFrictionCoefficientByIndex(idx.xIndex, idx.yIndex);
+}
@@ -0,0 +1,413 @@
+#pragma once
+
+#include "AABB.h"
+#include "MapChipBitPlanes.h"
+#include "MapChipTileStore.h"
+#include "MapChipType.h"
+#include "MathTypes.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+struct MapChipStage;
+
+// 書き換わったタイル 1 つ分
+struct MapChipTileChange {
+	IndexSet index;
+	MapChipType before;
+	MapChipType after;
+};
+
+// Raycast の入力（z は無視する）
+struct MapChipRay {
+	KamataEngine::Vector3 origin;
+	KamataEngine::Vector3 direction; // 正規化しなくてよい（長さ 0 なら当たらない）
+	float maxDistance;               // ワールド座標での最大距離
+};
+
+// Raycast の結果
+struct MapChipRaycastHit {
+	bool hit;
+	IndexSet index;               // 最初に当たったタイル
+	KamataEngine::Vector3 point;  // 当たった位置（タイルの境界上。始点がタイル内なら始点）
+	KamataEngine::Vector3 normal; // 当たった面の法線（始点がタイル内なら 0）
+	float distance;               // 始点から point までの距離
+};
+
+// タイル座標の閉区間 [x0, x1] x [y0, y1]（y は上の行が 0）
+struct MapChipTileRange {
+	int32_t x0;
+	int32_t y0;
+	int32_t x1;
+	int32_t y1;
+
+	bool IsEmpty() const { return x0 > x1 || y0 > y1; }
+};
+
+struct Rects {
+	float left;   // 左端
+	float right;  // 右端
+	float top;    // 下端
+	float bottom; // 上端
+};
+
+// MapChipSnapshot::GetMemoryUsage の内訳（バイト。確保済みの容量で数える）
+struct MapChipSnapshotMemory {
+	size_t tiles;          // 当たり判定レイヤーのタイル（MapChipTileStore）
+	size_t bitPlanes;      // ビットプレーン（1 タイルあたり kMapChipPlaneCount ビット。連長圧縮では持たないので 0）
+	size_t distanceFields; // 真下の ground・真上の solid までの距離場（1 タイルあたり 2 バイト。連長圧縮では 0）
+	size_t layers;         // 当たり判定以外のレイヤー
+	size_t spawnIndex;     // 生成位置の索引
+
+	size_t Total() const { return tiles + bitPlanes + distanceFields + layers + spawnIndex; }
+};
+
+/// <summary>
+/// 当たり判定以外の名前付きレイヤー（ステージファイルの "[名前]" の区間。MapChipFormat.h を参照）
+/// 大半が空白なので、当たり判定レイヤーの格納方式に関わらず連長圧縮で持つ。大きさは当たり判定レイヤーと同じ
+/// </summary>
+struct MapChipLayer {
+	std::string name;
+	MapChipRunLengthTileStore tiles;
+};
+
+/// <summary>
+/// 読み込み済みマップの読み取り専用の状態（タイル・ビットプレーン・距離場・生成位置の索引）
+/// ビットプレーンと距離場は既定の格納方式でだけ持ち、連長圧縮ではタイルのランから求める（kMapChipStoreBitPlanes）
+/// 作成後は変更されないので、std::shared_ptr<const MapChipSnapshot> を受け取った側はロックもコピーもせずに
+/// 複数スレッドから同時に問い合わせてよい。内部にキャッシュなどの可変状態は持たない
+/// 作成・書き換えは MapChipField が行う（共有中のスナップショットは書き換えず、複製してから書き換える）
+/// </summary>
+class MapChipSnapshot {
+
+public:
+	/// <summary>
+	/// 解析したステージからスナップショットを作り、派生データもすべて作る（stage のタイルは移動する）
+	/// MapChipField の読み込みと、エンジンなしで動かすツールが使う
+	/// </summary>
+	static std::shared_ptr<MapChipSnapshot> CreateFromStage(MapChipStage& stage);
+
+	/// <summary>
+	/// マップチップ種別の取得（範囲チェックあり。範囲外は kBlank）
+	/// </summary>
+	/// <param name="xIndex">横</param>
+	/// <param name="yIndex">縦</param>
+	/// <returns>マップチップに対応したモデルの描画が可能になる</returns>
+	MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) const {
+		if (xIndex >= numBlockHorizontal_ || yIndex >= numBlockVertical_) {
+			return MapChipType::kBlank;
+		}
+		return GetMapChipTypeByIndexUnchecked(xIndex, yIndex);
+	}
+
+	/// <summary>
+	/// マップチップ種別の取得（範囲チェックなし）
+	/// 呼び出し側でインデックスが範囲内であることを保証すること
+	/// </summary>
+	MapChipType GetMapChipTypeByIndexUnchecked(uint32_t xIndex, uint32_t yIndex) const {
+		assert(xIndex < numBlockHorizontal_ && yIndex < numBlockVertical_);
+		return tiles_.Get(xIndex, yIndex);
+	}
+
+	/// <summary>
+	/// 指定タイルがビットプレーンに含まれるか（範囲外は false）
+	/// </summary>
+	bool TestPlane(MapChipPlane plane, uint32_t xIndex, uint32_t yIndex) const {
+		if (xIndex >= numBlockHorizontal_ || yIndex >= numBlockVertical_) {
+			return false;
+		}
+		return TestPlaneMaskUnchecked(MapChipPlaneMask(plane), xIndex, yIndex);
+	}
+
+	/// <summary>
+	/// 行 y のタイル範囲 [x0, x1] にビットプレーンのタイルが 1 つでもあるか
+	/// 範囲はマップ内にクリップする（負の値も可）。64 タイル単位のワード演算で判定する（連長圧縮ではランごとに判定する）
+	/// </summary>
+	bool AnyInRowSpan(MapChipPlane plane, int32_t x0, int32_t x1, int32_t y) const {
+		if (y < 0 || static_cast<uint32_t>(y) >= numBlockVertical_) {
+			return false;
+		}
+		uint32_t first = static_cast<uint32_t>(x0 < 0 ? 0 : x0);
+		if (x1 < 0 || first > static_cast<uint32_t>(x1)) {
+			return false;
+		}
+		uint32_t last = static_cast<uint32_t>(x1) < numBlockHorizontal_ ? static_cast<uint32_t>(x1) : numBlockHorizontal_ - 1;
+		if (first > last) {
+			return false;
+		}
+
+		if constexpr (kMapChipStoreBitPlanes) {
+			return planes_.AnyInRowSpan(plane, first, last, static_cast<uint32_t>(y));
+		} else {
+			return tiles_.AnyTypeInSpan(static_cast<uint32_t>(y), first, last, GetMapChipTypeMaskOfPlanes(MapChipPlaneMask(plane)));
+		}
+	}
+
+	/// <summary>
+	/// 行 y のビットプレーン（64 タイルずつのワード。タイル x は [x / 64] の bit (x % 64)、幅より右のビットは 0）
+	/// 行全体をワード単位でまとめて処理したいとき用（範囲チェックなし）
+	/// ビットプレーンを持つときはその行を直接返し、連長圧縮ではタイルのランから buffer に作って返す
+	/// </summary>
+	std::span<const uint64_t> GetPlaneWords(MapChipPlane plane, uint32_t yIndex, std::vector<uint64_t>& buffer) const {
+		assert(yIndex < numBlockVertical_);
+		if constexpr (kMapChipStoreBitPlanes) {
+			return planes_.GetRowWords(plane, yIndex);
+		} else {
+			return BuildPlaneWords(plane, yIndex, buffer);
+		}
+	}
+
+	/// <summary>
+	/// タイル矩形 [x0, x1] x [y0, y1] にビットプレーンのタイルが 1 つでもあるか（マップ内にクリップ）
+	/// </summary>
+	bool AnyInRect(MapChipPlane plane, int32_t x0, int32_t y0, int32_t x1, int32_t y1) const;
+
+	/// <summary>
+	/// 線分上で最初にビットプレーンのタイルへ入る位置を求める
+	/// 通過するタイルを DDA (Amanatides–Woo) で順に調べるので、すり抜けも取りこぼしもない
+	/// 始点はマップ外でもよい
+	/// </summary>
+	/// <param name="origin">始点（ワールド座標）</param>
+	/// <param name="direction">向き</param>
+	/// <param name="maxDistance">調べる最大距離</param>
+	/// <param name="planeMask">対象のビットプレーン（MapChipPlaneMask の組み合わせ）</param>
+	/// <param name="hit">結果（当たらなければ hit.hit が false）</param>
+	/// <returns>当たったら true</returns>
+	bool Raycast(const KamataEngine::Vector3& origin, const KamataEngine::Vector3& direction, float maxDistance, uint32_t planeMask, MapChipRaycastHit& hit) const;
+
+	/// <summary>
+	/// 複数のレイをまとめて調べる。hits[i] に rays[i] の結果を書く
+	/// </summary>
+	/// <returns>当たったレイの数</returns>
+	uint32_t RaycastBatch(std::span<const MapChipRay> rays, uint32_t planeMask, std::span<MapChipRaycastHit> hits) const;
+
+	/// <summary>
+	/// 指定タイルから真下へ数えて最初の ground タイルまでのタイル数（読み込み時に作成した距離場を引く。連長圧縮では列を下へたどる）
+	/// 0 ならそのタイル自体が ground、1 ならすぐ下が ground
+	/// 255 タイル以上離れている、下に ground がない、範囲外のときは kMapChipDistanceNone
+	/// </summary>
+	uint8_t GetGroundDistance(uint32_t xIndex, uint32_t yIndex) const {
+		if (xIndex >= numBlockHorizontal_ || yIndex >= numBlockVertical_) {
+			return kMapChipDistanceNone;
+		}
+		if constexpr (kMapChipStoreBitPlanes) {
+			return planes_.GetGroundDistance(xIndex, yIndex);
+		} else {
+			return ScanColumnDistance(MapChipPlane::kGround, xIndex, yIndex, 1);
+		}
+	}
+
+	/// <summary>
+	/// 指定タイルから真上へ数えて最初の solid タイルまでのタイル数（値の意味は GetGroundDistance と同じ）
+	/// </summary>
+	uint8_t GetCeilingDistance(uint32_t xIndex, uint32_t yIndex) const {
+		if (xIndex >= numBlockHorizontal_ || yIndex >= numBlockVertical_) {
+			return kMapChipDistanceNone;
+		}
+		if constexpr (kMapChipStoreBitPlanes) {
+			return planes_.GetCeilingDistance(xIndex, yIndex);
+		} else {
+			return ScanColumnDistance(MapChipPlane::kSolid, xIndex, yIndex, -1);
+		}
+	}
+
+	/// <summary>
+	/// 指定座標の真下（その座標を含むタイルから下）にある最初の ground タイルの天面の高さ
+	/// </summary>
+	/// <param name="groundY">天面のワールド座標 y</param>
+	/// <returns>距離場の範囲内に ground がなければ false</returns>
+	bool FindGroundBelow(const KamataEngine::Vector3& position, float& groundY) const;
+
+	/// <summary>
+	/// AABB と重なるタイルの範囲（境界に接するタイルも含む）。マップ内にクリップし、重ならなければ空
+	/// GetMapChipIndexSetByPosition と違い、マップの外にはみ出しても添字が折り返さない
+	/// </summary>
+	MapChipTileRange GetTileRangeInAABB(const AABB& aabb) const;
+
+	/// <summary>
+	/// AABB と重なるタイルのうち、種別が typeMask に含まれるものを行優先で列挙する
+	/// 範囲のクリップは最初に 1 回だけ行うので、fn には常にマップ内の添字が渡る
+	/// </summary>
+	/// <param name="typeMask">MapChipTypeMask / MapChipTypeMaskOf の組み合わせ</param>
+	/// <param name="fn">void(IndexSet, MapChipType) か bool(IndexSet, MapChipType)。bool 版は true を返すとそこで打ち切る</param>
+	/// <returns>fn が true を返して打ち切ったら true</returns>
+	template <typename Fn> bool ForEachTileInAABB(const AABB& aabb, uint32_t typeMask, Fn&& fn) const {
+		MapChipTileRange range = GetTileRangeInAABB(aabb);
+		for (int32_t y = range.y0; y <= range.y1; ++y) {
+			for (int32_t x = range.x0; x <= range.x1; ++x) {
+				IndexSet index = {static_cast<uint32_t>(x), static_cast<uint32_t>(y)};
+				MapChipType type = GetMapChipTypeByIndexUnchecked(index.xIndex, index.yIndex);
+				if (!((typeMask >> static_cast<uint8_t>(type)) & 1)) {
+					continue;
+				}
+				if constexpr (std::is_same_v<std::invoke_result_t<Fn&, IndexSet, MapChipType>, bool>) {
+					if (fn(index, type)) {
+						return true;
+					}
+				} else {
+					fn(index, type);
+				}
+			}
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// 当たり判定以外のレイヤー（ファイルに書かれた順）
+	/// ビットプレーン・距離場は当たり判定レイヤーだけから作るので、ここのタイルは当たり判定に影響しない
+	/// </summary>
+	std::span<const MapChipLayer> GetLayers() const { return layers_; }
+
+	/// <summary>
+	/// 名前でレイヤーを探す（kMapChipEntityLayerName など）
+	/// </summary>
+	/// <returns>なければ nullptr</returns>
+	const MapChipLayer* FindLayer(std::string_view name) const;
+
+	/// <summary>
+	/// 指定種別のタイル座標の一覧（行優先の出現順）
+	/// 生成対象 (MapChipProperty::spawnKind が kNone 以外) の種別のみ記録し、それ以外は空を返す
+	/// 当たり判定レイヤーと entities レイヤーの両方から集める
+	/// </summary>
+	std::span<const IndexSet> GetSpawnTiles(MapChipType type) const { return spawnTiles_[static_cast<uint8_t>(type)]; }
+
+	/// <summary>
+	/// マップチップ座標の取得
+	/// </summary>
+	/// <param name="Index">横</param>
+	/// <param name="yIndex">縦</param>
+	/// <returns>マップチップのワールド座標を取得する関数</returns>
+	KamataEngine::Vector3 GetMapChipPositionByIndex(uint32_t Index, uint32_t yIndex) const;
+
+	/// <summary>
+	/// 座標からマップチップ番号を計算
+	/// </summary>
+	/// <param name="position">座標指定</param>
+	/// <returns></returns>
+	IndexSet GetMapChipIndexSetByPosition(const KamataEngine::Vector3& position) const;
+
+	Rects GetRectByIndex(uint32_t xIndex, uint32_t yIndex) const;
+
+	/// <summary>
+	/// 指定インデックスに対応する摩擦係数を取得する
+	/// 返り値は 0.0f (滑りやすい/氷) から 1.0f (摩擦が高い/普通のブロック) を想定
+	/// </summary>
+	float GetFrictionCoefficientByIndex(uint32_t xIndex, uint32_t yIndex) const;
+
+	/// <summary>
+	/// 指定ワールド座標の下にあるマップチップの摩擦係数を取得する
+	/// </summary>
+	float GetFrictionCoefficientByPosition(const KamataEngine::Vector3& position) const;
+
+	/// <summary>
+	/// スナップショット全体のメモリの内訳（Tools/MapChipStoreBench で格納方式を比べるときに使う）
+	/// </summary>
+	MapChipSnapshotMemory GetMemoryUsage() const;
+
+public:
+	static float GetBlockWidth() { return kBlockWidth; }
+	static float GetBlockHeight() { return kBlockHeight; }
+
+	uint32_t GetNumBlockHorizontal() const { return numBlockHorizontal_; }
+	uint32_t GetNumBlockVertical() const { return numBlockVertical_; }
+
+private:
+	friend class MapChipField;
+
+	// ブロックのサイズ
+	static inline const float kBlockWidth = kMapChipBlockWidth;
+	static inline const float kBlockHeight = kMapChipBlockHeight;
+
+	// ブロック数はインスタンスメンバにして CSV に合わせて変更可能にする
+	uint32_t numBlockHorizontal_ = 20;
+	uint32_t numBlockVertical_ = 10;
+
+	void SetNumBlockHorizontal(uint32_t count) {
+		if (count == 0) {
+			count = 1;
+		}
+		numBlockHorizontal_ = count;
+	}
+
+	void SetNumBlockVertical(uint32_t count) {
+		if (count == 0) {
+			count = 1;
+		}
+		numBlockVertical_ = count;
+	}
+
+	// タイル種別。格納方式は MapChipTileStore で選ぶが、外から見える API はすべてタイル座標で受け渡すので方式には依存しない
+	MapChipTileStore tiles_;
+
+	/// <summary>
+	/// 現在のブロック数で全タイルを kBlank にし、派生データを作り直す
+	/// </summary>
+	void ResetTiles();
+
+	/// <summary>
+	/// 行優先のタイル配列を取り込む（ブロック数は先に設定しておく）
+	/// </summary>
+	void AssignTiles(const MapChipType* rowMajorTiles);
+	void AssignTiles(std::vector<MapChipType>&& rowMajorTiles);
+
+	std::vector<MapChipLayer> layers_;
+
+	/// <summary>
+	/// 名前付きレイヤーを追加する（行優先、ブロック数は先に設定しておく）。派生データは RebuildDerivedData で作る
+	/// </summary>
+	void AddLayer(std::string name, const MapChipType* rowMajorTiles);
+
+	// ビットプレーンと距離場。kMapChipStoreBitPlanes が false（連長圧縮）のときは作らず空のまま
+	MapChipBitPlanes planes_;
+
+	/// <summary>
+	/// 指定タイルがマスク内のいずれかのビットプレーンに含まれるか（範囲チェックなし）
+	/// </summary>
+	bool TestPlaneMaskUnchecked(uint32_t planeMask, uint32_t xIndex, uint32_t yIndex) const {
+		if constexpr (kMapChipStoreBitPlanes) {
+			return planes_.TestMask(planeMask, xIndex, yIndex);
+		} else {
+			return (GetMapChipPlaneMask(tiles_.Get(xIndex, yIndex)) & planeMask) != 0;
+		}
+	}
+
+	/// <summary>
+	/// 行 y のビットプレーンをタイルのランから buffer に作る（ビットプレーンを持たないとき用）
+	/// </summary>
+	std::span<const uint64_t> BuildPlaneWords(MapChipPlane plane, uint32_t yIndex, std::vector<uint64_t>& buffer) const;
+
+	/// <summary>
+	/// (x, y) から step (1 で下、-1 で上) の向きに列をたどり、ビットプレーンのタイルまでのタイル数を数える（距離場を持たないとき用）
+	/// 距離場と同じく 255 タイル目で打ち切って kMapChipDistanceNone を返す
+	/// </summary>
+	uint8_t ScanColumnDistance(MapChipPlane plane, uint32_t xIndex, uint32_t yIndex, int32_t step) const;
+
+	// 種別ごとの生成対象タイル（行優先の出現順）。種別ごとに別の配列なので、1 タイルの書き換えで動かすのはその種別の分だけで済む
+	std::array<std::vector<IndexSet>, kMapChipTypeCount> spawnTiles_;
+
+	/// <summary>
+	/// マップチップデータから派生データ（ビットプレーン・生成位置の索引・距離場）を作り直す
+	/// データを差し替えたら必ず呼ぶ
+	/// </summary>
+	void RebuildDerivedData();
+
+	void RebuildSpawnIndex();
+
+	/// <summary>
+	/// 1 タイル分の種別の変更を生成位置の索引へ反映する（索引の並び順は保つ。手間は前後の種別の個数分までで、他の種別には触れない）
+	/// </summary>
+	void UpdateSpawnIndexAt(uint32_t xIndex, uint32_t yIndex, MapChipType before, MapChipType after);
+
+	/// <summary>
+	/// 1 タイルの種別を書き換え、派生データはそのタイルと周辺だけを更新する（範囲と種別は呼び出し側で確認する）
+	/// </summary>
+	/// <returns>書き換える前の種別</returns>
+	MapChipType ReplaceTile(uint32_t xIndex, uint32_t yIndex, MapChipType type);
+};
\ No newline at end of file
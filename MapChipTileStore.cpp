@@ -0,0 +1,185 @@
+#include "MapChipTileStore.h"
+
+void MapChipDenseTileStore::Reset(uint32_t width, uint32_t height) {
+	width_ = width;
+	data_.assign(MapChipTileLayout::StorageSize(width, height), MapChipType::kBlank);
+}
+
+void MapChipDenseTileStore::Assign(const MapChipType* rowMajorTiles, uint32_t width, uint32_t height) {
+	width_ = width;
+	if constexpr (MapChipTileLayout::kIsRowMajor) {
+		data_.assign(rowMajorTiles, rowMajorTiles + static_cast<size_t>(width) * height);
+	} else {
+		data_.assign(MapChipTileLayout::StorageSize(width, height), MapChipType::kBlank);
+		for (uint32_t y = 0; y < height; ++y) {
+			for (uint32_t x = 0; x < width; ++x) {
+				Set(x, y, *rowMajorTiles++);
+			}
+		}
+	}
+}
+
+void MapChipDenseTileStore::Assign(std::vector<MapChipType>&& rowMajorTiles, uint32_t width, uint32_t height) {
+	if constexpr (MapChipTileLayout::kIsRowMajor) {
+		// 並べ替え不要なのでバッファごと受け取る
+		width_ = width;
+		data_ = std::move(rowMajorTiles);
+	} else {
+		Assign(rowMajorTiles.data(), width, height);
+	}
+}
+
+void MapChipRunLengthTileStore::Reset(uint32_t width, uint32_t height) {
+	width_ = width;
+	rows_.assign(height, Row{});
+	uint32_t segmentCount = ((width - 1) >> kSegmentShift) + 1;
+	for (Row& row : rows_) {
+		row.runLastTiles.assign(1, static_cast<uint8_t>((width - 1) & kSegmentMask));
+		row.runTypes.assign(1, MapChipType::kBlank);
+		row.segmentRuns.assign(segmentCount + 1, 0);
+	}
+}
+
+void MapChipRunLengthTileStore::Assign(const MapChipType* rowMajorTiles, uint32_t width, uint32_t height) {
+	width_ = width;
+	rows_.assign(height, Row{});
+	for (Row& row : rows_) {
+		EncodeRow(row, rowMajorTiles);
+		rowMajorTiles += width;
+	}
+}
+
+void MapChipRunLengthTileStore::Set(uint32_t xIndex, uint32_t yIndex, MapChipType type) {
+	Row& row = rows_[yIndex];
+	uint32_t target = FindRun(row, xIndex);
+	if (row.runTypes[target] == type) {
+		return;
+	}
+
+	// 前後のランも含めて [first, last] を並べ直す。書き換えたタイルで分割し、同じ種別が並んだら結合する
+	uint32_t first = target > 0 ? target - 1 : target;
+	uint32_t last = target + 1 < row.runTypes.size() ? target + 1 : target;
+	uint32_t begin = first > 0 ? GetRunEnd(row, first - 1) : 0;
+
+	struct Piece {
+		uint32_t end;
+		MapChipType type;
+	};
+	Piece pieces[5];
+	uint32_t count = 0;
+	auto push = [&](uint32_t end, MapChipType t) {
+		if (count > 0 && pieces[count - 1].type == t) {
+			pieces[count - 1].end = end;
+		} else {
+			pieces[count++] = {end, t};
+		}
+	};
+	uint32_t start = begin;
+	for (uint32_t i = first; i <= last; ++i) {
+		uint32_t end = GetRunEnd(row, i);
+		if (i == target) {
+			if (start < xIndex) {
+				push(xIndex, row.runTypes[i]);
+			}
+			push(xIndex + 1, type);
+			if (xIndex + 1 < end) {
+				push(end, row.runTypes[i]);
+			}
+		} else {
+			push(end, row.runTypes[i]);
+		}
+		start = end;
+	}
+
+	// 置き換え前後でランの数が変わるので、差の分だけ挿入・削除してから上書きする
+	uint32_t oldCount = last - first + 1;
+	if (count > oldCount) {
+		row.runLastTiles.insert(row.runLastTiles.begin() + first, count - oldCount, 0);
+		row.runTypes.insert(row.runTypes.begin() + first, count - oldCount, MapChipType::kBlank);
+	} else if (count < oldCount) {
+		row.runLastTiles.erase(row.runLastTiles.begin() + first, row.runLastTiles.begin() + first + (oldCount - count));
+		row.runTypes.erase(row.runTypes.begin() + first, row.runTypes.begin() + first + (oldCount - count));
+	}
+	for (uint32_t i = 0; i < count; ++i) {
+		row.runLastTiles[first + i] = static_cast<uint8_t>((pieces[i].end - 1) & kSegmentMask);
+		row.runTypes[first + i] = pieces[i].type;
+	}
+
+	// 索引は並べ直した範囲に先頭が入る区間だけ引き直し、それより右はランの数の増減分ずらす
+	uint32_t end = pieces[count - 1].end;
+	uint32_t segmentCount = static_cast<uint32_t>(row.segmentRuns.size()) - 1;
+	uint32_t piece = 0;
+	for (uint32_t s = (begin + kSegmentMask) >> kSegmentShift; s < segmentCount; ++s) {
+		uint32_t x = s << kSegmentShift;
+		if (x >= end) {
+			row.segmentRuns[s] = row.segmentRuns[s] + count - oldCount;
+			continue;
+		}
+		while (pieces[piece].end <= x) {
+			++piece;
+		}
+		row.segmentRuns[s] = first + piece;
+	}
+	row.segmentRuns[segmentCount] = static_cast<uint32_t>(row.runTypes.size() - 1);
+}
+
+size_t MapChipRunLengthTileStore::GetMemoryBytes() const {
+	size_t bytes = rows_.capacity() * sizeof(Row);
+	for (const Row& row : rows_) {
+		bytes += row.runLastTiles.capacity() * sizeof(uint8_t);
+		bytes += row.runTypes.capacity() * sizeof(MapChipType);
+		bytes += row.segmentRuns.capacity() * sizeof(uint32_t);
+	}
+	return bytes;
+}
+
+size_t MapChipRunLengthTileStore::GetRunCount() const {
+	size_t count = 0;
+	for (const Row& row : rows_) {
+		count += row.runTypes.size();
+	}
+	return count;
+}
+
+bool MapChipRunLengthTileStore::AnyTypeInSpan(uint32_t yIndex, uint32_t first, uint32_t last, uint32_t typeMask) const {
+	const Row& row = rows_[yIndex];
+	uint32_t x = first;
+	for (uint32_t run = FindRun(row, first); x <= last; ++run) {
+		if ((typeMask >> static_cast<uint8_t>(row.runTypes[run])) & 1) {
+			return true;
+		}
+		x = GetRunEnd(row, run);
+	}
+	return false;
+}
+
+uint32_t MapChipRunLengthTileStore::GetRunEnd(const Row& row, uint32_t run) {
+	// ランが属する区間は、先頭のランの番号が run 以下である最後の区間（番兵は除く）
+	auto segments = row.segmentRuns.begin();
+	uint32_t segment = static_cast<uint32_t>(std::upper_bound(segments, row.segmentRuns.end() - 1, run) - segments) - 1;
+	return (segment << kSegmentShift) + row.runLastTiles[run] + 1;
+}
+
+void MapChipRunLengthTileStore::EncodeRow(Row& row, const MapChipType* tiles) {
+	row.runLastTiles.clear();
+	row.runTypes.clear();
+	uint32_t segmentCount = ((width_ - 1) >> kSegmentShift) + 1;
+	row.segmentRuns.assign(segmentCount + 1, 0);
+
+	for (uint32_t x = 0; x < width_; ++x) {
+		// 区間の先頭のタイルを含むランは、今のラン（x が区間の先頭で新しいランが始まるならその番号）
+		bool newRun = x == 0 || tiles[x] != tiles[x - 1];
+		if (newRun && x > 0) {
+			row.runLastTiles.push_back(static_cast<uint8_t>((x - 1) & kSegmentMask));
+			row.runTypes.push_back(tiles[x - 1]);
+		}
+		if ((x & kSegmentMask) == 0) {
+			row.segmentRuns[x >> kSegmentShift] = static_cast<uint32_t>(row.runTypes.size());
+		}
+	}
+	row.runLastTiles.push_back(static_cast<uint8_t>((width_ - 1) & kSegmentMask));
+	row.runTypes.push_back(tiles[width_ - 1]);
+	row.segmentRuns[segmentCount] = static_cast<uint32_t>(row.runTypes.size() - 1);
+	row.runLastTiles.shrink_to_fit();
+	row.runTypes.shrink_to_fit();
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "MapChipLayout.h"
+#include "MapChipType.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// タイル種別の格納方式（エンジン非依存）
+// MapChipSnapshot はここで選んだ MapChipTileStore でタイルを持つ。既定は密な配列
+// ビルド時に MAPCHIP_STORE_RUN_LENGTH を定義すると、行ごとの連長圧縮になる（大半が kBlank の巨大なマップ向け）
+// 比較は Tools/MapChipStoreBench で行う
+
+/// <summary>
+/// 全タイルを MapChipTileLayout の配置の連続バッファに 1 バイトずつ持つ
+/// </summary>
+class MapChipDenseTileStore {
+public:
+	/// <summary>
+	/// 全タイルを kBlank にする
+	/// </summary>
+	void Reset(uint32_t width, uint32_t height);
+
+	/// <summary>
+	/// 行優先のタイル配列を現在の配置に並べ替えて取り込む
+	/// </summary>
+	void Assign(const MapChipType* rowMajorTiles, uint32_t width, uint32_t height);
+	void Assign(std::vector<MapChipType>&& rowMajorTiles, uint32_t width, uint32_t height);
+
+	MapChipType Get(uint32_t xIndex, uint32_t yIndex) const { return data_[MapChipTileLayout::TileOffset(xIndex, yIndex, width_)]; }
+	void Set(uint32_t xIndex, uint32_t yIndex, MapChipType type) { data_[MapChipTileLayout::TileOffset(xIndex, yIndex, width_)] = type; }
+
+	/// <summary>
+	/// 行 y を同じ種別が続く区間ごとに左から列挙する
+	/// </summary>
+	/// <param name="fn">void(uint32_t x, uint32_t count, MapChipType type)</param>
+	template <typename Fn> void ForEachRun(uint32_t yIndex, Fn&& fn) const {
+		uint32_t start = 0;
+		MapChipType type = Get(0, yIndex);
+		for (uint32_t x = 1; x < width_; ++x) {
+			MapChipType t = Get(x, yIndex);
+			if (t != type) {
+				fn(start, x - start, type);
+				start = x;
+				type = t;
+			}
+		}
+		fn(start, width_ - start, type);
+	}
+
+	/// <summary>
+	/// 行 y の [first, last] に、種別が typeMask に含まれるタイルが 1 つでもあるか（範囲チェックなし）
+	/// </summary>
+	bool AnyTypeInSpan(uint32_t yIndex, uint32_t first, uint32_t last, uint32_t typeMask) const {
+		for (uint32_t x = first; x <= last; ++x) {
+			if ((typeMask >> static_cast<uint8_t>(Get(x, yIndex))) & 1) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool IsEmpty() const { return data_.empty(); }
+
+	/// <summary>
+	/// タイルの格納に確保しているバイト数
+	/// </summary>
+	size_t GetMemoryBytes() const { return data_.capacity() * sizeof(MapChipType); }
+
+private:
+	std::vector<MapChipType> data_;
+	uint32_t width_ = 0;
+};
+
+/// <summary>
+/// 行ごとに、同じ種別が続く区間（ラン）の終わりの位置と種別だけを 1 バイトずつ持つ
+/// 行を 256 タイルの区間に分け、区間ごとにその先頭を含むランの番号を索引として持つ
+/// ランは最後のタイルを含む区間に属するので、終わりの位置は区間内のオフセット（1 バイト）で足りる
+/// 参照は索引 1 回 + 区間内の数個のランを調べるだけで済み、アクセス順や行の長さに依らない
+/// 内部に可変のキャッシュを持たないので、読み取りは複数スレッドから同時に行ってよい
+/// </summary>
+class MapChipRunLengthTileStore {
+public:
+	// 区間 1 つのタイル数は 1 << kSegmentShift（ランの終わりを 1 バイトで持つので 8）
+	static inline constexpr uint32_t kSegmentShift = 8;
+	static inline constexpr uint32_t kSegmentMask = (1u << kSegmentShift) - 1;
+
+	void Reset(uint32_t width, uint32_t height);
+
+	void Assign(const MapChipType* rowMajorTiles, uint32_t width, uint32_t height);
+	void Assign(std::vector<MapChipType>&& rowMajorTiles, uint32_t width, uint32_t height) { Assign(rowMajorTiles.data(), width, height); }
+
+	MapChipType Get(uint32_t xIndex, uint32_t yIndex) const {
+		const Row& row = rows_[yIndex];
+		return row.runTypes[FindRun(row, xIndex)];
+	}
+
+	/// <summary>
+	/// 1 タイルを書き換える。前後のランと分割・結合し、その行の索引のうち右側だけをずらす
+	/// </summary>
+	void Set(uint32_t xIndex, uint32_t yIndex, MapChipType type);
+
+	/// <summary>
+	/// 行 y の [first, last] に、種別が typeMask に含まれるタイルが 1 つでもあるか（範囲チェックなし）。ランごとに 1 回だけ調べる
+	/// </summary>
+	bool AnyTypeInSpan(uint32_t yIndex, uint32_t first, uint32_t last, uint32_t typeMask) const;
+
+	template <typename Fn> void ForEachRun(uint32_t yIndex, Fn&& fn) const {
+		const Row& row = rows_[yIndex];
+		const uint32_t runCount = static_cast<uint32_t>(row.runTypes.size());
+		uint32_t segment = 0;
+		uint32_t start = 0;
+		for (uint32_t i = 0; i < runCount; ++i) {
+			// ラン i が属する区間まで進める（最後のランは最後の区間に属する）
+			while (segment + 1 < row.segmentRuns.size() - 1 && row.segmentRuns[segment + 1] <= i) {
+				++segment;
+			}
+			uint32_t end = (segment << kSegmentShift) + row.runLastTiles[i] + 1;
+			fn(start, end - start, row.runTypes[i]);
+			start = end;
+		}
+	}
+
+	bool IsEmpty() const { return rows_.empty(); }
+
+	size_t GetMemoryBytes() const;
+
+	/// <summary>
+	/// 全行のランの数
+	/// </summary>
+	size_t GetRunCount() const;
+
+private:
+	struct Row {
+		// ラン i の最後のタイルの、属する区間の中での位置と種別
+		std::vector<uint8_t> runLastTiles;
+		std::vector<MapChipType> runTypes;
+		// segmentRuns[s] は区間 s の先頭のタイルを含むラン。区間 s に属するランは [segmentRuns[s], segmentRuns[s + 1])
+		// 最後の要素は番兵で、最後のランの番号（最後のランは探索せずに残った 1 つとして見つかる）
+		std::vector<uint32_t> segmentRuns;
+	};
+
+	static uint32_t FindRun(const Row& row, uint32_t xIndex) {
+		uint32_t segment = xIndex >> kSegmentShift;
+		assert(segment + 1 < row.segmentRuns.size());
+		const uint8_t* last = row.runLastTiles.data();
+		// 区間内で最後のタイルが x 以降の最初のラン。疎なマップでは区間内のランは数個なので、二分探索より線形に探すほうが速い
+		uint8_t local = static_cast<uint8_t>(xIndex & kSegmentMask);
+		uint32_t run = row.segmentRuns[segment];
+		uint32_t end = row.segmentRuns[segment + 1];
+		while (run < end && last[run] < local) {
+			++run;
+		}
+		return run;
+	}
+
+	/// <summary>
+	/// ラン run の終わり（最後のタイル + 1）の x
+	/// </summary>
+	static uint32_t GetRunEnd(const Row& row, uint32_t run);
+
+	void EncodeRow(Row& row, const MapChipType* tiles);
+
+	std::vector<Row> rows_;
+	uint32_t width_ = 0;
+};
+
+#ifdef MAPCHIP_STORE_RUN_LENGTH
+using MapChipTileStore = MapChipRunLengthTileStore;
+// 連長圧縮ではビットプレーンと距離場（MapChipBitPlanes）を持たず、問い合わせのたびにタイルのランから求める
+// 密なビットプレーンと距離場はタイル 1 つあたり約 2.5 バイトで、これを持つと圧縮したタイルより大きくなるため
+inline constexpr bool kMapChipStoreBitPlanes = false;
+#else
+using MapChipTileStore = MapChipDenseTileStore;
+inline constexpr bool kMapChipStoreBitPlanes = true;
+#endif
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+
+// エンジンに依存しないマップチップ種別の定義
+// （ツール側からも include できるよう KamataEngine.h は含めない）
+
+// 1 タイル 1 バイトで保持できるよう基底型を uint8_t にする
+enum class MapChipType : uint8_t {
+	kBlank = 0, // 0
+	kBlock = 1, // 1
+	kReserved2 = 2, // 2: reserved / kept open
+	kEnemySpawn = 3,       // 3: 敵 スポーン場所 (右向き)
+	kEnemySpawnShield = 4, // 4: シールド持ち敵 スポーン場所
+	kSpike = 5, //5: 棘
+	kGoal = 6,  //6: ゴール
+	kKey = 7,   //7: 鍵
+	kIce = 8,   //8: 氷ブロック（Blockと同じ挙動、モデルのみIce）
+	kLadder = 9, //9: はしご（追加）
+	kStage = 10, //10: ステージノード（SelectScene でステージ選択用）
+	kShooter = 11, //11: 弾を発射する敵（Spikeのようにマップに置く）
+	kEnemySpawnLeft = 12, //12: 敵 スポーン場所 (左向き)
+	kEnemySpawnShieldRight = 13, //13: シールド持ち敵 スポーン場所 (右向き)
+	kShooterRight = 14, //14: 右向きの Shooter 敵 スポーン場所
+};
+
+// MapChipType の種類数（CSV で有効な値は 0 ～ kMapChipTypeCount - 1）
+inline constexpr uint32_t kMapChipTypeCount = 15;
+
+// ---- タイル種別ごとの性質 ----
+// 新しい種別を追加するときは MapChipType とこの表に 1 行足すだけでよい
+
+// タイルの位置に生成するオブジェクト
+enum class MapChipSpawnKind : uint8_t {
+	kNone,
+	kPlayerStart,
+	kEnemy,
+	kShieldEnemy,
+	kShooterEnemy,
+	kSpike,
+	kGoal,
+	kKey,
+	kLadder,
+	kStage,
+};
+
+// 生成するオブジェクトの向き（kDefault はクラスの既定の向き）
+enum class MapChipFacing : uint8_t {
+	kDefault,
+	kLeft,
+	kRight,
+};
+
+// ブロックとして描画するときのモデル
+enum class MapChipModel : uint8_t {
+	kNone,
+	kBlock,
+	kIce,
+};
+
+struct MapChipProperty {
+	bool solid;     // 壁・天井として押し戻す
+	bool ground;    // 上に立てる
+	bool hazard;    // 触れるとダメージ
+	bool climbable; // 昇降できる
+	float friction; // 上に立ったときの摩擦係数 (0.0f: 滑る ～ 1.0f: 滑らない)
+	MapChipModel model;
+	MapChipSpawnKind spawnKind;
+	MapChipFacing facing;
+};
+
+// MapChipType の値で引く性質表
+inline constexpr MapChipProperty kMapChipProperties[] = {
+    // {solid, ground, hazard, climbable, friction, model, spawnKind, facing}
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kNone, MapChipFacing::kDefault},         // kBlank
+    {true, true, false, false, 0.9f, MapChipModel::kBlock, MapChipSpawnKind::kNone, MapChipFacing::kDefault},          // kBlock
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kPlayerStart, MapChipFacing::kDefault},  // kReserved2
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kEnemy, MapChipFacing::kDefault},        // kEnemySpawn
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kShieldEnemy, MapChipFacing::kDefault},  // kEnemySpawnShield
+    {false, true, true, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kSpike, MapChipFacing::kDefault},          // kSpike
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kGoal, MapChipFacing::kDefault},         // kGoal
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kKey, MapChipFacing::kDefault},          // kKey
+    {true, true, false, false, 0.05f, MapChipModel::kIce, MapChipSpawnKind::kNone, MapChipFacing::kDefault},           // kIce
+    {false, false, false, true, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kLadder, MapChipFacing::kDefault},        // kLadder
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kStage, MapChipFacing::kDefault},        // kStage
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kShooterEnemy, MapChipFacing::kDefault}, // kShooter
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kEnemy, MapChipFacing::kLeft},           // kEnemySpawnLeft
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kShieldEnemy, MapChipFacing::kRight},    // kEnemySpawnShieldRight
+    {false, false, false, false, 0.9f, MapChipModel::kNone, MapChipSpawnKind::kShooterEnemy, MapChipFacing::kRight},   // kShooterRight
+};
+
+static_assert(sizeof(kMapChipProperties) / sizeof(kMapChipProperties[0]) == kMapChipTypeCount, "kMapChipProperties needs one entry per MapChipType");
+
+/// <summary>
+/// タイル種別の性質を取得する（読み込み時に値の範囲を検証しているので添字チェックはしない）
+/// </summary>
+constexpr const MapChipProperty& GetMapChipProperty(MapChipType type) { return kMapChipProperties[static_cast<uint8_t>(type)]; }
+
+// ---- 種別マスク（bit i が MapChipType i に対応）----
+
+static_assert(kMapChipTypeCount <= 32, "MapChipType masks are 32 bits wide");
+
+inline constexpr uint32_t kMapChipTypeMaskAll = (1u << kMapChipTypeCount) - 1;
+
+constexpr uint32_t MapChipTypeMask(MapChipType type) { return 1u << static_cast<uint8_t>(type); }
+
+/// <summary>
+/// 性質表で指定のフラグが立っている種別のマスク（例: MapChipTypeMaskOf(&MapChipProperty::climbable)）
+/// </summary>
+constexpr uint32_t MapChipTypeMaskOf(bool MapChipProperty::*flag) {
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+		if (kMapChipProperties[i].*flag) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+}
+
+// ---- 当たり判定の共通定義 ----
+
+// ブロック 1 つのワールド座標での大きさ（タイル x の中心は x * kMapChipBlockWidth。縦は下の行ほど小さい）
+inline constexpr float kMapChipBlockWidth = 2.0f;
+inline constexpr float kMapChipBlockHeight = 2.0f;
+
+// 読み込み時に事前計算する当たり判定用ビットプレーンの種類
+enum class MapChipPlane : uint32_t {
+	kSolid,     // 壁・天井として押し戻す (Block, Ice)
+	kGround,    // 上に立てる (Block, Ice, Spike)
+	kHazard,    // 触れるとダメージ (Spike)
+	kClimbable, // 昇降できる (Ladder)
+	kCount,
+};
+
+inline constexpr uint32_t kMapChipPlaneCount = static_cast<uint32_t>(MapChipPlane::kCount);
+
+// ビットプレーンの組み合わせ（bit i が MapChipPlane i に対応）。複数は | で重ねる
+inline constexpr uint32_t MapChipPlaneMask(MapChipPlane plane) { return 1u << static_cast<uint32_t>(plane); }
+
+/// <summary>
+/// タイル種別が属するビットプレーンのマスク（bit i が MapChipPlane i に対応）
+/// </summary>
+inline constexpr uint32_t GetMapChipPlaneMask(MapChipType type) {
+	const MapChipProperty& property = GetMapChipProperty(type);
+	uint32_t mask = 0;
+	mask |= property.solid ? MapChipPlaneMask(MapChipPlane::kSolid) : 0u;
+	mask |= property.ground ? MapChipPlaneMask(MapChipPlane::kGround) : 0u;
+	mask |= property.hazard ? MapChipPlaneMask(MapChipPlane::kHazard) : 0u;
+	mask |= property.climbable ? MapChipPlaneMask(MapChipPlane::kClimbable) : 0u;
+	return mask;
+}
+
+/// <summary>
+/// マスク内のいずれかのビットプレーンに属する種別のマスク（MapChipTypeMask の組み合わせ）
+/// </summary>
+inline constexpr uint32_t GetMapChipTypeMaskOfPlanes(uint32_t planeMask) {
+	uint32_t mask = 0;
+	for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+		if (GetMapChipPlaneMask(static_cast<MapChipType>(i)) & planeMask) {
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+}
+
+struct IndexSet {
+	uint32_t xIndex;
+	uint32_t yIndex;
+};
@@ -0,0 +1,119 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filename) {
+	Close();
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+
+	fileHandle_ = file;
+	isOpen_ = true;
+
+	// サイズ 0 のファイルはマップできないので空として扱う
+	if (fileSize.QuadPart == 0) {
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		Close();
+		return false;
+	}
+	mappingHandle_ = mapping;
+
+	data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!data_) {
+		Close();
+		return false;
+	}
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data_) {
+		UnmapViewOfFile(data_);
+	}
+	if (mappingHandle_) {
+		CloseHandle(mappingHandle_);
+	}
+	if (fileHandle_) {
+		CloseHandle(fileHandle_);
+	}
+	fileHandle_ = nullptr;
+	mappingHandle_ = nullptr;
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filename) {
+	Close();
+
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st = {};
+	if (::fstat(fd, &st) != 0) {
+		::close(fd);
+		return false;
+	}
+
+	fileDescriptor_ = fd;
+	isOpen_ = true;
+
+	// サイズ 0 のファイルはマップできないので空として扱う
+	if (st.st_size == 0) {
+		return true;
+	}
+
+	void* mapped = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapped == MAP_FAILED) {
+		Close();
+		return false;
+	}
+	data_ = static_cast<const char*>(mapped);
+	size_ = static_cast<size_t>(st.st_size);
+	return true;
+}
+
+void MappedFile::Close() {
+	if (data_) {
+		::munmap(const_cast<char*>(data_), size_);
+	}
+	if (fileDescriptor_ >= 0) {
+		::close(fileDescriptor_);
+	}
+	fileDescriptor_ = -1;
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+}
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/// <summary>
+/// 読み取り専用のメモリマップドファイル
+/// ファイル内容をコピーせずにそのままポインタで参照する
+/// </summary>
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/// <summary>
+	/// ファイルを開いてマップする
+	/// </summary>
+	/// <param name="filename">ファイル名</param>
+	/// <returns>開けなければ false（サイズ 0 のファイルは true で GetSize() == 0）</returns>
+	bool Open(const std::string& filename);
+
+	/// <summary>
+	/// マップを解除してファイルを閉じる
+	/// </summary>
+	void Close();
+
+	bool IsOpen() const { return isOpen_; }
+
+	const char* GetData() const { return data_; }
+	size_t GetSize() const { return size_; }
+
+private:
+#ifdef _WIN32
+	void* fileHandle_ = nullptr;
+	void* mappingHandle_ = nullptr;
+#else
+	int fileDescriptor_ = -1;
+#endif
+
+	const char* data_ = nullptr;
+	size_t size_ = 0;
+	bool isOpen_ = false;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+// エンジンの数学型のうち、当たり判定やマップの問い合わせで使う Vector3 だけを持ち込む
+// （KamataEngine.h 全体は含めない。エンジンのないツールでもビルドできるよう、見つからなければ同じ形の型を定義する）
+#if __has_include("math/Vector3.h")
+#include "math/Vector3.h"
+#else
+namespace KamataEngine {
+struct Vector3 {
+	float x;
+	float y;
+	float z;
+};
+} // namespace KamataEngine
+#endif
@@ -0,0 +1,33 @@
+#include "PhysicsTrace.h"
+
+#include <cstring>
+#include <fstream>
+
+std::vector<PhysicsTraceEvent> PhysicsTrace::Snapshot() const {
+	uint64_t head = head_.load(std::memory_order_acquire);
+	uint64_t count = head < kCapacity ? head : kCapacity;
+	std::vector<PhysicsTraceEvent> result;
+	result.reserve(static_cast<size_t>(count));
+	for (uint64_t index = head - count; index < head; ++index) {
+		result.push_back(events_[index & (kCapacity - 1)]);
+	}
+	return result;
+}
+
+bool PhysicsTrace::Dump(const std::string& path) const {
+	std::vector<PhysicsTraceEvent> events = Snapshot();
+
+	PhysicsTraceFileHeader header = {};
+	std::memcpy(header.magic, "PTRC", sizeof(header.magic));
+	header.version = kPhysicsTraceFileVersion;
+	header.eventSize = sizeof(PhysicsTraceEvent);
+	header.count = static_cast<uint32_t>(events.size());
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(PhysicsTraceEvent)));
+	return file.good();
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 物理・当たり判定の診断用トレース（エンジン非依存）
+// 文字列を組み立てる代わりに、固定長のバイナリイベント（種類・フレーム・float 数個）をリングバッファに書くだけにして、
+// 記録したまま遊べるようにする。F9（main.cpp）で直近のイベントをファイルに書き出し、Tools/TraceDecoder で文字列にする
+// ビルド時に PHYSICS_TRACE_DISABLED を定義すると記録の呼び出しごと消える
+
+// イベントの種類。値はファイルに残るので、追加は kCount の前に足し、既存の番号は変えない
+enum class PhysicsTraceId : uint16_t {
+	kInitialize,  // 初期化（位置のリセット）
+	kStepBegin,   // Step 開始時の位置・速度
+	kCollisionX,  // X 軸の当たり判定の結果
+	kCollisionY,  // Y 軸の当たり判定の結果
+	kClampX,      // マップの左右端で位置を止めた
+	kLeaveGround, // 離地した
+	kGroundMiss,  // 接地中に足元が見つからなかった
+	kLanded,      // 着地した
+	kHitCeiling,  // 天井に当たった
+	kJump,        // 地上・空中ジャンプ
+	kWallJump,    // 壁ジャンプ
+	kCount,
+};
+
+inline constexpr uint32_t kPhysicsTraceMaxValues = 6;
+
+/// <summary>
+/// 1 件のイベント（32 バイト）。ファイルにもこのまま書く
+/// </summary>
+struct PhysicsTraceEvent {
+	uint32_t frame;      // 記録した側のステップ番号
+	uint16_t id;         // PhysicsTraceId
+	uint16_t valueCount; // values の有効な数
+	float values[kPhysicsTraceMaxValues];
+};
+static_assert(sizeof(PhysicsTraceEvent) == 32);
+
+/// <summary>
+/// イベントの名前と値の名前（TraceDecoder の表示用）
+/// </summary>
+struct PhysicsTraceEventInfo {
+	const char* name;
+	std::array<const char*, kPhysicsTraceMaxValues> valueNames;
+};
+
+inline constexpr std::array<PhysicsTraceEventInfo, static_cast<size_t>(PhysicsTraceId::kCount)> kPhysicsTraceEventInfos = {{
+    {"initialize", {"x", "y"}},
+    {"stepBegin", {"x", "y", "vx", "vy"}},
+    {"collisionX", {"requested", "dx", "wall", "wallSide", "timeOfImpact"}},
+    {"collisionY", {"requested", "dy", "ceiling", "landing", "timeOfImpact"}},
+    {"clampX", {"from", "to"}},
+    {"leaveGround", {"reason", "vy"}}, // reason 0: ジャンプで上向き, 1: 足元なしが続いた
+    {"groundMiss", {"count"}},
+    {"landed", {"dy", "onIce"}},
+    {"hitCeiling", {"vy"}},
+    {"jump", {"inAir", "jumpCount", "vy"}},
+    {"wallJump", {"wallSide", "count", "vx", "vy"}},
+}};
+
+/// <summary>
+/// Dump で書くファイルの先頭。この後に count 件の PhysicsTraceEvent が古い順に続く
+/// </summary>
+struct PhysicsTraceFileHeader {
+	char magic[4];      // "PTRC"
+	uint32_t version;   // kPhysicsTraceFileVersion
+	uint32_t eventSize; // sizeof(PhysicsTraceEvent)
+	uint32_t count;
+};
+
+inline constexpr uint32_t kPhysicsTraceFileVersion = 1;
+
+/// <summary>
+/// イベントのリングバッファ。古いものから上書きする
+/// 書き込むのはゲームのスレッドだけ（1 スレッド）なので、枠に書いてから位置を進めるだけでロックも read-modify-write も使わない
+/// </summary>
+class PhysicsTrace {
+public:
+	// 保持する件数（2 の累乗）。32 バイト x 65536 = 2 MiB、1 ステップ 4 件前後なら 4 分ほど
+	static constexpr uint32_t kCapacity = 1u << 16;
+
+	static PhysicsTrace* GetInstance() {
+		static PhysicsTrace instance;
+		return &instance;
+	}
+
+	/// <summary>
+	/// イベントを 1 件書く（values は kPhysicsTraceMaxValues 個まで）
+	/// </summary>
+	template <typename... Values> void Record(PhysicsTraceId id, uint32_t frame, Values... values) {
+		static_assert(sizeof...(Values) <= kPhysicsTraceMaxValues);
+		uint64_t index = head_.load(std::memory_order_relaxed);
+		PhysicsTraceEvent& event = events_[index & (kCapacity - 1)];
+		event.frame = frame;
+		event.id = static_cast<uint16_t>(id);
+		event.valueCount = static_cast<uint16_t>(sizeof...(Values));
+		uint32_t i = 0;
+		((event.values[i++] = static_cast<float>(values)), ...);
+		head_.store(index + 1, std::memory_order_release);
+	}
+
+	/// <summary>
+	/// 残っているイベントを古い順に取り出す（書き込みと同じスレッドから呼ぶこと）
+	/// </summary>
+	std::vector<PhysicsTraceEvent> Snapshot() const;
+
+	/// <summary>
+	/// 残っているイベントをファイルに書き出す
+	/// </summary>
+	/// <returns>書けなければ false</returns>
+	bool Dump(const std::string& path) const;
+
+	void Clear() { head_.store(0, std::memory_order_relaxed); }
+
+	// これまでに記録した総数（上書きされた分も含む）
+	uint64_t GetRecordedCount() const { return head_.load(std::memory_order_relaxed); }
+
+private:
+	PhysicsTrace() : events_(kCapacity) {}
+
+	std::vector<PhysicsTraceEvent> events_;
+	std::atomic<uint64_t> head_ = 0;
+};
+
+#ifndef PHYSICS_TRACE_DISABLED
+#define PHYSICS_TRACE(id, frame, ...) PhysicsTrace::GetInstance()->Record((id), (frame), __VA_ARGS__)
+#else
+#define PHYSICS_TRACE(id, frame, ...) ((void)0)
+#endif
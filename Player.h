@@ -9,49 +9,17 @@
 
 #include"AABB.h"
 #include"MathUtl.h"
+#include "PlayerPhysics.h"
 
 using namespace KamataEngine;
 
-enum class WallSide {
-	kNone,
-	kLeft,
-	kRight,
-};
-
-struct CollisionMapInfo {
-	bool isCeilingCollision_ = false; // 天井衝突
-	bool isLanding_ = false;          // 着地
-	bool isWallContact_ = false;      // 壁接触
-	Vector3 movement_;
-	WallSide wallSide_ = WallSide::kNone; // どちらの壁に接触しているか
-};
-
 class MapChipField;
 class Enemy;
 class CameraController; // forward declaration
 
 class Player {
 public:
-	enum class LRDirection {
-		kRight,
-		kLeft,
-	};
-
-	// 角
-	enum Corner {
-		kLeftTop,     // 左上
-		kRightTop,    // 右上
-		kLeftBottom,  // 左下
-		kRightBottom, // 右下
-
-		kNumCorners, // 要素数
-	};
-
-	enum class Behavior {
-		kUnknown,
-		kRoot,   // 通常
-		kAttack, // 攻撃
-	};
+	using LRDirection = PlayerDirection;
 
 	// コンストラクタ
 	Player();
@@ -62,92 +30,26 @@ public:
 	// 初期化
 	void Initialize(Camera* camera, const Vector3& position);
 
-	void HandleMovementInput();
-
 	// 更新
 	void Update();
 
 	// 描画
 	void Draw();
 
-	Vector3 velocity_ = {};
-
-	Vector3 CornerPosition(const Vector3& center, Corner corner);
-
-	LRDirection lrDirection_ = LRDirection::kRight;
-
 	const WorldTransform& GetTransform() const { return worldTransform_; }
 
 	const Vector3& GetVelocity() const { return velocity_; }
 
-	void SetMapChipField(MapChipField* mapChipField) { this->mapChipField_ = mapChipField; }
-
-	void mapChipCollisionCheck(CollisionMapInfo& info);
-
-	/// <summary>
-	/// 判定結果を反映して移動する場合の処理
-	/// </summary>
-	/// <param name="info"></param>
-	void JudgmentResult(const CollisionMapInfo& info);
-
-	/// <summary>
-	/// 天井に接触している場合の処理
-	/// </summary>
-	/// <param name="info"></param>
-	void HitCeilingCollision(CollisionMapInfo& info);
-
-	/// <summary>
-	/// 壁に接触している場合の処理
-	/// </summary>
-	/// <param name="info"></param>
-	void HitWallCollision(CollisionMapInfo& info);
-
-	/// <summary>
-	/// 接地状態の切り替え処理
-	/// </summary>
-	/// <param name="info"></param>
-	void SwitchingTheGrounding(CollisionMapInfo& info);
-
-	void HandleMapCollisionUp(CollisionMapInfo& info);
-
-	void HandleMapCollisionDown(CollisionMapInfo& info);
-
-	void HandleMapCollisionLeft(CollisionMapInfo& info);
-
-	void HandleMapCollisionRight(CollisionMapInfo& info);
-
-	// 壁滑り・壁ジャンプ
-	void UpdateWallSlide(const CollisionMapInfo& info);
-	void HandleWallJump(const CollisionMapInfo& info);
+	void SetMapChipField(const MapChipField* mapChipField);
 
 	void OnCollision(Enemy* enemy);
 
 	void UpdateAABB();
 
-	/// <summary>
-	/// 緊急回避
-	/// </summary>
-	void EmergencyAvoidance();
-
-	//攻撃
-
-	// 行動初期化
-	void BehaviorRootInitialize();
-
-	// 攻撃行動初期化
-	void BehaviorAttackInitialize();
-
-	//通常行動更新
-	void BehaviorRootUpdate();
-
-	//攻撃行動更新
-	void BehaviorAttackUpdate();
-
-
-	LRDirection GetLRDirection() const { return lrDirection_; }
+	LRDirection GetLRDirection() const { return physics_.GetDirection(); }
 
 	// Attack accessors
-	bool IsAttacking() const { return behavior_ == Behavior::kAttack; }
+	bool IsAttacking() const { return physics_.IsAttacking(); }
 	AABB GetAttackAABB() const;
 
 	// 攻撃エフェクトのワールド変換を更新
@@ -198,57 +100,40 @@ private:
 
 	Camera* camera_ = nullptr;
 
-	// マップチップフィールド
-	MapChipField* mapChipField_ = nullptr;
+	// PlayerPhysics から MapChipField を引くための橋渡し
+	class FieldMapQuery : public PlayerMapQuery {
+	public:
+		const MapChipField* field = nullptr;
 
-	AABB aabb_;
-
-	// 現在の行動状態
-	Behavior behavior_ = Behavior::kRoot;
-	Behavior behaviorRequest_ = Behavior::kUnknown;
-	
-private:
-
-	#pragma region 地上での移動関係
+		uint32_t GetNumBlockHorizontal() const override;
+		uint32_t GetNumBlockVertical() const override;
+		MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) const override;
+		bool AnyInRect(MapChipPlane plane, int32_t x0, int32_t y0, int32_t x1, int32_t y1) const override;
+	};
 
-	// 加速量
-	static inline const float kAcceleration = 0.01f; 
-	// 横移動の最大速度
-	static inline const float kLimitRunSpeed = 0.2f;
+	// マップチップフィールド
+	FieldMapQuery mapQuery_;
 
-	#pragma endregion 地上での移動関係
+	// 移動・ジャンプ・当たり判定
+	PlayerPhysics physics_;
 
-	#pragma region 梯子での移動関係
-	// 空中での横移動加速度（地上より弱め）
-	static inline const float kAirAcceleration = kAcceleration;
-	// 空中での最大横移動速度（地上より少し低め）
-	static inline const float kAirLimitRunSpeed = kLimitRunSpeed;
-	#pragma region 梯子での移動関係
+	// physics_ の速度（GetVelocity で返すために毎フレーム写す）
+	Vector3 velocity_ = {};
 
-	#pragma region ジャンプ関係
+	AABB aabb_;
 
-	// ジャンプ用の上向き速度（地上からの一段目）
-	// 固定値で上向き速度を設定することで、二段ジャンプの高さが入力時の落下速度に依存しないようにする
-	static inline const float kJumpVelocityGround = 0.55f;
-	// 空中での二段ジャンプ時の上向き速度（地上ジャンプよりやや小さめに）
-	static inline const float kJumpVelocityAir = 0.7f; 
+	/// <summary>
+	/// キーボード・パッドの状態を 1 フレーム分の入力にまとめる
+	/// </summary>
+	PlayerInput ReadInput();
 
-	#pragma endregion ジャンプ関係
+	/// <summary>
+	/// physics_ の位置・しゃがみを worldTransform_ に写す
+	/// </summary>
+	void SyncTransformFromPhysics();
 
 	uint32_t textureHandle_ = 0u;
 
-	
-	
-
-	// 速度減衰（慣性制御）
-	// 値を増やして慣性を減らす（入力停止時にすばやく速度を落とす）
-	static inline const float kAttenuation = 0.25f; 
-
-	
-
-	// ジャンプ直後の横方向ダンピング（地上からジャンプしたときの横慣性を抑える）
-	static inline const float kJumpHorizontalDamp = 0.7f;
-
 	// 旋回開始の角度
 	float turnFirstRotationY_ = 0.0f;
 
@@ -258,123 +143,21 @@ private:
 	// 旋回時間
 	static inline const float kTimeTurn = 0.3f;
 
-	// 接地状態フラグ
-	bool onGround_ = true;
-
-	// Ladder state
-	bool onLadder_ = false;
-
-	// grace time to hold on ladder after releasing input to avoid instant fall at top
-	float ladderHoldTimer_ = 0.0f;
-	static inline const float kLadderHoldTime = 0.18f; // seconds
-
-	// remember ladder column when grabbing ladder to prevent climbing away
-	int lastLadderX_ = -1;
-	bool hasLastLadder_ = false;
-
-	// 重力加速度(下方向)
-	static inline const float kGravityAcceleration = 0.05f;
-
-	// はしご登り速度
-	static inline const float kClimbSpeed = 0.12f;
-
-	// はしご上での横移動速度許容
-	static inline const float kLadderHorizontalSpeed = 0.18f; // reduced for gentler movement
-	// はしご上での横移動の補間係数（0-1）。値が小さいほどゆっくり移動を反映する（緩め）
-	static inline const float kLadderHorizontalAccel = 0.06f; // smaller -> slower response (more 'Minecraft'-like)
-
-	// Grounding debounce: how many consecutive misses before leaving ground
-	static inline const int kGroundMissThreshold = 2;
-	int groundMissCount_ = 0;
-
-	// 最大落下速度(下方向)
-	static inline const float kLimitFallSpeed = 5.0f;
-
-
-	
-
-	// 最大落下速度(上方向)
-	static inline const float kJumpAcceleration = 1.0f;
-
+	bool isAlive_ = true;
 
 	// キャラクターの当たり判定サイズ
-	static inline const float kWidth = 0.8f * 2.0f;
-	static inline const float kHeight = 0.8f * 2.0f;
-
-	static inline const float kBlank = 0.1f * 2.0f;
-
-	// 着地時の速度減衰率
-	static inline const float kAttenuationLanding = 0.35f; 
-
-	// 着地時の速度減衰率
-	static inline const float kAttenuationWall = 0.2f;
-
-	// --- 壁けり関連 ---
-	bool isWallSliding_ = false;
-	float wallJumpCooldown_ = 0.0f; // 同一入力で連続発動しないためのクールダウン
-
-	static inline const float kWallJumpHorizontalSpeed = 0.6f; // 壁から離れるX速度
-	// Reduced vertical speeds so wall-jump reaches lower height than double jump
-	static inline const float kWallJumpVerticalSpeed = 0.55f;   // 壁けり時のY速度 (reduced)
-
-	static inline const float kWallJumpHorizontalSpeed2 = 0.3f; // second jump horizontal
-	static inline const float kWallJumpVerticalSpeed2 = 0.45f; // second jump vertical
-
-	static inline const float kWallSlideMaxFallSpeed = 3.0f;   // 壁滑り中の最大落下速度
-	static inline const float kWallJumpCooldownTime = 0.1f;    // クールダウン時間(秒) (reduced)
-	static inline const float kWallJumpHorizontalDamp = 0.6f; 
-
-	int wallJumpCount_ = 0;
-	static inline const int kMaxWallJumps = 2;
-
-	WallSide lastWallSide_ = WallSide::kNone;
-
-	static inline const float kWallContactGraceTime = 0.1f; 
-	float wallContactGraceTimer_ = 0.0f;
-
-	bool isAlive_ = true;	
-
-	//攻撃ギミックの経過時間
-	uint32_t attackParameter_ = 0;
-
-	float static inline const kAttackDuration = 10; // 攻撃動作の継続時間(フレーム)
+	static inline const float kWidth = PlayerPhysics::kWidth;
+	static inline const float kHeight = PlayerPhysics::kHeight;
 
 	// attack hitbox
 	static inline const float kAttackReach = 1.0f; // 前方への到達距離
 	volatile static inline const float kAttackWidth = 1.2f; // 当たり判定の幅(横)
 	static inline const float kAttackHeight = 0.8f; // 当たり判定の高さ
 
-	// 攻撃時の短距離ダッシュ設定
-	static inline const float kAttackDashSpeed = 1.5f; // 攻撃開始時のダッシュ速度
-	static inline const int kAttackDashFrames = 6;     // ダッシュが続くフレーム数
-	// 攻撃クールタイム
-	float attackCooldown_ = 0.0f;
-	static inline const float kAttackCooldownTime = 1.0f; // seconds (debug)
-
 	// カメラコントローラ参照（シェイク呼び出し用）
 	CameraController* cameraController_ = nullptr;
 
-	XINPUT_STATE state;
-
-    // 前フレームで右トリガーが押されていたか（単発入力判定用）
-    bool prevRightTriggerPressed_ = false;
-
-
-	// 二段ジャンプ関連
-	static inline const int kMaxJumps = 2; // 最大ジャンプ回数（地上から含む）
-	int jumpCount_ = 0; // 現在のジャンプ回数
-	// ゲームパッドのAボタンの前フレーム状態（ライズエッジ検出用）
-	bool prevAButtonPressed_ = false;
-	// キーボードジャンプキーの前フレーム状態（ライズエッジ検出用）
-	bool prevJumpKeyPressed_ = false;
-
-	// --- Emergency dodge (Eキー) ---
-	bool isDodging_ = false;
-	float dodgeTimer_ = 0.0f;
-	float dodgeCooldown_ = 0.0f;
-	static inline const float kDodgeDuration = 0.15f; // seconds
-	static inline const float kDodgeSpeed = 2.0f; // dash speed
-	static inline const float kDodgeCooldownTime = 0.5f; // seconds
+	XINPUT_STATE state = {};
 
 	// 死亡遷移用フラグ（接触直後に一瞬静止してから死亡扱いにする）
 	bool isDying_ = false;
@@ -394,23 +177,9 @@ private:
 	// 攻撃エフェクトのZバイアス（カメラに少し近づけて奥の敵と重なった時の非表示を回避）
 	static inline const float kAttackEffectZBias = -0.15f;
 
-	// 攻撃入力のバッファ（クールタイム明け直後の入力取りこぼし回避）
-	float attackInputBufferTimer_ = 0.0f;
-	static inline const float kAttackInputBufferTime = 0.18f; // seconds
-
 	// collected keys
 	int keyCount_ = 0;
 
-	bool onIce_ = false; // 現在接地しているタイルがIceかどうか
-
-	// --- Crouch (Qキー) ---
-	bool isCrouching_ = false;
-	// If crouch was started by a dodge/roll (temporary), remember to restore when dodge ends
-	bool crouchForcedByDodge_ = false;
-	// 視覚的にモデルを縮めるスケール倍率（Y方向）
-	static inline const float kCrouchVisualScale = 0.6f;
-	// 当たり判定で使う高さ倍率
-	static inline const float kCrouchHeightMultiplier = 0.5f;
 	// 元のYスケールを保持して復元する
 	float baseScaleY_ = 1.0f;
 
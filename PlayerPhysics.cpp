@@ -0,0 +1,932 @@
+#include "PlayerPhysics.h"
+
+#include "PhysicsTrace.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+bool IsPressingTowardWall(const PlayerInput& input, WallSide side) {
+	switch (side) {
+	case WallSide::kLeft:
+		return input.left || (input.stickX < -0.2f);
+	case WallSide::kRight:
+		return input.right || (input.stickX > 0.2f);
+	default:
+		return false;
+	}
+}
+
+// 要求した移動量のうち、当たるまでに進めた割合（0 ～ 1）
+float TimeOfImpact(float allowed, float requested) {
+	if (requested == 0.0f) {
+		return 1.0f;
+	}
+	return std::clamp(allowed / requested, 0.0f, 1.0f);
+}
+
+} // namespace
+
+void PlayerPhysics::Initialize(const PlayerVector2& position, float visualScaleY) {
+	// 地図の参照以外はすべて初期値に戻す
+	const PlayerMapQuery* map = map_;
+	*this = PlayerPhysics();
+	map_ = map;
+	position_ = position;
+	visualScaleY_ = visualScaleY;
+
+	PHYSICS_TRACE(PhysicsTraceId::kInitialize, stepCount_, position_.x, position_.y);
+}
+
+PlayerPhysicsEvents PlayerPhysics::Step(const PlayerInput& input) {
+	events_ = {};
+	++stepCount_;
+	PHYSICS_TRACE(PhysicsTraceId::kStepBegin, stepCount_, position_.x, position_.y, velocity_.x, velocity_.y);
+
+	// 攻撃クールタイム減算
+	if (attackCooldown_ > 0.0f) {
+		attackCooldown_ -= kDeltaTime;
+		if (attackCooldown_ < 0.0f) attackCooldown_ = 0.0f;
+	}
+
+	// 攻撃入力バッファ減算
+	if (attackInputBufferTimer_ > 0.0f) {
+		attackInputBufferTimer_ -= kDeltaTime;
+		if (attackInputBufferTimer_ < 0.0f) attackInputBufferTimer_ = 0.0f;
+	}
+
+	if (behaviorRequest_ != Behavior::kUnknown) {
+		// 振る舞いを変更
+		behavior_ = behaviorRequest_;
+		// 各振る舞い開始時の初期化処理
+		if (behavior_ == Behavior::kAttack) {
+			BehaviorAttackInitialize();
+		}
+		behaviorRequest_ = Behavior::kUnknown;
+	}
+
+	if (behavior_ == Behavior::kAttack) {
+		BehaviorAttackUpdate();
+	}
+
+	// このステップのマップの大きさ（座標変換のたびに map_ に聞かないように）
+	if (map_) {
+		numBlockHorizontal_ = map_->GetNumBlockHorizontal();
+		numBlockVertical_ = map_->GetNumBlockVertical();
+	}
+
+	// 1. 移動入力
+	HandleMovementInput(input);
+
+	// 攻撃入力: Eキー（キーボード）またはRT（Xbox）の立ち上がり検知
+	bool attackKeyRising = input.attackKey && !prevAttackKeyPressed_;
+	bool attackButtonRising = input.attackButton && !prevAttackButtonPressed_;
+	prevAttackKeyPressed_ = input.attackKey;
+	prevAttackButtonPressed_ = input.attackButton;
+
+	// 入力が来たらバッファに蓄える
+	if (attackKeyRising || attackButtonRising) {
+		attackInputBufferTimer_ = kAttackInputBufferTime;
+	}
+
+	// クールタイム終了かつ未攻撃中、かつバッファが残っていれば攻撃開始
+	if (attackCooldown_ <= 0.0f && !IsAttacking() && attackInputBufferTimer_ > 0.0f) {
+		behaviorRequest_ = Behavior::kAttack;
+		attackInputBufferTimer_ = 0.0f; // 消費
+	}
+
+	// decrease dodge timer if currently dodging; end dodge when timer elapses
+	if (isDodging_) {
+		dodgeTimer_ -= kDeltaTime;
+		if (dodgeTimer_ <= 0.0f) {
+			isDodging_ = false;
+			// reduce horizontal speed when dodge ends
+			velocity_.x *= 0.5f;
+			velocity_.x = std::clamp(velocity_.x, -kLimitRunSpeed, kLimitRunSpeed);
+			// restore crouch if it was forced by dodge
+			if (crouchForcedByDodge_) {
+				SetCrouching(false);
+				crouchForcedByDodge_ = false;
+			}
+		}
+	}
+
+	// dodge cooldown decrement
+	if (dodgeCooldown_ > 0.0f) {
+		dodgeCooldown_ -= kDeltaTime;
+		if (dodgeCooldown_ < 0.0f)
+			dodgeCooldown_ = 0.0f;
+	}
+
+	// 衝突情報を初期化
+	CollisionMapInfo collisionInfo;
+	// 移動量を加味して現在地を算定するために、現在の速度をcollisionInfoにセット
+	collisionInfo.movement_ = velocity_;
+
+	// 2. 移動量を加味して衝突判定する（軸ごとに解決してガタつきを抑制）
+	MapChipCollisionCheck(collisionInfo);
+
+	// 3. 判定結果を反映して移動させる
+	JudgmentResult(collisionInfo);
+
+	// 4. 天井に接触している場合の処理
+	HitCeilingCollision(collisionInfo);
+
+	SwitchingTheGrounding(collisionInfo);
+
+	// 5. 壁に接触している場合の処理
+	HitWallCollision(collisionInfo);
+
+	// 6. 壁滑り・壁ジャンプ処理（次フレームの速度に反映される）
+	UpdateWallSlide(input, collisionInfo);
+	HandleWallJump(input, collisionInfo);
+
+	lastCollision_ = collisionInfo;
+	return events_;
+}
+
+void PlayerPhysics::SuppressNextJump() {
+	// mark previous jump keys/buttons as pressed so next frame rising edge isn't detected
+	prevJumpKeyPressed_ = true;
+	prevAButtonPressed_ = true;
+}
+
+// 移動処理
+void PlayerPhysics::HandleMovementInput(const PlayerInput& input) {
+
+	// 緊急回避入力: Qキーまたは左トリガーの立ち上がり
+	bool dodgeKeyRising = input.dodgeKey && !prevDodgeKeyPressed_;
+	bool dodgeButtonRising = input.dodgeButton && !prevDodgeButtonPressed_;
+	prevDodgeKeyPressed_ = input.dodgeKey;
+	prevDodgeButtonPressed_ = input.dodgeButton;
+
+	if (isDodging_) {
+
+		if (!onGround_) {
+			velocity_.y += -kGravityAcceleration;
+			velocity_.y = std::max(velocity_.y, -kLimitFallSpeed);
+		}
+		return;
+	}
+
+	bool dodgeTriggered = dodgeKeyRising || dodgeButtonRising;
+
+	if (dodgeTriggered && !isDodging_ && dodgeCooldown_ <= 0.0f && behavior_ != Behavior::kAttack) {
+		float dir = (lrDirection_ == PlayerDirection::kRight) ? 1.0f : -1.0f;
+		velocity_.x = dir * kDodgeSpeed;
+		isDodging_ = true;
+		dodgeTimer_ = kDodgeDuration;
+		dodgeCooldown_ = kDodgeCooldownTime;
+		events_.dodgeStarted = true;
+
+		if (!isCrouching_) {
+			SetCrouching(true);
+			crouchForcedByDodge_ = true;
+		}
+	}
+
+	float stickX = input.stickX;
+
+	bool keyRight = input.right;
+	bool keyLeft = input.left;
+
+	bool moveRight = keyRight || (stickX > 0.0f);
+	bool moveLeft = keyLeft || (stickX < 0.0f);
+
+	// 地面の摩擦係数を取得（デフォルトは1.0f相当）。利用可能なら取得
+	float groundFriction = 0.9f;
+	if (map_) {
+		PlayerVector2 samplePos = {position_.x, position_.y - (kHeight * 0.5f) - 0.02f};
+		groundFriction = GetFrictionCoefficientByPosition(samplePos);
+		onIce_ = (groundFriction < 0.1f);
+	}
+
+	// ハシゴ判定: プレイヤー中心から足元（少し上）までの縦線がハシゴタイルと重なるならハシゴ状態
+	// 足元まで見ることで、少しずれていてもハシゴを掴めるようにする
+	bool ladderHere = false;
+	if (map_) {
+		IndexSet top = GetMapChipIndexSetByPosition(position_);
+		IndexSet bottom = GetMapChipIndexSetByPosition({position_.x, position_.y - (kHeight * 0.5f) + 0.1f});
+		ladderHere = map_->AnyInRect(
+		    MapChipPlane::kClimbable, static_cast<int32_t>(top.xIndex), static_cast<int32_t>(top.yIndex), static_cast<int32_t>(top.xIndex), static_cast<int32_t>(bottom.yIndex));
+	}
+
+	// ハシゴ昇降入力
+	bool climbUp = input.up || (input.stickY > 0.2f);
+	bool climbDown = input.down || (input.stickY < -0.2f);
+
+	if (ladderHere && (climbUp || climbDown)) {
+		// ハシゴ状態へ移行
+		onLadder_ = true;
+	}
+
+	// ハシゴ上にいる場合、W/Sでの上下移動を処理し、重力や地上摩擦は無視
+	if (onLadder_) {
+		// 既存の縦方向速度をキャンセルし、昇降を適用
+		velocity_.y = 0.0f;
+		// allow analog stick control for smooth climbing
+		if (std::fabs(input.stickY) > 0.01f) {
+			// stickY is [-1,1], positive means up
+			velocity_.y = input.stickY * kClimbSpeed;
+		} else if (climbUp) {
+			velocity_.y = kClimbSpeed;
+		} else if (climbDown) {
+			velocity_.y = -kClimbSpeed;
+		} else {
+			velocity_.y = 0.0f;
+		}
+
+		// ハシゴ昇降中も、ADキーまたはスティックによる限定的な横移動を許可
+		float horizInput = 0.0f;
+		// キーボード入力を優先的に最大値とし、そうでなければスティック値で滑らかに
+		if (keyRight)
+			horizInput = 1.0f;
+		else if (keyLeft)
+			horizInput = -1.0f;
+		else
+			horizInput = stickX; // stickX は [-1,1] の範囲
+
+		// Update facing direction on ladder when player provides horizontal input
+		if (horizInput > 0.01f) {
+			SetDirection(PlayerDirection::kRight);
+		} else if (horizInput < -0.01f) {
+			SetDirection(PlayerDirection::kLeft);
+		}
+
+		// ハシゴ上での目標横速度
+		float targetVx = std::clamp(horizInput, -1.0f, 1.0f) * kLadderHorizontalSpeed;
+		// 目標へ滑らかに補間（係数が小さいほど穏やか）
+		velocity_.x += (targetVx - velocity_.x) * kLadderHorizontalAccel;
+		// 入力がないときの微小減衰で、ゆっくり中央へ収束
+		if (std::fabs(horizInput) < 0.01f) {
+			velocity_.x *= 0.95f;
+		}
+
+		// プレイヤーがハシゴタイルから離れたら、ハシゴ状態を離脱することを検討
+		if (!ladderHere) {
+			if (map_) {
+				// プレイヤーの頭上ブロックを探索
+				IndexSet probeIdx = GetMapChipIndexSetByPosition({position_.x, position_.y + kHeight * 0.5f + 0.02f});
+				if (TestPlane(MapChipPlane::kSolid, probeIdx.xIndex, probeIdx.yIndex)) {
+					// 許容誤差内ならプレイヤーの足元をブロック上面にスナップして、Wを離しても落下しないよう調整
+					float desiredY = GetTileTop(probeIdx.yIndex) + (kHeight * 0.5f); // 足元がブロック上面に一致するような位置
+					float tolerance = 0.5f;                                         // わずかなオーバーシュートを許容
+					if (position_.y <= desiredY + tolerance) {
+						position_.y = desiredY;
+						velocity_.y = 0.0f;
+						onGround_ = true;
+						onLadder_ = false;
+					} else {
+						// 上面よりも十分上にいる場合は、ハシゴを離脱して重力へ復帰
+						onLadder_ = false;
+					}
+				} else {
+					// 頭上にブロックがない: ハシゴを離脱して重力へ復帰
+					onLadder_ = false;
+				}
+			} else {
+				onLadder_ = false;
+			}
+		}
+
+		// ハシゴ上でジャンプ入力があれば、ハシゴ状態を離脱してジャンプを実行
+		if (input.jumpKey || input.jumpButton) {
+			onLadder_ = false;
+			// 小さめのジャンプを実行
+			velocity_.y = kJumpVelocityGround;
+		}
+
+		// 早期リターンして通常の重力処理をスキップ
+		// 注意: この後の衝突と最終反映処理は継続
+		return;
+	}
+
+	if (onGround_) {
+		if (moveRight || moveLeft) {
+			float accelerationX = 0.0f;
+
+			float inputIntensityRight = (keyRight) ? 1.0f : std::max(0.0f, stickX);
+			float inputIntensityLeft = (keyLeft) ? 1.0f : std::max(0.0f, -stickX);
+
+			if (inputIntensityRight > 0.0f) {
+				if (velocity_.x < 0.0f) {
+					// 反転時の減衰量を摩擦に応じて決定
+					float reverseDamp = onIce_ ? 0.8f : 0.3f;
+					velocity_.x *= reverseDamp;
+
+					if (std::fabs(velocity_.x) < 0.01f)
+						velocity_.x = 0.0f;
+				}
+				SetDirection(PlayerDirection::kRight);
+				accelerationX += (onIce_ ? (kAcceleration * 0.6f) : kAcceleration) * inputIntensityRight;
+			} else if (inputIntensityLeft > 0.0f) {
+				if (velocity_.x > 0.0f) {
+					float reverseDamp = onIce_ ? 0.8f : (1.0f - groundFriction * 0.7f);
+					velocity_.x *= reverseDamp;
+					if (std::fabs(velocity_.x) < 0.01f)
+						velocity_.x = 0.0f;
+				}
+				SetDirection(PlayerDirection::kLeft);
+				accelerationX -= (onIce_ ? (kAcceleration * 0.6f) : kAcceleration) * inputIntensityLeft;
+			}
+
+			velocity_.x += accelerationX;
+			velocity_.x = std::clamp(velocity_.x, -kLimitRunSpeed, kLimitRunSpeed);
+		} else {
+			// 地上での減衰（氷上では減衰大幅に弱め）
+			// 摩擦係数に応じて減衰量をスケール: 摩擦が高いほど強い減衰
+			float baseAtten = kAttenuation;
+			float atten = (onIce_) ? (kAttenuation * 0.15f) : (baseAtten * (1.0f + (1.0f - groundFriction)));
+			velocity_.x *= (1.0f - atten);
+		}
+
+		// ジャンプ入力はライズエッジ側で処理するため、ここで直接加算は行わない
+
+	} else {
+		// 空中の横移動制御は変更なし
+		if (moveRight || moveLeft) {
+			float inputIntensityRight = (keyRight) ? 1.0f : std::max(0.0f, stickX);
+			float inputIntensityLeft = (keyLeft) ? 1.0f : std::max(0.0f, -stickX);
+
+			float accelX = 0.0f;
+			if (inputIntensityRight > 0.0f) {
+				// 反対方向への速度を少し緩和して方向転換を行う
+				if (velocity_.x < 0.0f) {
+					velocity_.x *= 0.8f;
+				}
+				SetDirection(PlayerDirection::kRight);
+				accelX += kAirAcceleration * inputIntensityRight;
+			} else if (inputIntensityLeft > 0.0f) {
+				if (velocity_.x > 0.0f) {
+					velocity_.x *= 0.8f;
+				}
+				SetDirection(PlayerDirection::kLeft);
+				accelX -= kAirAcceleration * inputIntensityLeft;
+			}
+
+			velocity_.x += accelX;
+			// 空中では地上より少し低い最大速度に制限
+			velocity_.x = std::clamp(velocity_.x, -kAirLimitRunSpeed, kAirLimitRunSpeed);
+		} else {
+			// 空中では減衰を弱める（空中の慣性を残す）
+			velocity_.x *= (1.0f - kAttenuation * 0.2f);
+		}
+
+		// 常に重力を加える（空中）
+		velocity_.y += -kGravityAcceleration;
+
+		// 落下速度の上限を設ける
+		if (velocity_.y < -kLimitFallSpeed) {
+			velocity_.y = -kLimitFallSpeed;
+		}
+	}
+
+	bool keyboardRising = input.jumpKey && !prevJumpKeyPressed_;
+	prevJumpKeyPressed_ = input.jumpKey;
+
+	bool gamepadRising = input.jumpButton && !prevAButtonPressed_;
+	prevAButtonPressed_ = input.jumpButton;
+
+	if ((keyboardRising || gamepadRising) && (onGround_ || jumpCount_ < kMaxJumps)) {
+		if (onGround_) {
+			// 地上ジャンプは前フレームの垂直速度を消してから固定上向き速度を与える
+			velocity_.y = kJumpVelocityGround;
+			// 地上からジャンプした瞬間は横方向の慣性を抑える
+			velocity_.x *= kJumpHorizontalDamp;
+			// ただし空中での上限に収める
+			velocity_.x = std::clamp(velocity_.x, -kAirLimitRunSpeed, kAirLimitRunSpeed);
+		} else {
+			// 二段ジャンプも固定上向き速度を設定して高さを安定させる
+			velocity_.y = kJumpVelocityAir;
+		}
+
+		PHYSICS_TRACE(PhysicsTraceId::kJump, stepCount_, onGround_ ? 0.0f : 1.0f, static_cast<float>(jumpCount_), velocity_.y);
+
+		events_.jumped = true;
+		jumpCount_++;
+		onGround_ = false;
+	}
+}
+
+void PlayerPhysics::SetDirection(PlayerDirection direction) {
+	if (lrDirection_ != direction) {
+		lrDirection_ = direction;
+		events_.turnStarted = true;
+	}
+}
+
+void PlayerPhysics::SetCrouching(bool crouching) {
+	float oldHalfHeight = kHeight * 0.5f * visualScaleY_ * GetVisualScaleMultiplier();
+	isCrouching_ = crouching;
+	float newHalfHeight = kHeight * 0.5f * visualScaleY_ * GetVisualScaleMultiplier();
+	position_.y += (newHalfHeight - oldHalfHeight);
+}
+
+void PlayerPhysics::BehaviorAttackInitialize() {
+	// カウンターの初期化
+	attackParameter_ = 0;
+	// 攻撃クールタイム開始
+	attackCooldown_ = kAttackCooldownTime;
+	events_.attackStarted = true;
+}
+
+void PlayerPhysics::BehaviorAttackUpdate() {
+
+	// 攻撃動作時間経過
+	attackParameter_++;
+
+	if (attackParameter_ > kAttackDuration) {
+		behaviorRequest_ = Behavior::kRoot;
+	}
+
+	// ダッシュ切り実装: 攻撃開始から最初の数フレームだけ前方へ短距離ダッシュ
+	float dir = (lrDirection_ == PlayerDirection::kRight) ? 1.0f : -1.0f;
+
+	if (attackParameter_ <= kAttackDashFrames) {
+		// 攻撃開始フレームは強制的にダッシュ速度を与える
+		velocity_.x = dir * kAttackDashSpeed;
+	} else {
+		// ダッシュ終了後は急速に減衰させて停止に持っていく
+		velocity_.x *= 0.5f;
+		// 安全にクランプ
+		velocity_.x = std::clamp(velocity_.x, -kLimitRunSpeed, kLimitRunSpeed);
+	}
+
+	// 縦方向は通常の物理挙動に任せる。
+}
+
+PlayerVector2 PlayerPhysics::CornerPosition(const PlayerVector2& center, Corner corner) const {
+
+	static const PlayerVector2 kOffsetTable[kNumCorners] = {
+	    {-kWidth / 2.0f, +kHeight / 2.0f}, //  左上
+	    {+kWidth / 2.0f, +kHeight / 2.0f}, //  右上
+	    {-kWidth / 2.0f, -kHeight / 2.0f}, //  左下
+	    {+kWidth / 2.0f, -kHeight / 2.0f}, //  右下
+	};
+
+	const PlayerVector2& offset = kOffsetTable[static_cast<uint32_t>(corner)];
+	return {center.x + offset.x, center.y + offset.y};
+}
+
+void PlayerPhysics::MapChipCollisionCheck(CollisionMapInfo& info) {
+	if (!map_) {
+		return;
+	}
+
+	// 軸分離解決: まずXのみ、次にXを反映した一時座標でYを解決
+	PlayerVector2 originalPos = position_;
+
+	// --- X軸 ---
+	CollisionMapInfo xInfo; // 局所的に使用
+	xInfo.movement_ = {info.movement_.x, 0.0f};
+	HandleMapCollisionLeft(xInfo);
+	HandleMapCollisionRight(xInfo);
+	// Xの結果を適用
+	float dx = xInfo.movement_.x;
+	info.isWallContact_ = xInfo.isWallContact_;
+	info.wallSide_ = xInfo.wallSide_;
+	info.timeOfImpactX_ = xInfo.timeOfImpactX_;
+
+	if (info.isWallContact_) {
+		if (lastWallSide_ != info.wallSide_) {
+
+			wallJumpCount_ = 0;
+			lastWallSide_ = info.wallSide_;
+		}
+
+		wallContactGraceTimer_ = kWallContactGraceTime;
+	} else {
+		lastWallSide_ = WallSide::kNone;
+	}
+
+	// Xを一時的に反映して、Yの判定に使う
+	position_.x += dx;
+
+	// --- Y軸 ---
+	CollisionMapInfo yInfo;
+	yInfo.movement_ = {0.0f, info.movement_.y};
+	HandleMapCollisionUp(yInfo);
+	HandleMapCollisionDown(yInfo);
+	float dy = yInfo.movement_.y;
+	info.isCeilingCollision_ = yInfo.isCeilingCollision_;
+	info.isLanding_ = yInfo.isLanding_;
+	info.timeOfImpactY_ = yInfo.timeOfImpactY_;
+
+	// 一時変更を戻す
+	position_ = originalPos;
+
+	PHYSICS_TRACE(
+	    PhysicsTraceId::kCollisionX, stepCount_, info.movement_.x, dx, info.isWallContact_ ? 1.0f : 0.0f, static_cast<float>(info.wallSide_), info.timeOfImpactX_);
+	PHYSICS_TRACE(
+	    PhysicsTraceId::kCollisionY, stepCount_, info.movement_.y, dy, info.isCeilingCollision_ ? 1.0f : 0.0f, info.isLanding_ ? 1.0f : 0.0f, info.timeOfImpactY_);
+
+	// 合成結果
+	info.movement_ = {dx, dy};
+}
+
+// 判定結果を反映して移動
+void PlayerPhysics::JudgmentResult(const CollisionMapInfo& info) {
+	// 移動
+	position_.x += info.movement_.x;
+	position_.y += info.movement_.y;
+
+	// マップの移動可能領域に基づいて X をクランプする（左端より外に行けないようにする）
+	if (map_) {
+		// MapChipField::GetMovableArea の左右端
+		float areaLeft = -kMapChipBlockWidth * 0.5f;
+		float areaRight = areaLeft + static_cast<float>(numBlockHorizontal_) * kMapChipBlockWidth - kMapChipBlockWidth;
+		float halfWidth = kWidth * 0.5f;
+		float minX = areaLeft + halfWidth;
+		float maxX = areaRight - halfWidth;
+		if (minX > maxX) {
+			// マップが小さすぎる場合の保険
+			minX = maxX = (areaLeft + areaRight) * 0.5f;
+		}
+		if (position_.x < minX) {
+			PHYSICS_TRACE(PhysicsTraceId::kClampX, stepCount_, position_.x, minX);
+			position_.x = minX;
+			velocity_.x = 0.0f;
+		} else if (position_.x > maxX) {
+			PHYSICS_TRACE(PhysicsTraceId::kClampX, stepCount_, position_.x, maxX);
+			position_.x = maxX;
+			velocity_.x = 0.0f;
+		}
+	}
+}
+
+// 天井に接触している場合
+void PlayerPhysics::HitCeilingCollision(const CollisionMapInfo& info) {
+	if (info.isCeilingCollision_) {
+		PHYSICS_TRACE(PhysicsTraceId::kHitCeiling, stepCount_, velocity_.y);
+		events_.hitCeiling = true;
+		velocity_.y = 0;
+	}
+}
+
+void PlayerPhysics::HitWallCollision(const CollisionMapInfo& info) {
+
+	if (!info.isWallContact_)
+		return;
+
+	// 空中時に壁へ押し込むような速度のみ制限
+	if (!onGround_) {
+		if ((info.wallSide_ == WallSide::kLeft && velocity_.x < 0.0f) || (info.wallSide_ == WallSide::kRight && velocity_.x > 0.0f)) {
+			velocity_.x *= 0.2f; // 完全に0にせず、勢いを少し残す
+		}
+	}
+}
+
+void PlayerPhysics::SwitchingTheGrounding(const CollisionMapInfo& info) {
+	if (!map_) {
+		return;
+	}
+
+	// 自キャラが接地状態
+	if (onGround_) {
+		// ジャンプ開始
+		if (velocity_.y > 0.0f) {
+			PHYSICS_TRACE(PhysicsTraceId::kLeaveGround, stepCount_, 0.0f, velocity_.y);
+			onGround_ = false;
+			groundMissCount_ = 0;
+		} else {
+			// 底面を複数点サンプリングして接地判定を安定化
+			constexpr float kGroundCheckExtra = 0.02f; // bottomから少し下をサンプリング
+			constexpr int kSampleCount = 3;
+			std::array<float, kSampleCount> sampleXOffsets = {-kWidth * 0.45f, 0.0f, kWidth * 0.45f};
+			const float sampleY = position_.y - (kHeight * 0.5f) - kGroundCheckExtra;
+
+			bool hit = false;
+			// まずセンター下を必須チェック（小さな浮遊足場上で端だけ外れるのを防ぐ）
+			IndexSet centerIdx = GetMapChipIndexSetByPosition({position_.x, sampleY});
+			if (TestPlane(MapChipPlane::kGround, centerIdx.xIndex, centerIdx.yIndex)) {
+				hit = true; // 中心に足場があれば地面あり
+			} else {
+				// 中心に地面がないなら周辺もチェックして、2点以上当たっていれば地面ありとみなす
+				int hits = 0;
+				for (int i = 0; i < kSampleCount; ++i) {
+					IndexSet idx = GetMapChipIndexSetByPosition({position_.x + sampleXOffsets[i], sampleY});
+					if (TestPlane(MapChipPlane::kGround, idx.xIndex, idx.yIndex)) {
+						hits++;
+					}
+				}
+				if (hits >= 2) {
+					hit = true;
+				}
+			}
+
+			if (!hit) {
+				// ミス -> カウントを増やし、閾値超えたら離地扱い
+				groundMissCount_++;
+				PHYSICS_TRACE(PhysicsTraceId::kGroundMiss, stepCount_, static_cast<float>(groundMissCount_));
+				if (groundMissCount_ >= kGroundMissThreshold) {
+					PHYSICS_TRACE(PhysicsTraceId::kLeaveGround, stepCount_, 1.0f, velocity_.y);
+					onGround_ = false;
+					groundMissCount_ = 0;
+				}
+			} else {
+				// ヒット -> リセット
+				groundMissCount_ = 0;
+			}
+		}
+
+	} else {
+
+		if (info.isLanding_) {
+			// 着地状態に切り替える
+			onGround_ = true;
+
+			// 着地時にX座標を減衰（氷上では弱め）
+			float atten = onIce_ ? kAttenuationLanding * 0.3f : kAttenuationLanding;
+			velocity_.x *= (1.0f - atten);
+
+			// Y座標をゼロにする
+			velocity_.y = 0.0f;
+
+			// 二段ジャンプのリセット
+			jumpCount_ = 0;
+
+			// ここで現在足元のタイルが Ice かどうかを更新
+			onIce_ = (GetFrictionCoefficientByPosition({position_.x, position_.y - (kHeight * 0.5f) - 0.02f}) < 0.1f);
+
+			wallJumpCount_ = 0;
+
+			PHYSICS_TRACE(PhysicsTraceId::kLanded, stepCount_, info.movement_.y, onIce_ ? 1.0f : 0.0f);
+		}
+	}
+}
+
+void PlayerPhysics::HandleMapCollisionUp(CollisionMapInfo& info) {
+	if (info.movement_.y <= 0) {
+		return;
+	}
+	PlayerVector2 positionNew = {position_.x + info.movement_.x, position_.y + info.movement_.y};
+
+	// 真上の当たり判定を行う
+	// 左上点から右上点までのタイル列を、頭が通過する行ごとに 1 回の行スパン判定で調べる
+	IndexSet indexSet = GetMapChipIndexSetByPosition(CornerPosition(positionNew, kLeftTop));
+	IndexSet indexSetRight = GetMapChipIndexSetByPosition(CornerPosition(positionNew, kRightTop));
+	int32_t left = static_cast<int32_t>(indexSet.xIndex);
+	int32_t right = static_cast<int32_t>(indexSetRight.xIndex);
+	int32_t lastRow = static_cast<int32_t>(indexSet.yIndex);
+
+	// 1 タイルを超える移動なら、今の行の 1 つ上から移動先の行まで手前（下）から順に調べる（天井をすり抜けない）
+	// それ以下の移動で通過しうるのは移動先の行だけなので、従来どおりその 1 行だけ調べる
+	int32_t row = lastRow;
+	if (info.movement_.y > kMapChipBlockHeight) {
+		row = static_cast<int32_t>(GetMapChipIndexSetByPosition(CornerPosition(position_, kLeftTop)).yIndex) - 1;
+	}
+	for (; row >= lastRow; --row) {
+		if (map_->AnyInRect(MapChipPlane::kSolid, left, row, right, row)) {
+			// 今すでに掛かっている行なら、上方向への遷移ではない
+			if (GetMapChipIndexSetByPosition(CornerPosition(position_, kLeftTop)).yIndex == static_cast<uint32_t>(row)) {
+				return;
+			}
+
+			// めり込み先ブロックの下端まで
+			float requested = info.movement_.y;
+			info.movement_.y = std::max(0.0f, GetTileBottom(static_cast<uint32_t>(row)) - position_.y - (kHeight * 0.5f + kBlank));
+			info.timeOfImpactY_ = TimeOfImpact(info.movement_.y, requested);
+
+			// 天井に当たったことを記録する
+			info.isCeilingCollision_ = true;
+			return;
+		}
+	}
+}
+
+void PlayerPhysics::HandleMapCollisionDown(CollisionMapInfo& info) {
+	// 移動後の予測座標で、左下点から右下点までのタイル列をチェック
+	PlayerVector2 positionNew = {position_.x + info.movement_.x, position_.y + info.movement_.y};
+	IndexSet index = GetMapChipIndexSetByPosition(CornerPosition(positionNew, kLeftBottom));
+	IndexSet indexRight = GetMapChipIndexSetByPosition(CornerPosition(positionNew, kRightBottom));
+	int32_t left = static_cast<int32_t>(index.xIndex);
+	int32_t right = static_cast<int32_t>(indexRight.xIndex);
+	int32_t lastRow = static_cast<int32_t>(index.yIndex);
+
+	// 1 タイルを超えて落ちるときは、足元が通過する途中の行を手前（上）から順に調べてから移動先の行を調べる（床をすり抜けない）
+	int32_t row = lastRow;
+	if (info.movement_.y < -kMapChipBlockHeight) {
+		row = std::min(static_cast<int32_t>(GetMapChipIndexSetByPosition(CornerPosition(position_, kLeftBottom)).yIndex) + 1, lastRow);
+	}
+	for (; row <= lastRow; ++row) {
+		if (map_->AnyInRect(MapChipPlane::kGround, left, row, right, row)) {
+			// ブロックの天面（行だけで決まる）にプレイヤーの足元を合わせる
+			float footY = position_.y - (kHeight / 2.0f);
+
+			// 足元が天面より下にある場合、その差分を押し戻す
+			float requested = info.movement_.y;
+			info.movement_.y = GetTileTop(static_cast<uint32_t>(row)) - footY;
+			info.timeOfImpactY_ = TimeOfImpact(info.movement_.y, requested);
+			velocity_.y = 0.0f;
+			info.isLanding_ = true;
+			return;
+		}
+	}
+}
+
+void PlayerPhysics::HandleMapCollisionLeft(CollisionMapInfo& info) {
+	if (info.movement_.x >= 0.0f) {
+		return;
+	}
+	PlayerVector2 positionNew = {position_.x + info.movement_.x, position_.y + info.movement_.y};
+
+	// 左上点から左下点までのタイル列をチェック（上の行ほど yIndex が小さい）
+	IndexSet indexSet = GetMapChipIndexSetByPosition(CornerPosition(positionNew, kLeftTop));
+	IndexSet indexSetBottom = GetMapChipIndexSetByPosition(CornerPosition(positionNew, kLeftBottom));
+	int32_t top = static_cast<int32_t>(indexSet.yIndex);
+	int32_t bottom = static_cast<int32_t>(indexSetBottom.yIndex);
+	int32_t lastColumn = static_cast<int32_t>(indexSet.xIndex);
+
+	// 1 タイルを超える移動なら、左辺が通過する列を今の列の 1 つ左から手前から順に調べる（壁をすり抜けない）
+	int32_t column = lastColumn;
+	if (info.movement_.x < -kMapChipBlockWidth) {
+		column = static_cast<int32_t>(GetMapChipIndexSetByPosition(CornerPosition(position_, kLeftTop)).xIndex) - 1;
+	}
+	for (; column >= lastColumn; --column) {
+		if (map_->AnyInRect(MapChipPlane::kSolid, column, top, column, bottom)) {
+			// 今すでに掛かっている列なら、左壁への遷移ではない
+			if (GetMapChipIndexSetByPosition(CornerPosition(position_, kLeftTop)).xIndex == static_cast<uint32_t>(column)) {
+				return;
+			}
+
+			// 左壁の許容移動量（壁外側に押し戻さないクランプ）
+			float requested = info.movement_.x;
+			float dxAllowed = (GetTileRight(static_cast<uint32_t>(column)) + kBlank) - (position_.x - kWidth * 0.5f);
+			info.movement_.x = std::min(0.0f, std::max(info.movement_.x, dxAllowed));
+			info.timeOfImpactX_ = TimeOfImpact(info.movement_.x, requested);
+
+			info.isWallContact_ = true;
+			info.wallSide_ = WallSide::kLeft;
+			return;
+		}
+	}
+}
+
+void PlayerPhysics::HandleMapCollisionRight(CollisionMapInfo& info) {
+	if (info.movement_.x <= 0.0f) {
+		return;
+	}
+	PlayerVector2 positionNew = {position_.x + info.movement_.x, position_.y + info.movement_.y};
+
+	// 右上点から右下点までのタイル列をチェック（上の行ほど yIndex が小さい）
+	IndexSet indexSet = GetMapChipIndexSetByPosition(CornerPosition(positionNew, kRightTop));
+	IndexSet indexSetBottom = GetMapChipIndexSetByPosition(CornerPosition(positionNew, kRightBottom));
+	int32_t top = static_cast<int32_t>(indexSet.yIndex);
+	int32_t bottom = static_cast<int32_t>(indexSetBottom.yIndex);
+	int32_t lastColumn = static_cast<int32_t>(indexSet.xIndex);
+
+	// 1 タイルを超える移動なら、右辺が通過する列を今の列の 1 つ右から手前から順に調べる（壁をすり抜けない）
+	int32_t column = lastColumn;
+	if (info.movement_.x > kMapChipBlockWidth) {
+		column = static_cast<int32_t>(GetMapChipIndexSetByPosition(CornerPosition(position_, kRightTop)).xIndex) + 1;
+	}
+	for (; column <= lastColumn; ++column) {
+		if (map_->AnyInRect(MapChipPlane::kSolid, column, top, column, bottom)) {
+			// 今すでに掛かっている列なら、右壁への遷移ではない
+			if (GetMapChipIndexSetByPosition(CornerPosition(position_, kRightTop)).xIndex == static_cast<uint32_t>(column)) {
+				return;
+			}
+
+			// 右壁の許容移動量（壁外側に押し戻さないクランプ）
+			float requested = info.movement_.x;
+			float dxAllowed = (GetTileLeft(static_cast<uint32_t>(column)) - kBlank) - (position_.x + kWidth * 0.5f);
+			info.movement_.x = std::max(0.0f, std::min(info.movement_.x, dxAllowed));
+			info.timeOfImpactX_ = TimeOfImpact(info.movement_.x, requested);
+
+			info.isWallContact_ = true;
+			info.wallSide_ = WallSide::kRight;
+			return;
+		}
+	}
+}
+
+void PlayerPhysics::UpdateWallSlide(const PlayerInput& input, const CollisionMapInfo& info) {
+
+	// クールダウン減算
+	if (wallJumpCooldown_ > 0.0f) {
+		wallJumpCooldown_ -= kDeltaTime;
+		wallJumpCooldown_ = std::max(wallJumpCooldown_, 0.0f);
+	}
+
+	isWallSliding_ = false;
+	if (onGround_) {
+		prevWallSide_ = WallSide::kNone;
+		return;
+	}
+
+	if (info.isWallContact_ && velocity_.y < 0.0f) {
+		if (IsPressingTowardWall(input, info.wallSide_)) {
+			isWallSliding_ = true;
+			velocity_.y = std::max(velocity_.y, -kWallSlideMaxFallSpeed);
+
+			// 壁を切り替えたら即ジャンプできるようにクールダウン解除
+			if (prevWallSide_ != info.wallSide_) {
+				wallJumpCooldown_ = 0.0f;
+			}
+		}
+	}
+
+	prevWallSide_ = info.wallSide_;
+}
+
+void PlayerPhysics::HandleWallJump(const PlayerInput& input, const CollisionMapInfo& info) {
+	if (onGround_) {
+		return;
+	}
+
+	bool canWallJump = (isWallSliding_ || info.isWallContact_);
+	if (!canWallJump) {
+		return;
+	}
+
+	// 入力緩和：ジャンプ押しっぱでも短時間なら再入力扱い
+	if (input.jumpKey || input.jumpButton) {
+		wallJumpBufferTimer_ = kWallJumpBufferTime;
+	} else {
+		wallJumpBufferTimer_ -= kDeltaTime;
+		wallJumpBufferTimer_ = std::max(wallJumpBufferTimer_, 0.0f);
+	}
+
+	// 制限：壁ジャンプ回数を超えないようにする
+	if (wallJumpBufferTimer_ > 0.0f && wallJumpCooldown_ <= 0.0f && wallJumpCount_ < kMaxWallJumps) {
+
+		// 1回目と2回目で挙動を少し変える
+		float horizSpeed = (wallJumpCount_ == 0) ? kWallJumpHorizontalSpeed : kWallJumpHorizontalSpeed2;
+		float vertSpeed = (wallJumpCount_ == 0) ? kWallJumpVerticalSpeed : kWallJumpVerticalSpeed2;
+
+		// 接触壁の反対方向へ跳ねる
+		if (info.wallSide_ == WallSide::kLeft) {
+			velocity_.x = +horizSpeed;
+			lrDirection_ = PlayerDirection::kRight;
+		} else if (info.wallSide_ == WallSide::kRight) {
+			velocity_.x = -horizSpeed;
+			lrDirection_ = PlayerDirection::kLeft;
+		}
+
+		// 上方向へ加速
+		velocity_.y = vertSpeed;
+
+		// 壁ジャンプ直後の横方向制御をやわらかくするために減衰をかける
+		velocity_.x *= kWallJumpHorizontalDamp;
+
+		isWallSliding_ = false;
+
+		// 壁ジャンプはジャンプ回数を1にする（空中での二段ジャンプを一回許可）
+		jumpCount_ = 1;
+
+		// プレイヤーの入力に応じて微調整を許可（操作性向上）
+		if (input.left) {
+			velocity_.x -= 0.15f;
+		}
+		if (input.right) {
+			velocity_.x += 0.15f;
+		}
+
+		// 旋回演出（向きが変わらなくても行う）
+		events_.turnStarted = true;
+
+		// 連続発動防止
+		wallJumpCooldown_ = kWallJumpCooldownTime;
+		wallJumpBufferTimer_ = 0.0f; // 消費
+
+		// カウントを増やす
+		wallJumpCount_ = std::min(wallJumpCount_ + 1, kMaxWallJumps);
+
+		PHYSICS_TRACE(PhysicsTraceId::kWallJump, stepCount_, static_cast<float>(info.wallSide_), static_cast<float>(wallJumpCount_), velocity_.x, velocity_.y);
+	}
+}
+
+IndexSet PlayerPhysics::GetMapChipIndexSetByPosition(const PlayerVector2& position) const {
+	// MapChipSnapshot::GetMapChipIndexSetByPosition と同じ計算（マップ外の負の値は符号なしに折り返し、範囲外として扱われる）
+	IndexSet indexSet = {};
+	indexSet.xIndex = static_cast<uint32_t>(static_cast<int64_t>(std::floor((position.x + kMapChipBlockWidth * 0.5f) / kMapChipBlockWidth)));
+	uint32_t preFlipYIndex = static_cast<uint32_t>(static_cast<int64_t>(std::floor((position.y + kMapChipBlockHeight * 0.5f) / kMapChipBlockHeight)));
+	indexSet.yIndex = numBlockVertical_ - 1 - preFlipYIndex;
+	return indexSet;
+}
+
+bool PlayerPhysics::TestPlane(MapChipPlane plane, uint32_t xIndex, uint32_t yIndex) const {
+	if (xIndex >= numBlockHorizontal_ || yIndex >= numBlockVertical_) {
+		return false;
+	}
+	int32_t x = static_cast<int32_t>(xIndex);
+	int32_t y = static_cast<int32_t>(yIndex);
+	return map_->AnyInRect(plane, x, y, x, y);
+}
+
+// タイルの上下左右の端（MapChipSnapshot::GetRectByIndex と同じ計算）
+
+float PlayerPhysics::GetTileTop(uint32_t yIndex) const { return kMapChipBlockHeight * (numBlockVertical_ - 1 - yIndex) + kMapChipBlockHeight * 0.5f; }
+
+float PlayerPhysics::GetTileBottom(uint32_t yIndex) const { return kMapChipBlockHeight * (numBlockVertical_ - 1 - yIndex) - kMapChipBlockHeight * 0.5f; }
+
+float PlayerPhysics::GetTileLeft(uint32_t xIndex) const { return kMapChipBlockWidth * xIndex - kMapChipBlockWidth * 0.5f; }
+
+float PlayerPhysics::GetTileRight(uint32_t xIndex) const { return kMapChipBlockWidth * xIndex + kMapChipBlockWidth * 0.5f; }
+
+float PlayerPhysics::GetFrictionCoefficientByPosition(const PlayerVector2& position) const {
+	IndexSet index = GetMapChipIndexSetByPosition(position);
+	return GetMapChipProperty(map_->GetMapChipTypeByIndex(index.xIndex, index.yIndex)).friction;
+}
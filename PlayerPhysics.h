@@ -0,0 +1,372 @@
+#pragma once
+
+#include "MapChipType.h"
+
+#include <cstdint>
+
+// プレイヤーの移動・ジャンプ・壁滑り・梯子・マップとの当たり判定（エンジン非依存）
+// 1 フレーム分の入力 (PlayerInput) とマップへの問い合わせ (PlayerMapQuery) を受け取り、位置・速度・状態を進める
+// Player はキーボード・パッドの状態を PlayerInput に詰めて Step を呼び、結果とイベントでモデル・音・カメラを更新するだけ
+// KamataEngine を含まないので、Windows 以外でも単体でビルドして動かせる（Tools/PlayerPhysicsBench）
+
+struct PlayerVector2 {
+	float x;
+	float y;
+};
+
+enum class PlayerDirection {
+	kRight,
+	kLeft,
+};
+
+enum class WallSide {
+	kNone,
+	kLeft,
+	kRight,
+};
+
+/// <summary>
+/// 1 フレーム分の入力（押されているかどうかだけを持つ。押した瞬間の判定は PlayerPhysics が前フレームと比べて行う）
+/// </summary>
+struct PlayerInput {
+	float stickX = 0.0f; // 左スティック（デッドゾーン適用済み。-1.0f ～ 1.0f、右・上が正）
+	float stickY = 0.0f;
+	bool left = false;   // ← / A
+	bool right = false;  // → / D
+	bool up = false;     // W（梯子を上る）
+	bool down = false;   // S（梯子を下りる）
+	bool jumpKey = false;      // ↑ / SPACE
+	bool jumpButton = false;   // パッドの A
+	bool dodgeKey = false;     // Q
+	bool dodgeButton = false;  // パッドの左トリガー
+	bool attackKey = false;    // E
+	bool attackButton = false; // パッドの右トリガー
+};
+
+/// <summary>
+/// PlayerPhysics が使うマップへの問い合わせ（タイル座標。y は上の行が 0）
+/// ゲームでは MapChipField を、ツールではタイル配列を包んで渡す
+/// </summary>
+class PlayerMapQuery {
+public:
+	virtual ~PlayerMapQuery() = default;
+
+	virtual uint32_t GetNumBlockHorizontal() const = 0;
+	virtual uint32_t GetNumBlockVertical() const = 0;
+
+	/// <summary>
+	/// マップチップ種別（範囲外は kBlank）
+	/// </summary>
+	virtual MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) const = 0;
+
+	/// <summary>
+	/// タイル矩形 [x0, x1] x [y0, y1] にビットプレーンのタイルが 1 つでもあるか（マップ内にクリップ。負の値も可）
+	/// </summary>
+	virtual bool AnyInRect(MapChipPlane plane, int32_t x0, int32_t y0, int32_t x1, int32_t y1) const = 0;
+};
+
+/// <summary>
+/// Step の中で起きた、見た目や音に反映する出来事
+/// </summary>
+struct PlayerPhysicsEvents {
+	bool jumped = false;        // 地上・空中ジャンプ（壁ジャンプは含まない）
+	bool dodgeStarted = false;  // 緊急回避の開始
+	bool attackStarted = false; // 攻撃の開始
+	bool turnStarted = false;   // 向きが変わった（旋回の演出を始める）
+	bool hitCeiling = false;    // 天井に当たった
+};
+
+struct CollisionMapInfo {
+	bool isCeilingCollision_ = false; // 天井衝突
+	bool isLanding_ = false;          // 着地
+	bool isWallContact_ = false;      // 壁接触
+	PlayerVector2 movement_ = {};
+	WallSide wallSide_ = WallSide::kNone; // どちらの壁に接触しているか
+	// 要求した移動量のうち、タイルに当たるまでに進めた割合（軸ごと。当たらなければ 1）
+	float timeOfImpactX_ = 1.0f;
+	float timeOfImpactY_ = 1.0f;
+};
+
+class PlayerPhysics {
+public:
+	enum class Behavior {
+		kUnknown,
+		kRoot,   // 通常
+		kAttack, // 攻撃
+	};
+
+	// 角
+	enum Corner {
+		kLeftTop,     // 左上
+		kRightTop,    // 右上
+		kLeftBottom,  // 左下
+		kRightBottom, // 右下
+
+		kNumCorners, // 要素数
+	};
+
+	// 1 回の Step で進める時間（秒）
+	static constexpr float kDeltaTime = 1.0f / 60.0f;
+
+	// キャラクターの当たり判定サイズ
+	static inline const float kWidth = 0.8f * 2.0f;
+	static inline const float kHeight = 0.8f * 2.0f;
+
+	// しゃがみ中の見た目の高さの倍率（Y 方向）
+	static inline const float kCrouchVisualScale = 0.6f;
+	// しゃがみ中に当たり判定で使う高さの倍率
+	static inline const float kCrouchHeightMultiplier = 0.5f;
+
+	/// <summary>
+	/// 状態を初期化する
+	/// </summary>
+	/// <param name="position">中心のワールド座標</param>
+	/// <param name="visualScaleY">モデルの Y スケール（しゃがみで見た目の高さが変わった分だけ位置をずらすのに使う）</param>
+	void Initialize(const PlayerVector2& position, float visualScaleY);
+
+	void SetMapQuery(const PlayerMapQuery* map) { map_ = map; }
+
+	/// <summary>
+	/// 1 フレーム進める
+	/// </summary>
+	PlayerPhysicsEvents Step(const PlayerInput& input);
+
+	const PlayerVector2& GetPosition() const { return position_; }
+	const PlayerVector2& GetVelocity() const { return velocity_; }
+	void SetVelocity(const PlayerVector2& velocity) { velocity_ = velocity; }
+
+	PlayerDirection GetDirection() const { return lrDirection_; }
+
+	bool IsOnGround() const { return onGround_; }
+	bool IsOnLadder() const { return onLadder_; }
+	bool IsWallSliding() const { return isWallSliding_; }
+	bool IsDodging() const { return isDodging_; }
+	bool IsCrouching() const { return isCrouching_; }
+	bool IsAttacking() const { return behavior_ == Behavior::kAttack; }
+
+	/// <summary>
+	/// 見た目の Y スケールの倍率（しゃがみ中は kCrouchVisualScale）
+	/// </summary>
+	float GetVisualScaleMultiplier() const { return isCrouching_ ? kCrouchVisualScale : 1.0f; }
+
+	/// <summary>
+	/// 直前のフレームの当たり判定の結果（デバッグ表示用）
+	/// </summary>
+	const CollisionMapInfo& GetLastCollision() const { return lastCollision_; }
+
+	/// <summary>
+	/// ジャンプの入力を押しっぱなし扱いにして、次のフレームで押した瞬間と判定しないようにする
+	/// </summary>
+	void SuppressNextJump();
+
+private:
+	const PlayerMapQuery* map_ = nullptr;
+
+	// Step の最初に map_ から写したマップの大きさ
+	uint32_t numBlockHorizontal_ = 0;
+	uint32_t numBlockVertical_ = 0;
+
+	PlayerVector2 position_ = {};
+	PlayerVector2 velocity_ = {};
+	float visualScaleY_ = 1.0f;
+
+	// Initialize からの Step の回数（PhysicsTrace のフレーム番号）
+	uint32_t stepCount_ = 0;
+
+	PlayerDirection lrDirection_ = PlayerDirection::kRight;
+
+	// 現在の行動状態
+	Behavior behavior_ = Behavior::kRoot;
+	Behavior behaviorRequest_ = Behavior::kUnknown;
+
+	PlayerPhysicsEvents events_;
+	CollisionMapInfo lastCollision_;
+
+	#pragma region 地上での移動関係
+
+	// 加速量
+	static inline const float kAcceleration = 0.01f;
+	// 横移動の最大速度
+	static inline const float kLimitRunSpeed = 0.2f;
+
+	#pragma endregion 地上での移動関係
+
+	#pragma region 梯子での移動関係
+	// 空中での横移動加速度（地上より弱め）
+	static inline const float kAirAcceleration = kAcceleration;
+	// 空中での最大横移動速度（地上より少し低め）
+	static inline const float kAirLimitRunSpeed = kLimitRunSpeed;
+	#pragma region 梯子での移動関係
+
+	#pragma region ジャンプ関係
+
+	// ジャンプ用の上向き速度（地上からの一段目）
+	// 固定値で上向き速度を設定することで、二段ジャンプの高さが入力時の落下速度に依存しないようにする
+	static inline const float kJumpVelocityGround = 0.55f;
+	// 空中での二段ジャンプ時の上向き速度（地上ジャンプよりやや小さめに）
+	static inline const float kJumpVelocityAir = 0.7f;
+
+	#pragma endregion ジャンプ関係
+
+	// 速度減衰（慣性制御）
+	// 値を増やして慣性を減らす（入力停止時にすばやく速度を落とす）
+	static inline const float kAttenuation = 0.25f;
+
+	// ジャンプ直後の横方向ダンピング（地上からジャンプしたときの横慣性を抑える）
+	static inline const float kJumpHorizontalDamp = 0.7f;
+
+	// 接地状態フラグ
+	bool onGround_ = true;
+
+	// Ladder state
+	bool onLadder_ = false;
+
+	// 重力加速度(下方向)
+	static inline const float kGravityAcceleration = 0.05f;
+
+	// はしご登り速度
+	static inline const float kClimbSpeed = 0.12f;
+
+	// はしご上での横移動速度許容
+	static inline const float kLadderHorizontalSpeed = 0.18f; // reduced for gentler movement
+	// はしご上での横移動の補間係数（0-1）。値が小さいほどゆっくり移動を反映する（緩め）
+	static inline const float kLadderHorizontalAccel = 0.06f; // smaller -> slower response (more 'Minecraft'-like)
+
+	// Grounding debounce: how many consecutive misses before leaving ground
+	static inline const int kGroundMissThreshold = 2;
+	int groundMissCount_ = 0;
+
+	// 最大落下速度(下方向)
+	static inline const float kLimitFallSpeed = 5.0f;
+
+	static inline const float kBlank = 0.1f * 2.0f;
+
+	// 着地時の速度減衰率
+	static inline const float kAttenuationLanding = 0.35f;
+
+	// --- 壁けり関連 ---
+	bool isWallSliding_ = false;
+	float wallJumpCooldown_ = 0.0f; // 同一入力で連続発動しないためのクールダウン
+	// 前フレームに接触していた壁（壁を切り替えたらクールダウンを解除する）
+	WallSide prevWallSide_ = WallSide::kNone;
+	// 入力緩和：ジャンプ押しっぱでも短時間なら再入力扱い
+	float wallJumpBufferTimer_ = 0.0f;
+
+	static inline const float kWallJumpHorizontalSpeed = 0.6f; // 壁から離れるX速度
+	// Reduced vertical speeds so wall-jump reaches lower height than double jump
+	static inline const float kWallJumpVerticalSpeed = 0.55f; // 壁けり時のY速度 (reduced)
+
+	static inline const float kWallJumpHorizontalSpeed2 = 0.3f; // second jump horizontal
+	static inline const float kWallJumpVerticalSpeed2 = 0.45f;  // second jump vertical
+
+	static inline const float kWallSlideMaxFallSpeed = 3.0f;  // 壁滑り中の最大落下速度
+	static inline const float kWallJumpCooldownTime = 0.1f;   // クールダウン時間(秒) (reduced)
+	static inline const float kWallJumpHorizontalDamp = 0.6f;
+	static inline const float kWallJumpBufferTime = 0.15f; // この時間内ならジャンプ受付
+
+	int wallJumpCount_ = 0;
+	static inline const int kMaxWallJumps = 2;
+
+	WallSide lastWallSide_ = WallSide::kNone;
+
+	static inline const float kWallContactGraceTime = 0.1f;
+	float wallContactGraceTimer_ = 0.0f;
+
+	//攻撃ギミックの経過時間
+	uint32_t attackParameter_ = 0;
+
+	float static inline const kAttackDuration = 10; // 攻撃動作の継続時間(フレーム)
+
+	// 攻撃時の短距離ダッシュ設定
+	static inline const float kAttackDashSpeed = 1.5f; // 攻撃開始時のダッシュ速度
+	static inline const int kAttackDashFrames = 6;     // ダッシュが続くフレーム数
+	// 攻撃クールタイム
+	float attackCooldown_ = 0.0f;
+	static inline const float kAttackCooldownTime = 1.0f; // seconds (debug)
+
+	// 攻撃入力のバッファ（クールタイム明け直後の入力取りこぼし回避）
+	float attackInputBufferTimer_ = 0.0f;
+	static inline const float kAttackInputBufferTime = 0.18f; // seconds
+
+	// 二段ジャンプ関連
+	static inline const int kMaxJumps = 2; // 最大ジャンプ回数（地上から含む）
+	int jumpCount_ = 0;                    // 現在のジャンプ回数
+
+	// 押した瞬間の判定用の前フレームの入力
+	bool prevAButtonPressed_ = false;
+	bool prevJumpKeyPressed_ = false;
+	bool prevDodgeKeyPressed_ = false;
+	bool prevDodgeButtonPressed_ = false;
+	bool prevAttackKeyPressed_ = false;
+	bool prevAttackButtonPressed_ = false;
+
+	// --- Emergency dodge (Eキー) ---
+	bool isDodging_ = false;
+	float dodgeTimer_ = 0.0f;
+	float dodgeCooldown_ = 0.0f;
+	static inline const float kDodgeDuration = 0.15f;     // seconds
+	static inline const float kDodgeSpeed = 2.0f;         // dash speed
+	static inline const float kDodgeCooldownTime = 0.5f;  // seconds
+
+	bool onIce_ = false; // 現在接地しているタイルがIceかどうか
+
+	// --- Crouch (Qキー) ---
+	bool isCrouching_ = false;
+	// If crouch was started by a dodge/roll (temporary), remember to restore when dodge ends
+	bool crouchForcedByDodge_ = false;
+
+	void HandleMovementInput(const PlayerInput& input);
+
+	void SetDirection(PlayerDirection direction);
+
+	/// <summary>
+	/// しゃがみの切り替え。足元の高さが変わらないよう、見た目の高さの差だけ位置をずらす
+	/// </summary>
+	void SetCrouching(bool crouching);
+
+	void BehaviorAttackInitialize();
+	void BehaviorAttackUpdate();
+
+	PlayerVector2 CornerPosition(const PlayerVector2& center, Corner corner) const;
+
+	void MapChipCollisionCheck(CollisionMapInfo& info);
+
+	/// <summary>
+	/// 判定結果を反映して移動する場合の処理
+	/// </summary>
+	void JudgmentResult(const CollisionMapInfo& info);
+
+	/// <summary>
+	/// 天井に接触している場合の処理
+	/// </summary>
+	void HitCeilingCollision(const CollisionMapInfo& info);
+
+	/// <summary>
+	/// 壁に接触している場合の処理
+	/// </summary>
+	void HitWallCollision(const CollisionMapInfo& info);
+
+	/// <summary>
+	/// 接地状態の切り替え処理
+	/// </summary>
+	void SwitchingTheGrounding(const CollisionMapInfo& info);
+
+	void HandleMapCollisionUp(CollisionMapInfo& info);
+	void HandleMapCollisionDown(CollisionMapInfo& info);
+	void HandleMapCollisionLeft(CollisionMapInfo& info);
+	void HandleMapCollisionRight(CollisionMapInfo& info);
+
+	// 壁滑り・壁ジャンプ
+	void UpdateWallSlide(const PlayerInput& input, const CollisionMapInfo& info);
+	void HandleWallJump(const PlayerInput& input, const CollisionMapInfo& info);
+
+	// ---- マップの座標変換（MapChipSnapshot と同じ計算） ----
+
+	IndexSet GetMapChipIndexSetByPosition(const PlayerVector2& position) const;
+	bool TestPlane(MapChipPlane plane, uint32_t xIndex, uint32_t yIndex) const;
+	float GetTileTop(uint32_t yIndex) const;
+	float GetTileBottom(uint32_t yIndex) const;
+	float GetTileLeft(uint32_t xIndex) const;
+	float GetTileRight(uint32_t xIndex) const;
+	float GetFrictionCoefficientByPosition(const PlayerVector2& position) const;
+};
@@ -7,6 +7,7 @@
 #include "MapChipField.h"
 #include "CameraController.h"
 #include "Fade.h"
+#include "FrameClock.h"
 #include "Skydome.h"
 
 #include <algorithm>
@@ -119,7 +120,7 @@ void SelectScene::Initialize() {
     
     mapChipField_ = new MapChipField();
     
-    mapChipField_->LoadMapChipCsv("Resources/Map/SelectScene/SelectScene.csv");
+    mapChipField_->LoadMapChip("Resources/Map/SelectScene/SelectScene.csv");
 
     
     blockModel_ = Model::CreateFromOBJ("Block");
@@ -202,8 +203,8 @@ void SelectScene::Initialize() {
         worldTransformBlocks_.assign(vh, std::vector<WorldTransform*>(wh, nullptr));
         for (uint32_t y = 0; y < vh; ++y) {
             for (uint32_t x = 0; x < wh; ++x) {
-                MapChipType t = mapChipField_->GetMapChipTypeByIndex(x, y);
-                if (t == MapChipType::kBlock || t == MapChipType::kIce) {
+                MapChipModel model = GetMapChipProperty(mapChipField_->GetMapChipTypeByIndexUnchecked(x, y)).model;
+                if (model != MapChipModel::kNone) {
                     WorldTransform* wt = new WorldTransform();
                     wt->Initialize();
                     wt->translation_ = mapChipField_->GetMapChipPositionByIndex(x, y);
@@ -213,20 +214,16 @@ void SelectScene::Initialize() {
         }
 
          std::vector<WorldTransform*> tmpStageWts;
-        for (uint32_t y = 0; y < vh; ++y) {
-            for (uint32_t x = 0; x < wh; ++x) {
-                if (mapChipField_->GetMapChipTypeByIndex(x, y) == MapChipType::kStage) {
-                    Vector3 pos = mapChipField_->GetMapChipPositionByIndex(x, y);
-                    WorldTransform* swt = new WorldTransform();
-                    swt->Initialize();
-                    swt->translation_ = pos;
-                    // push stage node slightly behind the player (player z=0, negative is closer)
-                    // so use small positive z to place behind
-                    swt->translation_.z += 1.0f;
-                    swt->scale_ = {1.0f, 1.0f, 1.0f};
-                    tmpStageWts.push_back(swt);
-                }
-            }
+        for (const IndexSet& index : mapChipField_->GetSpawnTiles(MapChipType::kStage)) {
+            Vector3 pos = mapChipField_->GetMapChipPositionByIndex(index.xIndex, index.yIndex);
+            WorldTransform* swt = new WorldTransform();
+            swt->Initialize();
+            swt->translation_ = pos;
+            // push stage node slightly behind the player (player z=0, negative is closer)
+            // so use small positive z to place behind
+            swt->translation_.z += 1.0f;
+            swt->scale_ = {1.0f, 1.0f, 1.0f};
+            tmpStageWts.push_back(swt);
         }
 
         std::sort(tmpStageWts.begin(), tmpStageWts.end(), [](const WorldTransform* a, const WorldTransform* b) {
@@ -279,17 +276,9 @@ void SelectScene::Initialize() {
     Vector3 startPos = {4.0f, 4.0f, 0.0f};
     
     if (mapChipField_) {
-        uint32_t vh = mapChipField_->GetNumBlockVertical();
-        uint32_t wh = mapChipField_->GetNumBlockHorizontal();
-        bool found = false;
-        for (uint32_t y = 0; y < vh && !found; ++y) {
-            for (uint32_t x = 0; x < wh; ++x) {
-                if (mapChipField_->GetMapChipTypeByIndex(x, y) == MapChipType::kReserved2) {
-                    startPos = mapChipField_->GetMapChipPositionByIndex(x, y);
-                    found = true;
-                    break;
-                }
-            }
+        std::span<const IndexSet> starts = mapChipField_->GetSpawnTiles(MapChipType::kReserved2);
+        if (!starts.empty()) {
+            startPos = mapChipField_->GetMapChipPositionByIndex(starts.front().xIndex, starts.front().yIndex);
         }
     }
 
@@ -326,7 +315,7 @@ static KamataEngine::Vector3 LerpV(const KamataEngine::Vector3& a, const KamataE
 void SelectScene::Update() {
     
     
-    if (inputTimer_ > 0.0f) inputTimer_ -= 1.0f / 60.0f;
+    if (inputTimer_ > 0.0f) inputTimer_ -= FrameClock::GetInstance()->GetDeltaTime();
 
     // Ensure BGM has started once
     if (!bgmStarted_) {
@@ -365,7 +354,7 @@ void SelectScene::Update() {
     // camera update
     if (transitioning_) {
         // drive camera along transition
-        transitionTimer_ -= 1.0f / 60.0f;
+        transitionTimer_ -= FrameClock::GetInstance()->GetDeltaTime();
         float clamped = (transitionTimer_ < 0.0f) ? 0.0f : transitionTimer_;
         transitionProgress_ = 1.0f - (clamped / transitionDuration_);
         // ease in-out (smoothstep)
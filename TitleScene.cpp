@@ -1,6 +1,7 @@
 #include "TitleScene.h"
 #include "MathUtl.h"
 #include "KeyInput.h"
+#include "FrameClock.h"
 #include <cassert>
 #include <numbers>
 #include <algorithm>
@@ -97,7 +98,7 @@ void TitleScene::Initialize() {
 
 void TitleScene::Update() {
 
-    const float dt = 1.0f / 60.0f;
+    const float dt = FrameClock::GetInstance()->GetDeltaTime();
 
     // Ensure BGM has started once
     if (!bgmStarted_) {
@@ -0,0 +1,227 @@
+// ブロック描画のチャンクストリーミング (BlockChunkStreamer) の常駐数を確かめるツール
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /Fe:BlockChunkBench.exe Tools\BlockChunkBench.cpp BlockChunkStreamer.cpp MapChipSnapshot.cpp MapChipBitPlanes.cpp MapChipTileStore.cpp MapChipFormat.cpp
+//
+// 使い方
+//   BlockChunkBench [<width> <height>]     既定は 100000 x 96
+//
+// 乱数で作った横長のマップ（decoration レイヤー付き）の上で、BlockChunkManager と同じ設定のまま
+//   1. 左端の外から右端の外まで、上下に揺らしながらゆっくりカメラを動かす
+//   2. 右端から左端まで速く戻る（1 回の Update で複数のチャンクをまたぐ）
+//   3. マップの両端を行き来する・マップの外へ出る
+// を行い、毎回の Update の後で次を確かめる。1 つでも崩れれば終了コード 1 を返す
+//   常駐チャンク数・常駐ブロック数が、読み込み半径から決まる上限を超えない
+//   作ったスロット（ゲームでは WorldTransform）の数も同じ上限を超えない（解放したものを再利用している）
+//   ストリーマーが確保しているバイト数も、上限の個数から決まるバイト数を超えない（マップの幅に依らない）
+//   マップの外では常駐チャンクが 0 になる
+// あわせて 1 回の Update の平均と最大の時間を表示する
+//
+// ストリーミングするのはブロックの描画リソースだけで、マップのデータ（MapChipSnapshot）はステージ全体を常駐させる
+// そのバイト数はマップの幅に比例するので、上限の確認には含めず参考として表示する（MAPCHIP_STORE_RUN_LENGTH で小さくなる）
+
+#include "BlockChunkStreamer.h"
+#include "MapChipFormat.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <random>
+
+namespace {
+
+constexpr uint32_t kDefaultWidth = 100000;
+constexpr uint32_t kDefaultHeight = 96;
+
+// ゆっくり進むときと速く戻るときの 1 フレームの移動量（ワールド座標）と、上下の揺れ幅
+constexpr float kSlowStep = 0.5f;
+constexpr float kFastStep = 7.0f;
+constexpr float kBobAmplitude = 30.0f;
+
+/// <summary>
+/// 下の数行を地面にし、残りに 3 割ほどブロック・氷を散らしたマップ（decoration レイヤーにも少し置く）
+/// </summary>
+MapChipStage GenerateStage(uint32_t width, uint32_t height) {
+	std::mt19937 rng(12345);
+	MapChipStage stage;
+	stage.collision.width = width;
+	stage.collision.height = height;
+	stage.collision.tiles.resize(static_cast<size_t>(width) * height, MapChipType::kBlank);
+	MapChipLayerGrid decoration = {kMapChipDecorationLayerName, std::vector<MapChipType>(stage.collision.tiles.size(), MapChipType::kBlank)};
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			size_t i = static_cast<size_t>(y) * width + x;
+			if (y + 3 >= height) {
+				stage.collision.tiles[i] = MapChipType::kBlock;
+			} else if (rng() % 10 < 3) {
+				stage.collision.tiles[i] = rng() % 4 == 0 ? MapChipType::kIce : MapChipType::kBlock;
+			}
+			if (rng() % 20 == 0) {
+				decoration.tiles[i] = MapChipType::kBlock;
+			}
+		}
+	}
+	stage.layers.push_back(std::move(decoration));
+	return stage;
+}
+
+struct Bounds {
+	size_t chunks;
+	size_t blocks;
+	size_t bytes;
+};
+
+/// <summary>
+/// 常駐数の上限。解放は読み込み半径 + kUnloadMargin の外で行うので、常駐チャンクはその範囲に掛かるものに限られる
+/// 1 チャンクのブロックは当たり判定レイヤーと decoration レイヤーで最大 2 * kChunkSize^2
+/// バイト数は配列の伸長で容量が要素数の 2 倍まで増えるとして数える（空きスロットと直前に置いたブロックもブロック数の上限を超えない）
+/// </summary>
+Bounds ComputeBounds(const MapChipSnapshot& map, float loadRadius) {
+	const uint32_t size = BlockChunkStreamer::kChunkSize;
+	const float reach = loadRadius + BlockChunkStreamer::kUnloadMargin;
+	uint32_t tilesX = static_cast<uint32_t>(std::ceil(2.0f * reach / MapChipSnapshot::GetBlockWidth())) + 1;
+	uint32_t tilesY = static_cast<uint32_t>(std::ceil(2.0f * reach / MapChipSnapshot::GetBlockHeight())) + 1;
+	size_t chunksX = std::min<size_t>(tilesX / size + 2, (map.GetNumBlockHorizontal() + size - 1) / size);
+	size_t chunksY = std::min<size_t>(tilesY / size + 2, (map.GetNumBlockVertical() + size - 1) / size);
+	size_t chunks = chunksX * chunksY;
+	size_t blocks = chunks * size * size * 2;
+	size_t bytes = 2 * (chunks * sizeof(BlockChunkStreamer::Chunk) + blocks * (2 * sizeof(BlockChunkStreamer::Block) + sizeof(uint32_t)));
+	return {chunks, blocks, bytes};
+}
+
+class Walker {
+public:
+	Walker(const MapChipSnapshot& map, Bounds bounds) : map_(map), bounds_(bounds) {}
+
+	/// <summary>
+	/// カメラを center に置いて 1 回 Update し、常駐数を確かめる
+	/// </summary>
+	bool Step(const KamataEngine::Vector3& center) {
+		auto start = std::chrono::steady_clock::now();
+		streamer_.Update(map_, center);
+		auto end = std::chrono::steady_clock::now();
+		double ns = std::chrono::duration<double, std::nano>(end - start).count();
+		totalNs_ += ns;
+		maxNs_ = std::max(maxNs_, ns);
+		++updates_;
+
+		size_t chunks = streamer_.GetResidentChunkCount();
+		size_t blocks = streamer_.GetResidentBlockCount();
+		size_t bytes = streamer_.GetResidentBytes();
+		maxChunks_ = std::max(maxChunks_, chunks);
+		maxBlocks_ = std::max(maxBlocks_, blocks);
+		maxBytes_ = std::max(maxBytes_, bytes);
+		if (chunks > bounds_.chunks || blocks > bounds_.blocks || streamer_.GetSlotCount() > bounds_.blocks || bytes > bounds_.bytes) {
+			std::fprintf(stderr, "camera (%.1f, %.1f): %zu chunks, %zu blocks, %u slots, %zu bytes exceed the bound (%zu chunks, %zu blocks, %zu bytes)\n", center.x, center.y,
+			             chunks, blocks, streamer_.GetSlotCount(), bytes, bounds_.chunks, bounds_.blocks, bounds_.bytes);
+			return false;
+		}
+		return true;
+	}
+
+	bool ExpectEmpty(const char* where) const {
+		if (streamer_.GetResidentChunkCount() != 0) {
+			std::fprintf(stderr, "%s: %zu chunks still resident outside the map\n", where, streamer_.GetResidentChunkCount());
+			return false;
+		}
+		return true;
+	}
+
+	void Print() const {
+		std::printf("  resident : max %zu chunks (bound %zu), max %zu blocks (bound %zu)\n", maxChunks_, bounds_.chunks, maxBlocks_, bounds_.blocks);
+		std::printf("  bytes    : max %zu (bound %zu)\n", maxBytes_, bounds_.bytes);
+		std::printf("  slots    : %u created, %zu free at the end\n", streamer_.GetSlotCount(), streamer_.GetFreeSlotCount());
+		std::printf("  update   : %zu calls, avg %.1f ns, max %.1f us\n", updates_, totalNs_ / static_cast<double>(updates_), maxNs_ / 1000.0);
+	}
+
+private:
+	const MapChipSnapshot& map_;
+	Bounds bounds_;
+	BlockChunkStreamer streamer_;
+
+	size_t maxChunks_ = 0;
+	size_t maxBlocks_ = 0;
+	size_t maxBytes_ = 0;
+	size_t updates_ = 0;
+	double totalNs_ = 0.0;
+	double maxNs_ = 0.0;
+};
+
+bool Walk(const MapChipSnapshot& map) {
+	const float mapWidth = static_cast<float>(map.GetNumBlockHorizontal()) * MapChipSnapshot::GetBlockWidth();
+	const float mapHeight = static_cast<float>(map.GetNumBlockVertical()) * MapChipSnapshot::GetBlockHeight();
+	const float margin = BlockChunkStreamer::kDefaultLoadRadius + BlockChunkStreamer::kUnloadMargin + MapChipSnapshot::GetBlockWidth();
+	const float middleY = mapHeight * 0.5f;
+
+	Walker walker(map, ComputeBounds(map, BlockChunkStreamer::kDefaultLoadRadius));
+
+	// 1. 上下に揺らしながら左端の外から右端の外まで
+	uint32_t frame = 0;
+	for (float x = -margin; x <= mapWidth + margin; x += kSlowStep, ++frame) {
+		float y = middleY + kBobAmplitude * std::sin(static_cast<float>(frame) * 0.01f);
+		if (!walker.Step({x, y, 0.0f})) {
+			return false;
+		}
+	}
+	if (!walker.ExpectEmpty("after the slow pass")) {
+		return false;
+	}
+
+	// 2. 速く戻る
+	for (float x = mapWidth; x >= 0.0f; x -= kFastStep) {
+		if (!walker.Step({x, middleY, 0.0f})) {
+			return false;
+		}
+	}
+
+	// 3. 両端の行き来と、マップの上下左右の外
+	const KamataEngine::Vector3 jumps[] = {
+	    {0.0f, 0.0f, 0.0f}, {mapWidth, mapHeight, 0.0f}, {0.0f, mapHeight, 0.0f}, {mapWidth, 0.0f, 0.0f}, {mapWidth * 0.5f, middleY, 0.0f},
+	};
+	for (uint32_t i = 0; i < 100; ++i) {
+		if (!walker.Step(jumps[i % std::size(jumps)])) {
+			return false;
+		}
+	}
+	const KamataEngine::Vector3 outside[] = {
+	    {-margin, middleY, 0.0f}, {mapWidth + margin, middleY, 0.0f}, {mapWidth * 0.5f, -margin, 0.0f}, {mapWidth * 0.5f, mapHeight + margin, 0.0f},
+	};
+	for (const KamataEngine::Vector3& center : outside) {
+		if (!walker.Step({mapWidth * 0.5f, middleY, 0.0f}) || !walker.Step(center) || !walker.ExpectEmpty("outside the map")) {
+			return false;
+		}
+	}
+
+	walker.Print();
+	std::printf("  map data : %zu bytes (whole level, not streamed)\n", map.GetMemoryUsage().Total());
+	return true;
+}
+
+void PrintUsage() { std::fprintf(stderr, "usage: BlockChunkBench [<width> <height>]\n"); }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	uint32_t width = kDefaultWidth;
+	uint32_t height = kDefaultHeight;
+	if (argc == 3) {
+		width = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+		height = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+	} else if (argc != 1) {
+		PrintUsage();
+		return 2;
+	}
+	if (width == 0 || height == 0) {
+		PrintUsage();
+		return 2;
+	}
+
+	MapChipStage stage = GenerateStage(width, height);
+	std::shared_ptr<MapChipSnapshot> map = MapChipSnapshot::CreateFromStage(stage);
+	std::printf("generated %ux%u\n", map->GetNumBlockHorizontal(), map->GetNumBlockVertical());
+	return Walk(*map) ? 0 : 1;
+}
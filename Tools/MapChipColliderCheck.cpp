@@ -0,0 +1,123 @@
+// 静的コライダー (MapChipColliders.h) が solid タイルを過不足なく覆っているかを確かめるツール
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /ITools /Fe:MapChipColliderCheck.exe Tools\MapChipColliderCheck.cpp MapChipColliders.cpp MapChipFormat.cpp MappedFile.cpp
+//
+// 使い方
+//   MapChipColliderCheck [<map.csv>...]
+//
+// 乱数で作ったマップ（大きさ・solid の割合・氷の混ざり方を変えたもの）と、指定したマップそれぞれについて
+//   1. Build した直後に CoversExactly が成り立つか
+//   2. タイルの書き換えに合わせて RemoveTile / AddTile を繰り返したあとも成り立つか
+// を調べる。1 つでも崩れていれば終了コード 1 を返す
+// 読み込みのたびに調べると毎回マップ全体を走査することになるので、ゲームではこの確認をしない
+
+#include "MapChipColliders.h"
+#include "MapChipQueryStream.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 1 マップあたりのタイル書き換え回数と、CoversExactly で確かめる間隔
+constexpr uint32_t kEditCount = 4000;
+constexpr uint32_t kEditCheckInterval = 500;
+
+struct GeneratedMap {
+	uint32_t width;
+	uint32_t height;
+	uint32_t solidPercent;
+	uint32_t icePercent; // solid のうち氷にする割合
+};
+
+// セルの大きさ (kCellSize) や矩形の上限 (kMaxColliderTiles) の倍数でない大きさも混ぜる
+constexpr GeneratedMap kGeneratedMaps[] = {
+    {1, 1, 100, 0},       {17, 5, 50, 0},      {33, 33, 90, 0},      {100, 24, 30, 20},
+    {257, 40, 70, 50},    {500, 100, 95, 5},   {1000, 24, 10, 10},   {100000, 24, 40, 20},
+};
+
+MapChipType RandomTile(std::mt19937& rng, uint32_t solidPercent, uint32_t icePercent) {
+	if (rng() % 100 >= solidPercent) {
+		return MapChipType::kBlank;
+	}
+	return rng() % 100 < icePercent ? MapChipType::kIce : MapChipType::kBlock;
+}
+
+MapChipGrid Generate(const GeneratedMap& spec, uint32_t seed) {
+	std::mt19937 rng(seed);
+	MapChipGrid grid;
+	grid.width = spec.width;
+	grid.height = spec.height;
+	grid.tiles.resize(static_cast<size_t>(spec.width) * spec.height);
+	for (MapChipType& t : grid.tiles) {
+		t = RandomTile(rng, spec.solidPercent, spec.icePercent);
+	}
+	return grid;
+}
+
+/// <summary>
+/// タイルを 1 つ書き換え、solid かどうかか摩擦係数が変わったときだけ矩形を直す
+/// </summary>
+void SetTile(MapChipGrid& grid, MapChipColliderSet& colliders, uint32_t x, uint32_t y, MapChipType type) {
+	MapChipType& tile = grid.tiles[static_cast<size_t>(y) * grid.width + x];
+	const MapChipProperty& oldProperty = GetMapChipProperty(tile);
+	const MapChipProperty& newProperty = GetMapChipProperty(type);
+	tile = type;
+	if (oldProperty.solid != newProperty.solid || (newProperty.solid && oldProperty.friction != newProperty.friction)) {
+		if (oldProperty.solid) {
+			colliders.RemoveTile(x, y);
+		}
+		if (newProperty.solid) {
+			colliders.AddTile(x, y, newProperty.friction);
+		}
+	}
+}
+
+bool Check(const std::string& name, MapChipGrid grid, uint32_t seed) {
+	MapChipColliderSet colliders;
+	colliders.Build(grid.tiles.data(), grid.width, grid.height);
+	if (!colliders.CoversExactly(grid.tiles.data(), grid.width, grid.height)) {
+		std::fprintf(stderr, "%s: colliders do not cover the solid tiles after Build\n", name.c_str());
+		return false;
+	}
+	size_t built = colliders.GetColliders().size();
+
+	std::mt19937 rng(seed);
+	for (uint32_t i = 1; i <= kEditCount; ++i) {
+		uint32_t x = rng() % grid.width;
+		uint32_t y = rng() % grid.height;
+		SetTile(grid, colliders, x, y, RandomTile(rng, 50, 30));
+		if ((i % kEditCheckInterval == 0 || i == kEditCount) && !colliders.CoversExactly(grid.tiles.data(), grid.width, grid.height)) {
+			std::fprintf(stderr, "%s: colliders do not cover the solid tiles after %u edits\n", name.c_str(), i);
+			return false;
+		}
+	}
+	std::printf("%s (%ux%u): ok, %zu colliders after Build, %u edits\n", name.c_str(), grid.width, grid.height, built, kEditCount);
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	bool ok = true;
+	uint32_t seed = 1;
+	for (const GeneratedMap& spec : kGeneratedMaps) {
+		for (uint32_t i = 0; i < 3; ++i, ++seed) {
+			std::string name = "generated " + std::to_string(spec.solidPercent) + "% solid seed " + std::to_string(seed);
+			ok = Check(name, Generate(spec, seed), seed) && ok;
+		}
+	}
+
+	for (int i = 1; i < argc; ++i) {
+		MapChipGrid grid;
+		if (!LoadMap(argv[i], grid)) {
+			ok = false;
+			continue;
+		}
+		ok = Check(argv[i], std::move(grid), static_cast<uint32_t>(i)) && ok;
+	}
+	return ok ? 0 : 1;
+}
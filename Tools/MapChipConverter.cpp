@@ -0,0 +1,127 @@
+// マップ CSV をコンパイル済みバイナリ (.mcb) に変換するオフラインツール
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /utf-8 /I. /Fe:MapChipConverter.exe Tools\MapChipConverter.cpp MapChipFormat.cpp MappedFile.cpp
+//
+// 使い方
+//   MapChipConverter <input.csv | directory>...     各 CSV と同じ場所に .mcb を書き出す（ディレクトリは再帰的に探す）
+//   MapChipConverter -o <output.mcb> <input.csv>   出力先を指定して 1 ファイルだけ変換する
+//   MapChipConverter --verify <file.mcb>...        バイナリを検証して内容を表示する
+//
+// "[名前]" の見出しで分けたレイヤー付きの CSV も、レイヤーごと 1 つの .mcb にまとめる（MapChipFormat.h を参照）
+// 不正なセル・見出しを含む CSV は変換せず、終了コード 1 を返す
+
+#include "MapChipFormat.h"
+#include "MappedFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kMaxReportedErrors = 16;
+
+bool ConvertFile(const std::string& input, const std::string& output) {
+	MappedFile file;
+	if (!file.Open(input)) {
+		std::fprintf(stderr, "%s: failed to open\n", input.c_str());
+		return false;
+	}
+
+	MapChipStage stage;
+	std::vector<MapChipCsvError> errors;
+	uint32_t errorCount = ParseMapChipStageCsv(file.GetData(), file.GetSize(), stage, errors, kMaxReportedErrors);
+	const MapChipGrid& grid = stage.collision;
+
+	for (const MapChipCsvError& e : errors) {
+		std::fprintf(stderr, "%s:%u:%u: invalid cell '%s'\n", input.c_str(), e.row, e.column, e.text.c_str());
+	}
+	if (errorCount > 0) {
+		std::fprintf(stderr, "%s: %u invalid cells, not converted\n", input.c_str(), errorCount);
+		return false;
+	}
+	if (grid.height == 0) {
+		std::fprintf(stderr, "%s: no map data, not converted\n", input.c_str());
+		return false;
+	}
+
+	if (!WriteMapChipBinary(output, stage)) {
+		std::fprintf(stderr, "%s: failed to write\n", output.c_str());
+		return false;
+	}
+
+	std::printf("%s -> %s (%ux%u, %zu extra layers)\n", input.c_str(), output.c_str(), grid.width, grid.height, stage.layers.size());
+	return true;
+}
+
+bool VerifyFile(const std::string& input) {
+	MappedFile file;
+	if (!file.Open(input)) {
+		std::fprintf(stderr, "%s: failed to open\n", input.c_str());
+		return false;
+	}
+
+	MapChipBinaryView view;
+	const char* error = nullptr;
+	if (!ReadMapChipBinary(file.GetData(), file.GetSize(), view, error)) {
+		std::fprintf(stderr, "%s: %s\n", input.c_str(), error);
+		return false;
+	}
+
+	std::printf("%s: ok (%ux%u)\n", input.c_str(), view.width, view.height);
+	for (const MapChipBinaryLayerView& layer : view.layers) {
+		std::printf("  layer '%s'\n", layer.name.c_str());
+	}
+	return true;
+}
+
+void PrintUsage() {
+	std::fprintf(stderr, "usage: MapChipConverter <input.csv | directory>...\n"
+	                     "       MapChipConverter -o <output.mcb> <input.csv>\n"
+	                     "       MapChipConverter --verify <file.mcb>...\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		PrintUsage();
+		return 2;
+	}
+
+	if (std::strcmp(argv[1], "-o") == 0) {
+		if (argc != 4) {
+			PrintUsage();
+			return 2;
+		}
+		return ConvertFile(argv[3], argv[2]) ? 0 : 1;
+	}
+
+	bool ok = true;
+
+	if (std::strcmp(argv[1], "--verify") == 0) {
+		for (int i = 2; i < argc; ++i) {
+			ok = VerifyFile(argv[i]) && ok;
+		}
+		return ok ? 0 : 1;
+	}
+
+	for (int i = 1; i < argc; ++i) {
+		std::filesystem::path path = argv[i];
+		if (std::filesystem::is_directory(path)) {
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+				if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+					std::string csv = entry.path().string();
+					ok = ConvertFile(csv, GetMapChipBinaryPath(csv)) && ok;
+				}
+			}
+		} else {
+			ok = ConvertFile(argv[i], GetMapChipBinaryPath(argv[i])) && ok;
+		}
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+// 実行中のタイル書き換え (MapChipField::SetTile と、ホットリロードの ReloadMapChipStage) で、派生データと変更の通知が正しく保たれるかを確かめるツール
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /Fe:MapChipEditCheck.exe Tools\MapChipEditCheck.cpp MapChipFieldEdit.cpp MapChipSnapshot.cpp MapChipBitPlanes.cpp MapChipTileStore.cpp MapChipFormat.cpp MappedFile.cpp BlockChunkStreamer.cpp
+//
+// 使い方
+//   MapChipEditCheck [<stage.csv>...]
+//
+// 乱数で作ったマップ（entities・decoration レイヤー付きのものも含む）と、指定したステージそれぞれについて、
+// 狭い範囲にまとめた書き換えと、マップ全体に散らした書き換えを交互に何回も行い、書き換えのたびに次を確かめる
+//   1. SetTile の戻り値と GetPendingTileChanges の内容（読み込み直した回は ReloadMapChipStage の結果と差分）が、行った書き換えと一致する
+//   2. スナップショットのタイル・ビットプレーン・距離場・生成位置の索引が、同じタイルから作り直したものと一致する
+//   3. 書き換える前に GetSnapshot で受け取ったスナップショットは変わっていない
+//   4. 通知を BlockChunkStreamer::InvalidateTiles へ渡したあとの常駐チャンクのブロックが、タイルから作ったものと一致する
+//      （GameScene::UpdateBlockChunks・HotReloadMap と同じ手順）
+// 1 つでも崩れていれば終了コード 1 を返す
+
+#include "BlockChunkStreamer.h"
+#include "MapChipField.h"
+#include "MapChipFormat.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kMaxReportedErrors = 16;
+
+// 1 マップあたりの書き換えのまとまりの数と、1 まとまりの最大の書き換え数
+constexpr uint32_t kBatchCount = 40;
+constexpr uint32_t kMaxBatchEdits = 64;
+// まとめた書き換えを置く範囲（タイル数、縦横）
+constexpr uint32_t kClusterTiles = 8;
+// この回数ごとに 1 回、SetTile の代わりに ReloadMapChipStage で書き換える
+constexpr uint32_t kReloadInterval = 4;
+
+struct GeneratedMap {
+	uint32_t width;
+	uint32_t height;
+	uint32_t blankPercent;
+	bool layers; // entities・decoration レイヤーを付ける
+};
+
+// チャンクの大きさ (BlockChunkStreamer::kChunkSize) やビットプレーンのワード (64 タイル) の倍数でない大きさも混ぜる
+constexpr GeneratedMap kGeneratedMaps[] = {
+    {1, 1, 50, false}, {17, 5, 60, true}, {64, 33, 40, false}, {200, 40, 70, true}, {1000, 24, 85, false}, {300, 300, 90, true}, {20000, 24, 90, true},
+};
+
+/// <summary>
+/// 全種別を含む乱数のタイル（blankPercent の割合で kBlank、残りの半分は Block・Ice、半分はそれ以外の種別）
+/// </summary>
+MapChipType RandomTile(std::mt19937& rng, uint32_t blankPercent) {
+	if (rng() % 100 < blankPercent) {
+		return MapChipType::kBlank;
+	}
+	if (rng() % 2 == 0) {
+		return rng() % 4 == 0 ? MapChipType::kIce : MapChipType::kBlock;
+	}
+	return static_cast<MapChipType>(rng() % kMapChipTypeCount);
+}
+
+MapChipStage Generate(const GeneratedMap& spec, uint32_t seed) {
+	std::mt19937 rng(seed);
+	MapChipStage stage;
+	stage.collision.width = spec.width;
+	stage.collision.height = spec.height;
+	stage.collision.tiles.resize(static_cast<size_t>(spec.width) * spec.height);
+	for (MapChipType& t : stage.collision.tiles) {
+		t = RandomTile(rng, spec.blankPercent);
+	}
+	if (spec.layers) {
+		MapChipLayerGrid entities = {kMapChipEntityLayerName, std::vector<MapChipType>(stage.collision.tiles.size(), MapChipType::kBlank)};
+		MapChipLayerGrid decoration = {kMapChipDecorationLayerName, std::vector<MapChipType>(stage.collision.tiles.size(), MapChipType::kBlank)};
+		for (size_t i = 0; i < entities.tiles.size(); ++i) {
+			if (rng() % 50 == 0) {
+				entities.tiles[i] = rng() % 2 == 0 ? MapChipType::kEnemySpawn : MapChipType::kKey;
+			}
+			if (rng() % 20 == 0) {
+				decoration.tiles[i] = rng() % 3 == 0 ? MapChipType::kIce : MapChipType::kBlock;
+			}
+		}
+		stage.layers.push_back(std::move(entities));
+		stage.layers.push_back(std::move(decoration));
+	}
+	return stage;
+}
+
+bool LoadStage(const std::string& path, MapChipStage& stage) {
+	MappedFile file;
+	if (!file.Open(path)) {
+		std::fprintf(stderr, "%s: failed to open\n", path.c_str());
+		return false;
+	}
+	std::vector<MapChipCsvError> errors;
+	uint32_t errorCount = ParseMapChipStageCsv(file.GetData(), file.GetSize(), stage, errors, kMaxReportedErrors);
+	if (errorCount > 0 || stage.collision.height == 0) {
+		std::fprintf(stderr, "%s: invalid stage\n", path.c_str());
+		return false;
+	}
+	return true;
+}
+
+/// <summary>
+/// 2 つのスナップショットのタイルと派生データが一致するか。違えば最初の違いを what に書く
+/// </summary>
+bool SameMap(const MapChipSnapshot& actual, const MapChipSnapshot& expected, std::string& what) {
+	const uint32_t width = expected.GetNumBlockHorizontal();
+	const uint32_t height = expected.GetNumBlockVertical();
+	if (actual.GetNumBlockHorizontal() != width || actual.GetNumBlockVertical() != height) {
+		what = "size";
+		return false;
+	}
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			auto at = [&](const char* name) { what = std::string(name) + " at (" + std::to_string(x) + ", " + std::to_string(y) + ")"; };
+			if (actual.GetMapChipTypeByIndexUnchecked(x, y) != expected.GetMapChipTypeByIndexUnchecked(x, y)) {
+				at("tile");
+				return false;
+			}
+			for (uint32_t plane = 0; plane < kMapChipPlaneCount; ++plane) {
+				if (actual.TestPlane(static_cast<MapChipPlane>(plane), x, y) != expected.TestPlane(static_cast<MapChipPlane>(plane), x, y)) {
+					at("bit plane");
+					return false;
+				}
+			}
+			if (actual.GetGroundDistance(x, y) != expected.GetGroundDistance(x, y)) {
+				at("ground distance");
+				return false;
+			}
+			if (actual.GetCeilingDistance(x, y) != expected.GetCeilingDistance(x, y)) {
+				at("ceiling distance");
+				return false;
+			}
+		}
+	}
+	for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+		std::span<const IndexSet> a = actual.GetSpawnTiles(static_cast<MapChipType>(i));
+		std::span<const IndexSet> b = expected.GetSpawnTiles(static_cast<MapChipType>(i));
+		bool same = a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const IndexSet& l, const IndexSet& r) { return l.xIndex == r.xIndex && l.yIndex == r.yIndex; });
+		if (!same) {
+			what = "spawn index of type " + std::to_string(i);
+			return false;
+		}
+	}
+	return true;
+}
+
+/// <summary>
+/// 常駐チャンクのブロックが、スナップショットのタイルから作ったものと一致するか
+/// スロットが常駐ブロックの間で重複していないことも確かめる
+/// </summary>
+bool SameResidentBlocks(const BlockChunkStreamer& streamer, const MapChipSnapshot& map, std::string& what) {
+	using Key = std::tuple<uint32_t, uint32_t, bool, bool>; // y, x, decoration, ice
+	const uint32_t size = BlockChunkStreamer::kChunkSize;
+	const MapChipLayer* decoration = map.FindLayer(kMapChipDecorationLayerName);
+
+	std::vector<uint32_t> slots;
+	for (const BlockChunkStreamer::Chunk& chunk : streamer.GetChunks()) {
+		std::vector<Key> actual;
+		for (const BlockChunkStreamer::Block& block : chunk.blocks) {
+			actual.emplace_back(block.yIndex, block.xIndex, block.isDecoration, block.isIce);
+			slots.push_back(block.slot);
+		}
+
+		std::vector<Key> expected;
+		uint32_t endX = std::min((chunk.chunkX + 1) * size, map.GetNumBlockHorizontal());
+		uint32_t endY = std::min((chunk.chunkY + 1) * size, map.GetNumBlockVertical());
+		for (uint32_t y = chunk.chunkY * size; y < endY; ++y) {
+			for (uint32_t x = chunk.chunkX * size; x < endX; ++x) {
+				MapChipModel model = GetMapChipProperty(map.GetMapChipTypeByIndexUnchecked(x, y)).model;
+				if (model != MapChipModel::kNone) {
+					expected.emplace_back(y, x, false, model == MapChipModel::kIce);
+				}
+				if (decoration) {
+					MapChipModel decorationModel = GetMapChipProperty(decoration->tiles.Get(x, y)).model;
+					if (decorationModel != MapChipModel::kNone) {
+						expected.emplace_back(y, x, true, decorationModel == MapChipModel::kIce);
+					}
+				}
+			}
+		}
+
+		std::sort(actual.begin(), actual.end());
+		std::sort(expected.begin(), expected.end());
+		if (actual != expected) {
+			what = "blocks of chunk (" + std::to_string(chunk.chunkX) + ", " + std::to_string(chunk.chunkY) + ")";
+			return false;
+		}
+	}
+
+	std::sort(slots.begin(), slots.end());
+	if (std::adjacent_find(slots.begin(), slots.end()) != slots.end() || (!slots.empty() && slots.back() >= streamer.GetSlotCount())) {
+		what = "block slots";
+		return false;
+	}
+	return true;
+}
+
+bool SameTiles(const MapChipSnapshot& snapshot, const MapChipGrid& grid) {
+	for (uint32_t y = 0; y < grid.height; ++y) {
+		for (uint32_t x = 0; x < grid.width; ++x) {
+			if (snapshot.GetMapChipTypeByIndexUnchecked(x, y) != grid.tiles[static_cast<size_t>(y) * grid.width + x]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool SameChanges(std::span<const MapChipTileChange> actual, const std::vector<MapChipTileChange>& expected) {
+	return actual.size() == expected.size() && std::equal(actual.begin(), actual.end(), expected.begin(), [](const MapChipTileChange& a, const MapChipTileChange& b) {
+		       return a.index.xIndex == b.index.xIndex && a.index.yIndex == b.index.yIndex && a.before == b.before && a.after == b.after;
+	       });
+}
+
+bool Check(const std::string& name, MapChipStage stage, uint32_t seed) {
+	// 書き換えの正解として、同じ書き換えを行優先の配列にも行う（比べるたびにここから作り直す）
+	MapChipStage reference = stage;
+	MapChipGrid& grid = reference.collision;
+
+	MapChipField field;
+	field.LoadMapChipStage(stage);
+
+	BlockChunkStreamer streamer;
+	std::mt19937 rng(seed);
+	uint32_t applied = 0;
+	std::string what;
+
+	for (uint32_t batch = 0; batch < kBatchCount; ++batch) {
+		// 偶数回目は狭い範囲にまとめ、奇数回目はマップ全体に散らす
+		bool clustered = batch % 2 == 0;
+		uint32_t originX = rng() % grid.width;
+		uint32_t originY = rng() % grid.height;
+
+		// カメラを書き換える範囲に置いてチャンクを読み込んでおき、書き換え後は通知だけで直す
+		const KamataEngine::Vector3 camera = field.GetMapChipPositionByIndex(originX, originY);
+		streamer.Update(*field.GetSnapshot(), camera);
+
+		// 書き換える前のスナップショットを持っておく（書き換えで変わってはいけない）
+		std::shared_ptr<const MapChipSnapshot> held = field.GetSnapshot();
+		MapChipGrid heldGrid = grid;
+
+		std::vector<MapChipTileChange> expectedChanges;
+		std::shared_ptr<const MapChipSnapshot> snapshot;
+		uint32_t edits = 1 + rng() % kMaxBatchEdits;
+		if (batch % kReloadInterval == kReloadInterval - 1) {
+			// 同じ書き換えをしたステージで読み込み直す（ホットリロードの差分の反映）
+			MapChipStage edited = reference;
+			for (uint32_t i = 0; i < edits; ++i) {
+				uint32_t x = clustered ? std::min<uint32_t>(originX + rng() % kClusterTiles, grid.width - 1) : rng() % grid.width;
+				uint32_t y = clustered ? std::min<uint32_t>(originY + rng() % kClusterTiles, grid.height - 1) : rng() % grid.height;
+				edited.collision.tiles[static_cast<size_t>(y) * grid.width + x] = RandomTile(rng, 40);
+			}
+			// 差分は行優先で返る
+			for (size_t i = 0; i < grid.tiles.size(); ++i) {
+				if (grid.tiles[i] != edited.collision.tiles[i]) {
+					IndexSet index = {static_cast<uint32_t>(i % grid.width), static_cast<uint32_t>(i / grid.width)};
+					expectedChanges.push_back({index, grid.tiles[i], edited.collision.tiles[i]});
+					grid.tiles[i] = edited.collision.tiles[i];
+				}
+			}
+
+			std::vector<MapChipTileChange> changes;
+			MapChipReloadResult result = field.ReloadMapChipStage(edited, changes);
+			MapChipReloadResult expectedResult = expectedChanges.empty() ? MapChipReloadResult::kUnchanged : MapChipReloadResult::kTilesChanged;
+			if (result != expectedResult || !SameChanges(changes, expectedChanges)) {
+				std::fprintf(stderr, "%s: batch %u: reload changes do not match the edits\n", name.c_str(), batch);
+				return false;
+			}
+
+			// GameScene::HotReloadMap と同じく、返った差分をそのまま渡す
+			snapshot = field.GetSnapshot();
+			streamer.InvalidateTiles(*snapshot, changes);
+		} else {
+			for (uint32_t i = 0; i < edits; ++i) {
+				// 範囲外の書き換えもときどき混ぜる（何もせず false が返る）
+				uint32_t x = clustered ? originX + rng() % kClusterTiles : rng() % (grid.width + 1);
+				uint32_t y = clustered ? originY + rng() % kClusterTiles : rng() % (grid.height + 1);
+				MapChipType type = RandomTile(rng, 40);
+
+				bool inMap = x < grid.width && y < grid.height;
+				MapChipType* tile = inMap ? &grid.tiles[static_cast<size_t>(y) * grid.width + x] : nullptr;
+				bool expected = inMap && *tile != type;
+				if (field.SetTile(x, y, type) != expected) {
+					std::fprintf(stderr, "%s: SetTile(%u, %u) returned %s\n", name.c_str(), x, y, expected ? "false" : "true");
+					return false;
+				}
+				if (expected) {
+					expectedChanges.push_back({{x, y}, *tile, type});
+					*tile = type;
+				}
+			}
+
+			std::span<const MapChipTileChange> pending = field.GetPendingTileChanges();
+			if (!SameChanges(pending, expectedChanges)) {
+				std::fprintf(stderr, "%s: batch %u: pending changes do not match the edits\n", name.c_str(), batch);
+				return false;
+			}
+
+			// GameScene::UpdateBlockChunks と同じく、通知を渡してから捨てる
+			snapshot = field.GetSnapshot();
+			streamer.InvalidateTiles(*snapshot, pending);
+			field.ClearPendingTileChanges();
+		}
+		applied += static_cast<uint32_t>(expectedChanges.size());
+
+		if (!SameTiles(*held, heldGrid)) {
+			std::fprintf(stderr, "%s: batch %u: a held snapshot changed\n", name.c_str(), batch);
+			return false;
+		}
+		MapChipStage rebuiltStage = reference;
+		std::shared_ptr<MapChipSnapshot> rebuilt = MapChipSnapshot::CreateFromStage(rebuiltStage);
+		if (!SameMap(*snapshot, *rebuilt, what)) {
+			std::fprintf(stderr, "%s: batch %u: %s differs from a fresh build\n", name.c_str(), batch, what.c_str());
+			return false;
+		}
+		if (!SameResidentBlocks(streamer, *snapshot, what)) {
+			std::fprintf(stderr, "%s: batch %u: %s differ from the tiles\n", name.c_str(), batch, what.c_str());
+			return false;
+		}
+	}
+
+	std::printf("%s (%ux%u): ok, %u edits in %u batches\n", name.c_str(), grid.width, grid.height, applied, kBatchCount);
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	bool ok = true;
+	uint32_t seed = 1;
+	for (const GeneratedMap& spec : kGeneratedMaps) {
+		for (uint32_t i = 0; i < 2; ++i, ++seed) {
+			std::string name = "generated " + std::to_string(spec.blankPercent) + "% blank" + (spec.layers ? " with layers" : "") + " seed " + std::to_string(seed);
+			ok = Check(name, Generate(spec, seed), seed) && ok;
+		}
+	}
+
+	for (int i = 1; i < argc; ++i) {
+		MapChipStage stage;
+		if (!LoadStage(argv[i], stage)) {
+			ok = false;
+			continue;
+		}
+		ok = Check(argv[i], std::move(stage), static_cast<uint32_t>(i)) && ok;
+	}
+	return ok ? 0 : 1;
+}
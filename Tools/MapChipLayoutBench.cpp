@@ -0,0 +1,159 @@
+// タイル配置 (MapChipLayout.h) の比較用ベンチマーク
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /ITools /Fe:MapChipLayoutBench.exe Tools\MapChipLayoutBench.cpp MapChipFormat.cpp MappedFile.cpp
+//
+// 使い方
+//   MapChipLayoutBench <map.csv>...                          マップごとにクエリ列を作り、行優先と Z 順で再生して比べる
+//   MapChipLayoutBench --record <queries.bin> <map.csv>      作ったクエリ列を保存する
+//   MapChipLayoutBench --replay <queries.bin> <map.csv>      保存したクエリ列を再生する
+//
+// クエリ列はプレイヤーと敵の当たり判定が 1 フレームに引くタイルを模したもの（Tools/MapChipQueryStream.h）
+// クエリ列ファイルは (x, y) の uint32_t の組を並べただけのもの
+
+#include "MapChipFormat.h"
+#include "MapChipLayout.h"
+#include "MapChipQueryStream.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename Layout> std::vector<MapChipType> BuildStorage(const MapChipGrid& grid) {
+	std::vector<MapChipType> storage(Layout::StorageSize(grid.width, grid.height), MapChipType::kBlank);
+	for (uint32_t y = 0; y < grid.height; ++y) {
+		for (uint32_t x = 0; x < grid.width; ++x) {
+			storage[Layout::TileOffset(x, y, grid.width)] = grid.tiles[static_cast<size_t>(y) * grid.width + x];
+		}
+	}
+	return storage;
+}
+
+struct RunResult {
+	double nsPerQuery;
+	uint64_t checksum;
+	size_t bytes;
+};
+
+template <typename Layout> RunResult Replay(const MapChipGrid& grid, const std::vector<TileQuery>& queries) {
+	std::vector<MapChipType> storage = BuildStorage<Layout>(grid);
+	const MapChipType* tiles = storage.data();
+	const uint32_t width = grid.width;
+
+	size_t repeats = std::max<size_t>(1, kMinQueriesPerRun / std::max<size_t>(1, queries.size()));
+	uint64_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < repeats; ++r) {
+		for (const TileQuery& q : queries) {
+			// 当たり判定と同じく種別から性質を引く
+			checksum += GetMapChipProperty(tiles[Layout::TileOffset(q.x, q.y, width)]).ground;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	return {ns / static_cast<double>(repeats * queries.size()), checksum / repeats, storage.size()};
+}
+
+bool WriteQueries(const std::string& path, const std::vector<TileQuery>& queries) {
+	FILE* fp = std::fopen(path.c_str(), "wb");
+	if (!fp) {
+		return false;
+	}
+	bool ok = std::fwrite(queries.data(), sizeof(TileQuery), queries.size(), fp) == queries.size();
+	return std::fclose(fp) == 0 && ok;
+}
+
+bool ReadQueries(const std::string& path, const MapChipGrid& grid, std::vector<TileQuery>& queries) {
+	MappedFile file;
+	if (!file.Open(path) || file.GetSize() % sizeof(TileQuery) != 0) {
+		std::fprintf(stderr, "%s: failed to read query stream\n", path.c_str());
+		return false;
+	}
+	queries.resize(file.GetSize() / sizeof(TileQuery));
+	if (!queries.empty()) {
+		std::memcpy(queries.data(), file.GetData(), file.GetSize());
+	}
+	for (const TileQuery& q : queries) {
+		if (q.x >= grid.width || q.y >= grid.height) {
+			std::fprintf(stderr, "%s: query (%u, %u) is outside the map\n", path.c_str(), q.x, q.y);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Benchmark(const std::string& mapPath, const std::vector<TileQuery>& queries, const MapChipGrid& grid) {
+	RunResult rowMajor = Replay<MapChipRowMajorLayout>(grid, queries);
+	RunResult morton = Replay<MapChipMortonLayout>(grid, queries);
+	if (rowMajor.checksum != morton.checksum) {
+		std::fprintf(stderr, "%s: layouts disagree (%llu vs %llu)\n", mapPath.c_str(), static_cast<unsigned long long>(rowMajor.checksum),
+		             static_cast<unsigned long long>(morton.checksum));
+		return false;
+	}
+
+	std::printf("%s (%ux%u, %zu queries)\n", mapPath.c_str(), grid.width, grid.height, queries.size());
+	std::printf("  row-major : %6.2f ns/query  %zu bytes\n", rowMajor.nsPerQuery, rowMajor.bytes);
+	std::printf("  morton    : %6.2f ns/query  %zu bytes\n", morton.nsPerQuery, morton.bytes);
+	std::printf("  faster    : %s\n", morton.nsPerQuery < rowMajor.nsPerQuery ? "morton (define MAPCHIP_LAYOUT_MORTON)" : "row-major");
+	return true;
+}
+
+void PrintUsage() {
+	std::fprintf(stderr, "usage: MapChipLayoutBench <map.csv>...\n"
+	                     "       MapChipLayoutBench --record <queries.bin> <map.csv>\n"
+	                     "       MapChipLayoutBench --replay <queries.bin> <map.csv>\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		PrintUsage();
+		return 2;
+	}
+
+	bool record = std::strcmp(argv[1], "--record") == 0;
+	bool replay = std::strcmp(argv[1], "--replay") == 0;
+	if (record || replay) {
+		if (argc != 4) {
+			PrintUsage();
+			return 2;
+		}
+		MapChipGrid grid;
+		if (!LoadMap(argv[3], grid)) {
+			return 1;
+		}
+		std::vector<TileQuery> queries;
+		if (record) {
+			queries = GenerateQueries(grid);
+			if (!WriteQueries(argv[2], queries)) {
+				std::fprintf(stderr, "%s: failed to write\n", argv[2]);
+				return 1;
+			}
+			std::printf("%s: %zu queries\n", argv[2], queries.size());
+			return 0;
+		}
+		if (!ReadQueries(argv[2], grid, queries)) {
+			return 1;
+		}
+		return Benchmark(argv[3], queries, grid) ? 0 : 1;
+	}
+
+	bool ok = true;
+	for (int i = 1; i < argc; ++i) {
+		MapChipGrid grid;
+		if (!LoadMap(argv[i], grid)) {
+			ok = false;
+			continue;
+		}
+		ok = Benchmark(argv[i], GenerateQueries(grid), grid) && ok;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,202 @@
+// マップ CSV の読み込み速度の比較用ベンチマーク
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /Fe:MapChipLoadBench.exe Tools\MapChipLoadBench.cpp MapChipFormat.cpp MappedFile.cpp
+//
+// 使い方
+//   MapChipLoadBench [<width> <height>] [<out.csv>]     既定は 10000 x 500。out.csv を省くと map_load_bench.csv に書く
+//
+// 乱数でマップを作って CSV に書き出し、次の 2 つで kRepeats 回ずつ読んで、最も速かった回の時間と MB/s を表示する
+//   getline: 以前の MapChipField::LoadMapChipCsv（ifstream → stringstream → 行ごとの string → getline でセル → std::map で種別）
+//   mmap   : 今の読み込み（MappedFile で割り当てて ParseMapChipCsv で 1 パス）
+// 2 つの結果のタイルが一致しなければ終了コード 1 を返す
+
+#include "MapChipFormat.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kDefaultWidth = 10000;
+constexpr uint32_t kDefaultHeight = 500;
+constexpr const char* kDefaultPath = "map_load_bench.csv";
+constexpr uint32_t kRepeats = 5;
+constexpr uint32_t kMaxReportedErrors = 16;
+
+/// <summary>
+/// 以前の読み込み（MapChipField::LoadMapChipCsv）をそのまま移したもの
+/// </summary>
+bool LoadWithGetline(const std::string& path, MapChipGrid& grid) {
+	static const std::map<std::string, MapChipType> mapChipTable = [] {
+		std::map<std::string, MapChipType> table;
+		for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+			table[std::to_string(i)] = static_cast<MapChipType>(i);
+		}
+		return table;
+	}();
+
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	std::stringstream mapChipCsv;
+	mapChipCsv << file.rdbuf();
+	file.close();
+
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(mapChipCsv, line)) {
+		if (line.empty()) continue;
+		lines.push_back(line);
+	}
+
+	uint32_t maxCols = 0;
+	for (const auto& ln : lines) {
+		uint32_t cols = 0;
+		std::stringstream ls(ln);
+		std::string word;
+		while (std::getline(ls, word, ',')) {
+			++cols;
+		}
+		maxCols = std::max(maxCols, cols);
+	}
+
+	grid.width = maxCols;
+	grid.height = static_cast<uint32_t>(lines.size());
+	std::vector<std::vector<MapChipType>> rows(grid.height, std::vector<MapChipType>(grid.width, MapChipType::kBlank));
+
+	auto trim = [](std::string& s) {
+		while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.erase(s.begin());
+		while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.pop_back();
+	};
+
+	for (uint32_t i = 0; i < grid.height; ++i) {
+		std::stringstream line_stream(lines[i]);
+		for (uint32_t j = 0; j < grid.width; ++j) {
+			std::string word;
+			if (!std::getline(line_stream, word, ',')) {
+				break;
+			}
+			trim(word);
+			auto it = mapChipTable.find(word);
+			if (it != mapChipTable.end()) {
+				rows[i][j] = it->second;
+			}
+		}
+	}
+
+	// 比較のために行優先へ（計測に含めるが、以前の格納への書き込みと同程度の手間）
+	grid.tiles.clear();
+	grid.tiles.reserve(static_cast<size_t>(grid.width) * grid.height);
+	for (const std::vector<MapChipType>& row : rows) {
+		grid.tiles.insert(grid.tiles.end(), row.begin(), row.end());
+	}
+	return true;
+}
+
+bool LoadWithMappedFile(const std::string& path, MapChipGrid& grid) {
+	MappedFile file;
+	if (!file.Open(path)) {
+		return false;
+	}
+	std::vector<MapChipCsvError> errors;
+	return ParseMapChipCsv(file.GetData(), file.GetSize(), grid, errors, kMaxReportedErrors) == 0;
+}
+
+/// <summary>
+/// 下の数行を地面にし、残りに種別を散らしたマップを CSV に書く
+/// </summary>
+bool WriteRandomCsv(const std::string& path, uint32_t width, uint32_t height, size_t& bytes) {
+	FILE* fp = std::fopen(path.c_str(), "wb");
+	if (!fp) {
+		return false;
+	}
+	std::mt19937 rng(12345);
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			uint32_t type = 0;
+			if (y + 3 >= height) {
+				type = static_cast<uint32_t>(MapChipType::kBlock);
+			} else if (rng() % 8 == 0) {
+				type = rng() % kMapChipTypeCount;
+			}
+			std::fprintf(fp, x + 1 < width ? "%u," : "%u\n", type);
+		}
+	}
+	long size = std::ftell(fp);
+	bytes = size > 0 ? static_cast<size_t>(size) : 0;
+	return std::fclose(fp) == 0;
+}
+
+template <typename Load> bool Measure(const char* name, Load load, const std::string& path, size_t bytes, MapChipGrid& grid) {
+	double best = 0.0;
+	for (uint32_t i = 0; i < kRepeats; ++i) {
+		grid = MapChipGrid();
+		auto start = std::chrono::steady_clock::now();
+		bool ok = load(path, grid);
+		auto end = std::chrono::steady_clock::now();
+		if (!ok) {
+			std::fprintf(stderr, "%s: %s failed to load\n", path.c_str(), name);
+			return false;
+		}
+		double ms = std::chrono::duration<double, std::milli>(end - start).count();
+		best = i == 0 ? ms : std::min(best, ms);
+	}
+	std::printf("  %-8s: %9.2f ms  %8.1f MB/s\n", name, best, static_cast<double>(bytes) / (1024.0 * 1024.0) / (best / 1000.0));
+	return true;
+}
+
+void PrintUsage() { std::fprintf(stderr, "usage: MapChipLoadBench [<width> <height>] [<out.csv>]\n"); }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	uint32_t width = kDefaultWidth;
+	uint32_t height = kDefaultHeight;
+	std::string path = kDefaultPath;
+	if (argc == 3 || argc == 4) {
+		width = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+		height = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+		if (argc == 4) {
+			path = argv[3];
+		}
+	} else if (argc == 2) {
+		path = argv[1];
+	} else if (argc != 1) {
+		PrintUsage();
+		return 2;
+	}
+	if (width == 0 || height == 0) {
+		PrintUsage();
+		return 2;
+	}
+
+	size_t bytes = 0;
+	if (!WriteRandomCsv(path, width, height, bytes)) {
+		std::fprintf(stderr, "%s: failed to write\n", path.c_str());
+		return 1;
+	}
+	std::printf("%s (%ux%u, %.1f MB), best of %u\n", path.c_str(), width, height, static_cast<double>(bytes) / (1024.0 * 1024.0), kRepeats);
+
+	MapChipGrid getlineGrid;
+	MapChipGrid mappedGrid;
+	if (!Measure("getline", LoadWithGetline, path, bytes, getlineGrid) || !Measure("mmap", LoadWithMappedFile, path, bytes, mappedGrid)) {
+		return 1;
+	}
+	if (getlineGrid.width != mappedGrid.width || getlineGrid.height != mappedGrid.height || getlineGrid.tiles != mappedGrid.tiles) {
+		std::fprintf(stderr, "%s: loaders disagree\n", path.c_str());
+		return 1;
+	}
+	return 0;
+}
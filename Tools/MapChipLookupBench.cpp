@@ -0,0 +1,223 @@
+// タイル参照 (MapChipField::GetMapChipTypeByIndex) の比較用ベンチマーク
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /ITools /Fe:MapChipLookupBench.exe Tools\MapChipLookupBench.cpp MapChipFormat.cpp MappedFile.cpp
+//
+// 使い方
+//   MapChipLookupBench <map.csv>...                    マップごとに以前の格納と 1 バイトの平坦な配列を比べる
+//   MapChipLookupBench --random <width> <height>       乱数で作ったマップで比べる
+//
+// 以前の格納: 行ごとの std::vector<std::vector<MapChipType>>（MapChipType は 4 バイトの enum class）
+// 平坦な配列: 行優先の 1 本の std::vector<MapChipType>（1 バイト）。どちらも範囲外は kBlank を返す
+// 参照の並びは 3 種類
+//   probe : 当たり判定を模したクエリ列（Tools/MapChipQueryStream.h）
+//   random: 同じ数の一様ランダムな参照
+//   scan  : 行ごとに左から全タイル（ブロックの生成などのループ）
+
+#include "MapChipFormat.h"
+#include "MapChipQueryStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 以前の MapChipType（基底型を指定しない enum class なので int）
+enum class NestedMapChipType { kBlank = 0 };
+
+/// <summary>
+/// 以前の MapChipData（行ごとの vector）
+/// </summary>
+class NestedStore {
+public:
+	explicit NestedStore(const MapChipGrid& grid) : width_(grid.width), height_(grid.height) {
+		data_.resize(grid.height);
+		for (uint32_t y = 0; y < grid.height; ++y) {
+			data_[y].resize(grid.width);
+			for (uint32_t x = 0; x < grid.width; ++x) {
+				data_[y][x] = static_cast<NestedMapChipType>(grid.tiles[static_cast<size_t>(y) * grid.width + x]);
+			}
+		}
+	}
+
+	MapChipType Get(uint32_t xIndex, uint32_t yIndex) const {
+		if (xIndex >= width_ || yIndex >= height_) {
+			return MapChipType::kBlank;
+		}
+		return static_cast<MapChipType>(data_[yIndex][xIndex]);
+	}
+
+	size_t GetMemoryBytes() const {
+		size_t bytes = data_.capacity() * sizeof(std::vector<NestedMapChipType>);
+		for (const std::vector<NestedMapChipType>& row : data_) {
+			bytes += row.capacity() * sizeof(NestedMapChipType);
+		}
+		return bytes;
+	}
+
+private:
+	std::vector<std::vector<NestedMapChipType>> data_;
+	uint32_t width_;
+	uint32_t height_;
+};
+
+/// <summary>
+/// 今の MapChipData（行優先の 1 バイトの配列）
+/// </summary>
+class FlatStore {
+public:
+	explicit FlatStore(const MapChipGrid& grid) : data_(grid.tiles), width_(grid.width), height_(grid.height) {}
+
+	MapChipType Get(uint32_t xIndex, uint32_t yIndex) const {
+		if (xIndex >= width_ || yIndex >= height_) {
+			return MapChipType::kBlank;
+		}
+		return data_[static_cast<size_t>(yIndex) * width_ + xIndex];
+	}
+
+	size_t GetMemoryBytes() const { return data_.capacity() * sizeof(MapChipType); }
+
+private:
+	std::vector<MapChipType> data_;
+	uint32_t width_;
+	uint32_t height_;
+};
+
+struct RunResult {
+	double nsPerLookup;
+	uint64_t checksum;
+};
+
+template <typename Store> RunResult Replay(const Store& store, const std::vector<TileQuery>& queries) {
+	size_t repeats = std::max<size_t>(1, kMinQueriesPerRun / std::max<size_t>(1, queries.size()));
+	uint64_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < repeats; ++r) {
+		for (const TileQuery& q : queries) {
+			checksum += GetMapChipProperty(store.Get(q.x, q.y)).ground;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	return {ns / static_cast<double>(repeats * queries.size()), checksum / repeats};
+}
+
+template <typename Store> RunResult Scan(const Store& store, const MapChipGrid& grid) {
+	size_t tiles = static_cast<size_t>(grid.width) * grid.height;
+	size_t repeats = std::max<size_t>(1, kMinQueriesPerRun / std::max<size_t>(1, tiles));
+	uint64_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < repeats; ++r) {
+		for (uint32_t y = 0; y < grid.height; ++y) {
+			for (uint32_t x = 0; x < grid.width; ++x) {
+				checksum += GetMapChipProperty(store.Get(x, y)).ground;
+			}
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	return {ns / static_cast<double>(repeats * tiles), checksum / repeats};
+}
+
+std::vector<TileQuery> GenerateRandomQueries(const MapChipGrid& grid, size_t count) {
+	std::mt19937 rng(54321);
+	std::vector<TileQuery> queries(count);
+	for (TileQuery& q : queries) {
+		q = {static_cast<uint32_t>(rng() % grid.width), static_cast<uint32_t>(rng() % grid.height)};
+	}
+	return queries;
+}
+
+/// <summary>
+/// 下の数行を地面にし、残りに 1 割ほどブロック・氷を散らしたマップ
+/// </summary>
+MapChipGrid GenerateRandomMap(uint32_t width, uint32_t height) {
+	std::mt19937 rng(12345);
+	MapChipGrid grid;
+	grid.width = width;
+	grid.height = height;
+	grid.tiles.resize(static_cast<size_t>(width) * height, MapChipType::kBlank);
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			MapChipType& t = grid.tiles[static_cast<size_t>(y) * width + x];
+			if (y + 3 >= height) {
+				t = MapChipType::kBlock;
+			} else if (rng() % 10 == 0) {
+				t = rng() % 4 == 0 ? MapChipType::kIce : MapChipType::kBlock;
+			}
+		}
+	}
+	return grid;
+}
+
+bool Benchmark(const std::string& name, const MapChipGrid& grid) {
+	NestedStore nested(grid);
+	FlatStore flat(grid);
+
+	std::vector<TileQuery> probe = GenerateQueries(grid);
+	std::vector<TileQuery> random = GenerateRandomQueries(grid, std::max<size_t>(probe.size(), 1));
+
+	RunResult nestedProbe = Replay(nested, probe);
+	RunResult flatProbe = Replay(flat, probe);
+	RunResult nestedRandom = Replay(nested, random);
+	RunResult flatRandom = Replay(flat, random);
+	RunResult nestedScan = Scan(nested, grid);
+	RunResult flatScan = Scan(flat, grid);
+	if (nestedProbe.checksum != flatProbe.checksum || nestedRandom.checksum != flatRandom.checksum || nestedScan.checksum != flatScan.checksum) {
+		std::fprintf(stderr, "%s: stores disagree\n", name.c_str());
+		return false;
+	}
+
+	std::printf("%s (%ux%u, %zu probe queries)\n", name.c_str(), grid.width, grid.height, probe.size());
+	std::printf("  nested : %12zu bytes  probe %6.2f  random %6.2f  scan %6.2f ns/lookup\n", nested.GetMemoryBytes(), nestedProbe.nsPerLookup, nestedRandom.nsPerLookup,
+	            nestedScan.nsPerLookup);
+	std::printf("  flat   : %12zu bytes  probe %6.2f  random %6.2f  scan %6.2f ns/lookup\n", flat.GetMemoryBytes(), flatProbe.nsPerLookup, flatRandom.nsPerLookup,
+	            flatScan.nsPerLookup);
+	return true;
+}
+
+void PrintUsage() {
+	std::fprintf(stderr, "usage: MapChipLookupBench <map.csv>...\n"
+	                     "       MapChipLookupBench --random <width> <height>\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		PrintUsage();
+		return 2;
+	}
+
+	if (std::string(argv[1]) == "--random") {
+		if (argc != 4) {
+			PrintUsage();
+			return 2;
+		}
+		uint32_t width = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+		uint32_t height = static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10));
+		if (width == 0 || height == 0) {
+			PrintUsage();
+			return 2;
+		}
+		return Benchmark("random", GenerateRandomMap(width, height)) ? 0 : 1;
+	}
+
+	bool ok = true;
+	for (int i = 1; i < argc; ++i) {
+		MapChipGrid grid;
+		if (!LoadMap(argv[i], grid)) {
+			ok = false;
+			continue;
+		}
+		ok = Benchmark(argv[i], grid) && ok;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,301 @@
+// 経路探索のグラフ (MapChipNavGraph) をタイルの書き換えに合わせて Update したとき、Build し直したものと同じになるかを確かめるツール
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /ITools /Fe:MapChipNavCheck.exe Tools\MapChipNavCheck.cpp MapChipNavGraph.cpp MapChipFieldEdit.cpp MapChipSnapshot.cpp MapChipBitPlanes.cpp MapChipTileStore.cpp MapChipFormat.cpp MappedFile.cpp
+//
+// 使い方
+//   MapChipNavCheck [<map.csv>...]
+//
+// 乱数で作ったマップ（床の段が並んだもの）と、指定したマップそれぞれについて、
+// 狭い範囲にまとめた書き換えと、マップ全体に散らした書き換えを MapChipField::SetTile で交互に行い、
+// GameScene::UpdateBlockChunks と同じく GetPendingTileChanges を Update へ渡したあとで次を確かめる
+//   1. 区間・出るリンク・入るリンクが、同じスナップショットから Build したものと一致する（番号の付け方は問わない）
+//   2. 空きの番号にリンクが残っていない・リンクの両端が使われている区間を指しているなど、番号がつじつまが合っている
+//   3. 使い回している MapChipNavFlowField のコストが、Build したグラフで総当たりに求めた最短経路と一致し、
+//      次のリンクをたどるとコストがリンクの分だけ減る
+// 1 つでも崩れていれば終了コード 1 を返す
+
+#include "MapChipField.h"
+#include "MapChipNavGraph.h"
+#include "MapChipQueryStream.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+// 1 マップあたりの書き換えのまとまりの数と、1 まとまりの最大の書き換え数
+constexpr uint32_t kBatchCount = 300;
+constexpr uint32_t kMaxBatchEdits = 24;
+// まとめた書き換えを置く範囲（タイル数）
+constexpr uint32_t kClusterWidth = 6;
+constexpr uint32_t kClusterHeight = 4;
+// 探索を打ち切らない場合のコストの上限（どの経路もこれより短い）
+constexpr uint32_t kUnlimitedCost = 1u << 24;
+
+struct GeneratedMap {
+	uint32_t width;
+	uint32_t height;
+	uint32_t floorPercent; // 床の段のうち塞がっているタイルの割合
+};
+
+// ビットプレーンのワード (64 タイル) の倍数でない幅や、ジャンプで届く範囲より狭いマップも混ぜる
+constexpr GeneratedMap kGeneratedMaps[] = {
+    {1, 3, 100}, {5, 4, 50}, {64, 12, 70}, {150, 24, 80}, {300, 40, 60}, {1000, 16, 90},
+};
+
+/// <summary>
+/// 書き換えに使う種別（空白・ブロックを多めにし、棘・はしご・氷など立ち方の変わる種別も混ぜる）
+/// </summary>
+MapChipType RandomTile(std::mt19937& rng) {
+	switch (rng() % 4) {
+	case 0:
+		return MapChipType::kBlank;
+	case 1:
+		return MapChipType::kBlock;
+	default:
+		return static_cast<MapChipType>(rng() % kMapChipTypeCount);
+	}
+}
+
+MapChipGrid Generate(const GeneratedMap& spec, uint32_t seed) {
+	std::mt19937 rng(seed);
+	MapChipGrid grid;
+	grid.width = spec.width;
+	grid.height = spec.height;
+	grid.tiles.assign(static_cast<size_t>(spec.width) * spec.height, MapChipType::kBlank);
+	for (uint32_t y = 0; y < spec.height; ++y) {
+		for (uint32_t x = 0; x < spec.width; ++x) {
+			MapChipType& tile = grid.tiles[static_cast<size_t>(y) * spec.width + x];
+			if (y + 2 >= spec.height) {
+				tile = MapChipType::kBlock;
+			} else if (y % 4 == 3 && rng() % 100 < spec.floorPercent) {
+				tile = MapChipType::kBlock;
+			} else if (rng() % 40 == 0) {
+				tile = static_cast<MapChipType>(rng() % kMapChipTypeCount);
+			}
+		}
+	}
+	return grid;
+}
+
+// 番号に依らない区間とリンクの表し方
+using NodeKey = std::tuple<uint32_t, uint32_t, uint32_t>; // yIndex, x0, x1
+using LinkKey = std::tuple<uint8_t, NodeKey, NodeKey, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+struct CanonicalNode {
+	std::vector<LinkKey> outgoing;
+	std::vector<LinkKey> incoming;
+
+	bool operator==(const CanonicalNode&) const = default;
+};
+
+NodeKey ToKey(const MapChipNavNode& node) { return {node.yIndex, node.x0, node.x1}; }
+
+LinkKey ToKey(const MapChipNavGraph& graph, const MapChipNavLink& link) {
+	return {static_cast<uint8_t>(link.kind), ToKey(graph.GetNode(link.fromNode)), ToKey(graph.GetNode(link.toNode)), link.takeoff.xIndex, link.takeoff.yIndex, link.landing.xIndex,
+	        link.landing.yIndex, link.cost};
+}
+
+bool IsFree(const MapChipNavNode& node) { return node.yIndex == kMapChipNavNone; }
+
+/// <summary>
+/// グラフを番号に依らない形にする。番号のつじつまが合わなければ what に書いて false
+/// </summary>
+bool Canonicalize(const MapChipNavGraph& graph, std::map<NodeKey, CanonicalNode>& out, std::string& what) {
+	out.clear();
+	std::span<const MapChipNavNode> nodes = graph.GetNodes();
+	for (uint32_t n = 0; n < nodes.size(); ++n) {
+		const MapChipNavNode& node = nodes[n];
+		if (IsFree(node)) {
+			if (!graph.GetLinks(n).empty() || !graph.GetIncomingLinks(n).empty()) {
+				what = "free node " + std::to_string(n) + " has links";
+				return false;
+			}
+			continue;
+		}
+		if (graph.FindNode(node.x0, node.yIndex) != n || graph.FindNode(node.x1, node.yIndex) != n) {
+			what = "FindNode does not return node " + std::to_string(n);
+			return false;
+		}
+
+		CanonicalNode& canonical = out[ToKey(node)];
+		if (!canonical.outgoing.empty() || !canonical.incoming.empty()) {
+			what = "node " + std::to_string(n) + " is duplicated";
+			return false;
+		}
+		for (const MapChipNavLink& link : graph.GetLinks(n)) {
+			if (link.fromNode != n || link.toNode >= nodes.size() || IsFree(nodes[link.toNode])) {
+				what = "outgoing link of node " + std::to_string(n) + " has bad ends";
+				return false;
+			}
+			canonical.outgoing.push_back(ToKey(graph, link));
+		}
+		for (uint32_t l : graph.GetIncomingLinks(n)) {
+			const MapChipNavLink& link = graph.GetLink(l);
+			if (link.toNode != n || link.fromNode >= nodes.size() || IsFree(nodes[link.fromNode])) {
+				what = "incoming link of node " + std::to_string(n) + " has bad ends";
+				return false;
+			}
+			canonical.incoming.push_back(ToKey(graph, link));
+		}
+		std::sort(canonical.outgoing.begin(), canonical.outgoing.end());
+		std::sort(canonical.incoming.begin(), canonical.incoming.end());
+	}
+	return true;
+}
+
+/// <summary>
+/// 目的地までのコストを、全リンクの緩和を変化がなくなるまで繰り返して求める（maxCost を超えるものは kMapChipNavNone）
+/// </summary>
+std::vector<uint32_t> BruteForceCosts(const MapChipNavGraph& graph, uint32_t target, uint32_t maxCost) {
+	std::vector<uint32_t> cost(graph.GetNodes().size(), kMapChipNavNone);
+	cost[target] = 0;
+	for (bool changed = true; changed;) {
+		changed = false;
+		for (uint32_t n = 0; n < cost.size(); ++n) {
+			if (IsFree(graph.GetNode(n))) {
+				continue;
+			}
+			for (const MapChipNavLink& link : graph.GetLinks(n)) {
+				if (cost[link.toNode] == kMapChipNavNone) {
+					continue;
+				}
+				uint32_t c = cost[link.toNode] + link.cost;
+				if (c <= maxCost && c < cost[n]) {
+					cost[n] = c;
+					changed = true;
+				}
+			}
+		}
+	}
+	return cost;
+}
+
+/// <summary>
+/// Update したグラフで使い回している flowField が、Build したグラフで総当たりに求めたコストと一致するか
+/// </summary>
+bool SameFlowField(const MapChipNavGraph& updated, const MapChipNavGraph& built, MapChipNavFlowField& flowField, uint32_t builtTarget, uint32_t maxCost, std::string& what) {
+	const MapChipNavNode& target = built.GetNode(builtTarget);
+	uint32_t updatedTarget = updated.FindNode(target.x0, target.yIndex);
+	flowField.SetMaxCost(maxCost);
+	flowField.Update(updated, updatedTarget, target.x0);
+
+	std::vector<uint32_t> expected = BruteForceCosts(built, builtTarget, maxCost);
+	for (uint32_t n = 0; n < expected.size(); ++n) {
+		const MapChipNavNode& node = built.GetNode(n);
+		uint32_t u = updated.FindNode(node.x0, node.yIndex);
+		uint32_t cost = flowField.GetCost(u);
+		if (cost != expected[n]) {
+			what = "cost of node (" + std::to_string(node.x0) + ", " + std::to_string(node.yIndex) + ") is " + std::to_string(cost) + ", shortest path is " + std::to_string(expected[n]);
+			return false;
+		}
+		if (cost == kMapChipNavNone || u == updatedTarget) {
+			continue;
+		}
+		uint32_t l = flowField.GetNextLink(u);
+		if (l == kMapChipNavNone || updated.GetLink(l).fromNode != u || flowField.GetCost(updated.GetLink(l).toNode) + updated.GetLink(l).cost != cost) {
+			what = "next link of node (" + std::to_string(node.x0) + ", " + std::to_string(node.yIndex) + ") does not follow the costs";
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Check(const std::string& name, MapChipGrid grid, uint32_t seed) {
+	MapChipStage stage;
+	stage.collision = std::move(grid);
+	MapChipField field;
+	field.LoadMapChipStage(stage);
+	const uint32_t width = field.GetNumBlockHorizontal();
+	const uint32_t height = field.GetNumBlockVertical();
+
+	MapChipNavGraph updated;
+	updated.Build(*field.GetSnapshot());
+	// 敵が共有するものと同じく、グラフが変わるたびに探索し直す flow field を使い回す
+	MapChipNavFlowField flowField;
+	MapChipNavFlowField unlimitedFlowField;
+
+	std::mt19937 rng(seed);
+	MapChipNavGraph built;
+	std::map<NodeKey, CanonicalNode> updatedCanonical;
+	std::map<NodeKey, CanonicalNode> builtCanonical;
+	std::string what;
+	uint32_t applied = 0;
+
+	for (uint32_t batch = 0; batch < kBatchCount; ++batch) {
+		bool clustered = batch % 2 == 0;
+		uint32_t originX = rng() % width;
+		uint32_t originY = rng() % height;
+		uint32_t edits = 1 + rng() % kMaxBatchEdits;
+		for (uint32_t i = 0; i < edits; ++i) {
+			uint32_t x = clustered ? std::min<uint32_t>(originX + rng() % kClusterWidth, width - 1) : rng() % width;
+			uint32_t y = clustered ? std::min<uint32_t>(originY + rng() % kClusterHeight, height - 1) : rng() % height;
+			field.SetTile(x, y, RandomTile(rng));
+		}
+
+		// GameScene::UpdateBlockChunks と同じく、通知を渡してから捨てる
+		std::shared_ptr<const MapChipSnapshot> snapshot = field.GetSnapshot();
+		applied += static_cast<uint32_t>(field.GetPendingTileChanges().size());
+		updated.Update(*snapshot, field.GetPendingTileChanges());
+		field.ClearPendingTileChanges();
+
+		built.Build(*snapshot);
+		if (!Canonicalize(updated, updatedCanonical, what) || !Canonicalize(built, builtCanonical, what)) {
+			std::fprintf(stderr, "%s: batch %u: %s\n", name.c_str(), batch, what.c_str());
+			return false;
+		}
+		if (updatedCanonical != builtCanonical) {
+			auto a = updatedCanonical.begin();
+			auto b = builtCanonical.begin();
+			for (; a != updatedCanonical.end() && b != builtCanonical.end() && *a == *b; ++a, ++b) {
+			}
+			const NodeKey& key = a != updatedCanonical.end() ? a->first : b->first;
+			std::fprintf(stderr, "%s: batch %u: the updated graph differs from Build around the span at row %u, x %u-%u\n", name.c_str(), batch, std::get<0>(key), std::get<1>(key),
+			             std::get<2>(key));
+			return false;
+		}
+
+		// 目的地は Build したグラフの区間から選ぶ（Build したグラフに空きの番号はない）
+		if (built.GetNodes().empty()) {
+			continue;
+		}
+		uint32_t target = static_cast<uint32_t>(rng() % built.GetNodes().size());
+		if (!SameFlowField(updated, built, flowField, target, MapChipNavFlowField::kDefaultMaxCost, what) ||
+		    !SameFlowField(updated, built, unlimitedFlowField, target, kUnlimitedCost, what)) {
+			std::fprintf(stderr, "%s: batch %u: flow field: %s\n", name.c_str(), batch, what.c_str());
+			return false;
+		}
+	}
+
+	std::printf("%s (%ux%u): ok, %zu spans after %u edits in %u batches\n", name.c_str(), width, height, builtCanonical.size(), applied, kBatchCount);
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	bool ok = true;
+	uint32_t seed = 1;
+	for (const GeneratedMap& spec : kGeneratedMaps) {
+		for (uint32_t i = 0; i < 2; ++i, ++seed) {
+			std::string name = "generated " + std::to_string(spec.floorPercent) + "% floor seed " + std::to_string(seed);
+			ok = Check(name, Generate(spec, seed), seed) && ok;
+		}
+	}
+
+	for (int i = 1; i < argc; ++i) {
+		MapChipGrid grid;
+		if (!LoadMap(argv[i], grid)) {
+			ok = false;
+			continue;
+		}
+		ok = Check(argv[i], std::move(grid), static_cast<uint32_t>(i)) && ok;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+// ベンチマーク用ツールが共有する、当たり判定のタイル参照を模したクエリ列（Tools 以下でだけ使う）
+//   プレイヤー: 地形に沿ってマップを端から端まで歩き、毎フレーム 4 隅 + 足元 3 点 + 頭上 1 点を引く
+//   敵: 地面の上に散らばった kEnemyCount 体が往復し、毎フレーム 中心・前方・前方の下 を引く
+// 長すぎるマップではクエリ数が kMaxStreamQueries に達したところで打ち切る
+
+#include "MapChipFormat.h"
+#include "MappedFile.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+struct TileQuery {
+	uint32_t x;
+	uint32_t y;
+};
+
+inline constexpr uint32_t kMaxReportedErrors = 16;
+inline constexpr uint32_t kEnemyCount = 64;
+inline constexpr uint32_t kEnemyPatrolTiles = 8;
+// 1 フレームの移動量（タイル）
+inline constexpr float kPlayerSpeed = 0.15f;
+inline constexpr float kEnemySpeed = 0.05f;
+// クエリ列の長さの上限と、計測ごとのクエリ数の目安
+inline constexpr size_t kMaxStreamQueries = 16'000'000;
+inline constexpr size_t kMinQueriesPerRun = 50'000'000;
+
+class Grid {
+public:
+	explicit Grid(const MapChipGrid& grid) : grid_(grid) {}
+
+	uint32_t Width() const { return grid_.width; }
+	uint32_t Height() const { return grid_.height; }
+
+	bool IsGround(int64_t x, int64_t y) const {
+		if (x < 0 || y < 0 || x >= grid_.width || y >= grid_.height) {
+			return false;
+		}
+		return GetMapChipProperty(grid_.tiles[static_cast<size_t>(y) * grid_.width + x]).ground;
+	}
+
+	// タイル (x, y) の上に立てるか（自身は空いていて、すぐ下が地面）
+	bool IsStandable(int64_t x, int64_t y) const { return !IsGround(x, y) && IsGround(x, y + 1); }
+
+private:
+	const MapChipGrid& grid_;
+};
+
+inline void PushQuery(std::vector<TileQuery>& queries, const Grid& grid, float x, float y) {
+	if (x < 0.0f || y < 0.0f || x >= grid.Width() || y >= grid.Height()) {
+		return;
+	}
+	queries.push_back({static_cast<uint32_t>(x), static_cast<uint32_t>(y)});
+}
+
+inline std::vector<TileQuery> GenerateQueries(const MapChipGrid& map) {
+	Grid grid(map);
+	std::vector<TileQuery> queries;
+
+	// 敵は立てる場所にランダムに置く
+	std::mt19937 rng(12345);
+	struct Walker {
+		float x;
+		float y;
+		float originX;
+		float dir;
+	};
+	std::vector<Walker> enemies;
+	for (uint32_t tries = 0; tries < kEnemyCount * 100 && enemies.size() < kEnemyCount; ++tries) {
+		uint32_t x = rng() % grid.Width();
+		uint32_t y = rng() % grid.Height();
+		if (grid.IsStandable(x, y)) {
+			enemies.push_back({x + 0.5f, y + 0.5f, x + 0.5f, 1.0f});
+		}
+	}
+
+	// プレイヤーは左端の一番上の立てる場所から始める（なければ最上段）
+	float px = 0.5f;
+	float py = 0.5f;
+	for (uint32_t y = 0; y < grid.Height(); ++y) {
+		if (grid.IsStandable(0, y)) {
+			py = y + 0.5f;
+			break;
+		}
+	}
+
+	while (px < grid.Width() && queries.size() < kMaxStreamQueries) {
+		// プレイヤー: 前が壁なら立てる高さまで登り、足元が空いていれば立てる高さまで落ちる
+		int64_t tx = static_cast<int64_t>(px);
+		int64_t ty = static_cast<int64_t>(py);
+		while (ty > 0 && grid.IsGround(tx, ty)) {
+			--ty;
+		}
+		while (ty + 1 < grid.Height() && !grid.IsGround(tx, ty + 1)) {
+			++ty;
+		}
+		py = ty + 0.5f;
+
+		constexpr float kHalf = 0.4f;
+		PushQuery(queries, grid, px - kHalf, py - kHalf);
+		PushQuery(queries, grid, px + kHalf, py - kHalf);
+		PushQuery(queries, grid, px - kHalf, py + kHalf);
+		PushQuery(queries, grid, px + kHalf, py + kHalf);
+		PushQuery(queries, grid, px - kHalf * 0.9f, py + 0.51f);
+		PushQuery(queries, grid, px, py + 0.51f);
+		PushQuery(queries, grid, px + kHalf * 0.9f, py + 0.51f);
+		PushQuery(queries, grid, px, py - 0.51f);
+		px += kPlayerSpeed;
+
+		// 敵: 壁か崖で折り返す
+		for (Walker& e : enemies) {
+			float aheadX = e.x + e.dir;
+			PushQuery(queries, grid, e.x, e.y);
+			PushQuery(queries, grid, aheadX, e.y);
+			PushQuery(queries, grid, aheadX, e.y + 1.0f);
+			bool blocked = grid.IsGround(static_cast<int64_t>(aheadX), static_cast<int64_t>(e.y)) ||
+			               !grid.IsGround(static_cast<int64_t>(aheadX), static_cast<int64_t>(e.y) + 1) ||
+			               std::fabs(aheadX - e.originX) > kEnemyPatrolTiles;
+			if (blocked) {
+				e.dir = -e.dir;
+			} else {
+				e.x += e.dir * kEnemySpeed;
+			}
+		}
+	}
+	return queries;
+}
+
+inline bool LoadMap(const std::string& path, MapChipGrid& grid) {
+	MappedFile file;
+	if (!file.Open(path)) {
+		std::fprintf(stderr, "%s: failed to open\n", path.c_str());
+		return false;
+	}
+	std::vector<MapChipCsvError> errors;
+	uint32_t errorCount = ParseMapChipCsv(file.GetData(), file.GetSize(), grid, errors, kMaxReportedErrors);
+	if (errorCount > 0 || grid.height == 0) {
+		std::fprintf(stderr, "%s: invalid map\n", path.c_str());
+		return false;
+	}
+	return true;
+}
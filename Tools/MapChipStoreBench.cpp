@@ -0,0 +1,252 @@
+// タイルの格納方式 (MapChipTileStore.h) の比較用ベンチマーク
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /ITools /Fe:MapChipStoreBench.exe Tools\MapChipStoreBench.cpp MapChipSnapshot.cpp MapChipBitPlanes.cpp MapChipTileStore.cpp MapChipFormat.cpp MappedFile.cpp
+//
+// 使い方
+//   MapChipStoreBench <map.csv>...                               マップごとに密な配列と連長圧縮を比べる
+//   MapChipStoreBench --sparse <width> <height> [<out.csv>]      大半が空白の生成マップを作って比べる（out.csv に保存もできる）
+//
+// 比べるのはメモリと 1 回の参照の時間
+//   memory: タイルの格納だけの大きさと、MapChipSnapshot 全体の大きさ
+//           レイヤーと生成位置の索引は格納方式に関わらず同じなので、実際に作ったスナップショットの内訳から取る
+//           ビットプレーンと距離場は密な配列のときだけ持つ（kMapChipStoreBitPlanes）ので、密な側にだけ足す
+//   probe : 当たり判定を模したクエリ列（Tools/MapChipQueryStream.h）
+//   random: 同じ数の一様ランダムな参照（アクセス順に依らないことの確認）
+// 連長圧縮でスナップショット全体が密な配列の 1/kTargetRatio 以下に収まれば target met と表示する
+
+#include "MapChipBitPlanes.h"
+#include "MapChipFormat.h"
+#include "MapChipQueryStream.h"
+#include "MapChipSnapshot.h"
+#include "MapChipTileStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double kTargetRatio = 10.0;
+
+// 生成マップの地形（タイル数）
+constexpr uint32_t kGroundRows = 2;
+constexpr uint32_t kMinPitInterval = 12;
+constexpr uint32_t kMaxPitInterval = 40;
+constexpr uint32_t kMinPitWidth = 2;
+constexpr uint32_t kMaxPitWidth = 5;
+constexpr uint32_t kPlatformInterval = 10;
+constexpr uint32_t kMinPlatformWidth = 3;
+constexpr uint32_t kMaxPlatformWidth = 12;
+
+/// <summary>
+/// 生成ステージを模した疎なマップ
+/// 穴の空いた地面、宙に浮いた足場、足場へのはしご、穴の底の棘、足場の上の敵を置く
+/// </summary>
+MapChipGrid GenerateSparseMap(uint32_t width, uint32_t height, uint32_t seed) {
+	MapChipGrid grid;
+	grid.width = width;
+	grid.height = height;
+	grid.tiles.assign(static_cast<size_t>(width) * height, MapChipType::kBlank);
+	auto at = [&](uint32_t x, uint32_t y) -> MapChipType& { return grid.tiles[static_cast<size_t>(y) * width + x]; };
+
+	std::mt19937 rng(seed);
+	auto range = [&](uint32_t lo, uint32_t hi) { return lo + static_cast<uint32_t>(rng() % (hi - lo + 1)); };
+
+	// 地面（下から kGroundRows 行）と穴
+	uint32_t groundTop = height > kGroundRows ? height - kGroundRows : 0;
+	for (uint32_t y = groundTop; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			at(x, y) = MapChipType::kBlock;
+		}
+	}
+	for (uint32_t x = range(kMinPitInterval, kMaxPitInterval); x < width; x += range(kMinPitInterval, kMaxPitInterval)) {
+		uint32_t pitWidth = range(kMinPitWidth, kMaxPitWidth);
+		for (uint32_t px = x; px < std::min(width, x + pitWidth); ++px) {
+			for (uint32_t y = groundTop; y + 1 < height; ++y) {
+				at(px, y) = MapChipType::kBlank;
+			}
+			at(px, height - 1) = MapChipType::kSpike;
+		}
+		x += pitWidth;
+	}
+
+	// 足場。地面より 3 タイル以上上の高さに置き、たまに氷にする
+	if (groundTop > 4) {
+		for (uint32_t x = range(0, kPlatformInterval); x < width; x += range(kPlatformInterval / 2, kPlatformInterval * 3 / 2)) {
+			uint32_t y = range(1, groundTop - 4);
+			uint32_t platformWidth = std::min(range(kMinPlatformWidth, kMaxPlatformWidth), width - x);
+			MapChipType type = rng() % 5 == 0 ? MapChipType::kIce : MapChipType::kBlock;
+			for (uint32_t px = x; px < x + platformWidth; ++px) {
+				at(px, y) = type;
+			}
+			if (rng() % 3 == 0 && y > 0) {
+				at(x + platformWidth / 2, y - 1) = MapChipType::kEnemySpawn;
+			}
+			if (rng() % 4 == 0) {
+				for (uint32_t ly = y + 1; ly < groundTop && at(x, ly) == MapChipType::kBlank; ++ly) {
+					at(x, ly) = MapChipType::kLadder;
+				}
+			}
+		}
+	}
+	return grid;
+}
+
+bool WriteCsv(const std::string& path, const MapChipGrid& grid) {
+	FILE* fp = std::fopen(path.c_str(), "wb");
+	if (!fp) {
+		return false;
+	}
+	for (uint32_t y = 0; y < grid.height; ++y) {
+		for (uint32_t x = 0; x < grid.width; ++x) {
+			std::fprintf(fp, x + 1 < grid.width ? "%u," : "%u\n", static_cast<uint32_t>(grid.tiles[static_cast<size_t>(y) * grid.width + x]));
+		}
+	}
+	return std::fclose(fp) == 0;
+}
+
+struct RunResult {
+	double nsPerQuery;
+	uint64_t checksum;
+};
+
+template <typename Store> RunResult Replay(const Store& store, const std::vector<TileQuery>& queries) {
+	size_t repeats = std::max<size_t>(1, kMinQueriesPerRun / std::max<size_t>(1, queries.size()));
+	uint64_t checksum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < repeats; ++r) {
+		for (const TileQuery& q : queries) {
+			checksum += GetMapChipProperty(store.Get(q.x, q.y)).ground;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	return {ns / static_cast<double>(repeats * queries.size()), checksum / repeats};
+}
+
+std::vector<TileQuery> GenerateRandomQueries(const MapChipGrid& grid, size_t count) {
+	std::mt19937 rng(54321);
+	std::vector<TileQuery> queries(count);
+	for (TileQuery& q : queries) {
+		q = {static_cast<uint32_t>(rng() % grid.width), static_cast<uint32_t>(rng() % grid.height)};
+	}
+	return queries;
+}
+
+// 連長圧縮から展開した内容が元のタイルと一致するか
+bool Matches(const MapChipRunLengthTileStore& store, const MapChipGrid& grid) {
+	for (uint32_t y = 0; y < grid.height; ++y) {
+		bool ok = true;
+		store.ForEachRun(y, [&](uint32_t x, uint32_t count, MapChipType type) {
+			for (uint32_t i = x; i < x + count; ++i) {
+				ok = ok && grid.tiles[static_cast<size_t>(y) * grid.width + i] == type;
+			}
+		});
+		if (!ok) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Benchmark(const std::string& name, const MapChipGrid& grid) {
+	MapChipDenseTileStore dense;
+	dense.Assign(grid.tiles.data(), grid.width, grid.height);
+	MapChipRunLengthTileStore runLength;
+	runLength.Assign(grid.tiles.data(), grid.width, grid.height);
+	if (!Matches(runLength, grid)) {
+		std::fprintf(stderr, "%s: run-length store does not round-trip\n", name.c_str());
+		return false;
+	}
+
+	size_t blank = std::count(grid.tiles.begin(), grid.tiles.end(), MapChipType::kBlank);
+	std::vector<TileQuery> probe = GenerateQueries(grid);
+	std::vector<TileQuery> random = GenerateRandomQueries(grid, std::max<size_t>(probe.size(), 1));
+
+	RunResult denseProbe = Replay(dense, probe);
+	RunResult runLengthProbe = Replay(runLength, probe);
+	RunResult denseRandom = Replay(dense, random);
+	RunResult runLengthRandom = Replay(runLength, random);
+	if (denseProbe.checksum != runLengthProbe.checksum || denseRandom.checksum != runLengthRandom.checksum) {
+		std::fprintf(stderr, "%s: stores disagree\n", name.c_str());
+		return false;
+	}
+
+	// ゲームと同じ手順でスナップショットを作り、格納方式に依らない分（レイヤー・生成位置の索引）の内訳を取る
+	MapChipStage stage;
+	stage.collision = grid;
+	MapChipSnapshotMemory memory = MapChipSnapshot::CreateFromStage(stage)->GetMemoryUsage();
+	size_t shared = memory.layers + memory.spawnIndex;
+
+	// 密な配列のときにだけ持つビットプレーンと距離場
+	MapChipBitPlanes planes;
+	planes.Build(dense, grid.width, grid.height);
+	size_t derived = planes.GetPlaneBytes() + planes.GetDistanceFieldBytes();
+
+	size_t denseTotal = shared + derived + dense.GetMemoryBytes();
+	size_t runLengthTotal = shared + runLength.GetMemoryBytes();
+
+	double tileRatio = static_cast<double>(dense.GetMemoryBytes()) / static_cast<double>(runLength.GetMemoryBytes());
+	double totalRatio = static_cast<double>(denseTotal) / static_cast<double>(runLengthTotal);
+	std::printf("%s (%ux%u, %.1f%% blank, %zu runs, %zu probe queries)\n", name.c_str(), grid.width, grid.height,
+	            100.0 * static_cast<double>(blank) / static_cast<double>(grid.tiles.size()), runLength.GetRunCount(), probe.size());
+	std::printf("  shared     : %12zu bytes  (layers %zu, spawn index %zu)\n", shared, memory.layers, memory.spawnIndex);
+	std::printf("  dense only : %12zu bytes  (bit planes %zu, distance fields %zu)\n", derived, planes.GetPlaneBytes(), planes.GetDistanceFieldBytes());
+	std::printf("  dense      : %12zu bytes tiles, %12zu bytes snapshot  probe %6.2f ns/query  random %6.2f ns/query\n", dense.GetMemoryBytes(), denseTotal,
+	            denseProbe.nsPerQuery, denseRandom.nsPerQuery);
+	std::printf("  run-length : %12zu bytes tiles, %12zu bytes snapshot  probe %6.2f ns/query  random %6.2f ns/query\n", runLength.GetMemoryBytes(), runLengthTotal,
+	            runLengthProbe.nsPerQuery, runLengthRandom.nsPerQuery);
+	std::printf("  memory     : tiles %.1fx smaller, snapshot %.2fx smaller (%s)\n", tileRatio, totalRatio,
+	            totalRatio >= kTargetRatio ? "target met, consider MAPCHIP_STORE_RUN_LENGTH" : "below target, keep dense");
+	return true;
+}
+
+void PrintUsage() {
+	std::fprintf(stderr, "usage: MapChipStoreBench <map.csv>...\n"
+	                     "       MapChipStoreBench --sparse <width> <height> [<out.csv>]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		PrintUsage();
+		return 2;
+	}
+
+	if (std::string(argv[1]) == "--sparse") {
+		if (argc != 4 && argc != 5) {
+			PrintUsage();
+			return 2;
+		}
+		uint32_t width = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+		uint32_t height = static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10));
+		if (width == 0 || height == 0) {
+			PrintUsage();
+			return 2;
+		}
+		MapChipGrid grid = GenerateSparseMap(width, height, 12345);
+		if (argc == 5 && !WriteCsv(argv[4], grid)) {
+			std::fprintf(stderr, "%s: failed to write\n", argv[4]);
+			return 1;
+		}
+		return Benchmark("sparse", grid) ? 0 : 1;
+	}
+
+	bool ok = true;
+	for (int i = 1; i < argc; ++i) {
+		MapChipGrid grid;
+		if (!LoadMap(argv[i], grid)) {
+			ok = false;
+			continue;
+		}
+		ok = Benchmark(argv[i], grid) && ok;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,409 @@
+// PlayerPhysics（プレイヤーの移動・当たり判定）を単体で動かすベンチマーク
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）。KamataEngine を使わないので Windows 以外でもビルドできる
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /Fe:PlayerPhysicsBench.exe Tools\PlayerPhysicsBench.cpp PlayerPhysics.cpp PhysicsTrace.cpp InputRecording.cpp MapChipFormat.cpp MappedFile.cpp
+//   g++ -std=c++20 -O2 -I. -o PlayerPhysicsBench Tools/PlayerPhysicsBench.cpp PlayerPhysics.cpp PhysicsTrace.cpp InputRecording.cpp MapChipFormat.cpp MappedFile.cpp
+//
+// 使い方
+//   PlayerPhysicsBench <map.csv> [<frames>] [<seed>]
+//   PlayerPhysicsBench --replay <input_record.bin> <map.csv> [<repeat>]
+//   PlayerPhysicsBench --tunnel
+//
+// 左端に近い立てる位置から、乱数で作った入力（右へ進みがちに、ジャンプ・梯子・回避・攻撃を混ぜる）で frames フレーム動かし、
+// 1 フレームあたりの時間と、全フレームの位置・速度から作ったハッシュを表示する
+// 入力もマップも同じなら結果は必ず同じになるので、ハッシュを比べれば PlayerPhysics を変えたときに挙動が変わったかを確かめられる
+//
+// --replay はゲームで F10 で記録した操作（InputRecording）を、記録を始めた位置から repeat 回（既定 100）通して再生する
+// 実際のプレイの入力なので、ビルド間の性能比較にはこちらを使う。1 回分の軌跡のハッシュが記録と一致するかも表示する
+// （敵に押し戻されるなど、プレイヤーの外から動かされた記録では一致しない）
+//
+// --tunnel は厚さ 1 タイルの床・天井・壁に 1 フレームで 1 タイル以上動く速さでぶつけ、すり抜けないかを確かめる
+// 開始位置をタイル内で少しずつずらして試し、1 つでもすり抜ければ終了コード 1 を返す
+
+#include "MapChipFormat.h"
+#include "InputRecording.h"
+#include "MappedFile.h"
+#include "PlayerPhysics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kDefaultFrames = 1000000;
+constexpr uint32_t kMaxReportedErrors = 16;
+constexpr uint32_t kDefaultReplayRepeat = 100;
+
+/// <summary>
+/// タイル配列から作ったビットプレーンで PlayerMapQuery に答える（MapChipSnapshot と同じ規則）
+/// </summary>
+class GridMapQuery : public PlayerMapQuery {
+public:
+	explicit GridMapQuery(const MapChipGrid& grid) : grid_(grid), wordsPerRow_((grid.width + 63) / 64) {
+		for (uint32_t p = 0; p < kMapChipPlaneCount; ++p) {
+			planes_[p].assign(static_cast<size_t>(wordsPerRow_) * grid.height, 0);
+		}
+		for (uint32_t y = 0; y < grid.height; ++y) {
+			for (uint32_t x = 0; x < grid.width; ++x) {
+				const MapChipProperty& property = GetMapChipProperty(grid.tiles[static_cast<size_t>(y) * grid.width + x]);
+				bool flags[kMapChipPlaneCount] = {property.solid, property.ground, property.hazard, property.climbable};
+				for (uint32_t p = 0; p < kMapChipPlaneCount; ++p) {
+					if (flags[p]) {
+						planes_[p][static_cast<size_t>(y) * wordsPerRow_ + x / 64] |= 1ull << (x % 64);
+					}
+				}
+			}
+		}
+	}
+
+	uint32_t GetNumBlockHorizontal() const override {
+		++calls_;
+		return grid_.width;
+	}
+	uint32_t GetNumBlockVertical() const override {
+		++calls_;
+		return grid_.height;
+	}
+
+	MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) const override {
+		++calls_;
+		++tileReads_;
+		if (xIndex >= grid_.width || yIndex >= grid_.height) {
+			return MapChipType::kBlank;
+		}
+		return grid_.tiles[static_cast<size_t>(yIndex) * grid_.width + xIndex];
+	}
+
+	bool AnyInRect(MapChipPlane plane, int32_t x0, int32_t y0, int32_t x1, int32_t y1) const override {
+		++calls_;
+		x0 = std::max(x0, 0);
+		y0 = std::max(y0, 0);
+		x1 = std::min(x1, static_cast<int32_t>(grid_.width) - 1);
+		y1 = std::min(y1, static_cast<int32_t>(grid_.height) - 1);
+		if (x0 <= x1 && y0 <= y1) {
+			tileReads_ += static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1);
+		}
+		const std::vector<uint64_t>& bits = planes_[static_cast<uint32_t>(plane)];
+		for (int32_t y = y0; y <= y1; ++y) {
+			for (int32_t x = x0; x <= x1; ++x) {
+				if ((bits[static_cast<size_t>(y) * wordsPerRow_ + x / 64] >> (x % 64)) & 1) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// PlayerPhysics が読んだタイルの数（AnyInRect はマップ内にクリップした矩形の面積、GetMapChipTypeByIndex は 1）
+	uint64_t GetTileReadCount() const { return tileReads_; }
+
+	// PlayerPhysics からの呼び出し回数（どのメソッドも 1 回と数える）
+	uint64_t GetCallCount() const { return calls_; }
+
+private:
+	const MapChipGrid& grid_;
+	mutable uint64_t tileReads_ = 0;
+	mutable uint64_t calls_ = 0;
+	uint32_t wordsPerRow_;
+	std::vector<uint64_t> planes_[kMapChipPlaneCount];
+};
+
+/// <summary>
+/// 押しっぱなしの長さを乱数で決める入力の列
+/// </summary>
+class RandomInput {
+public:
+	explicit RandomInput(uint32_t seed) : rng_(seed) {}
+
+	const PlayerInput& Next() {
+		Hold(input_.right, holdRight_, 30, 60);
+		Hold(input_.left, holdLeft_, 8, 20);
+		Hold(input_.jumpKey, holdJump_, 10, 20);
+		Hold(input_.up, holdUp_, 4, 20);
+		Hold(input_.down, holdDown_, 4, 20);
+		Hold(input_.dodgeKey, holdDodge_, 4, 20);
+		Hold(input_.attackKey, holdAttack_, 4, 20);
+		return input_;
+	}
+
+private:
+	std::mt19937 rng_;
+	PlayerInput input_;
+	uint32_t holdRight_ = 0;
+	uint32_t holdLeft_ = 0;
+	uint32_t holdJump_ = 0;
+	uint32_t holdUp_ = 0;
+	uint32_t holdDown_ = 0;
+	uint32_t holdDodge_ = 0;
+	uint32_t holdAttack_ = 0;
+
+	// 押していなければ percent % の確率で押し始め、1 ～ maxFrames フレーム押し続ける
+	void Hold(bool& key, uint32_t& frames, uint32_t percent, uint32_t maxFrames) {
+		if (frames > 0) {
+			key = --frames > 0;
+		} else if (rng_() % 100 < percent) {
+			key = true;
+			frames = 1 + rng_() % maxFrames;
+		}
+	}
+};
+
+bool LoadGrid(const std::string& path, MapChipGrid& grid) {
+	MappedFile file;
+	if (!file.Open(path)) {
+		std::fprintf(stderr, "%s: failed to open\n", path.c_str());
+		return false;
+	}
+	MapChipStage stage;
+	std::vector<MapChipCsvError> errors;
+	uint32_t errorCount = ParseMapChipStageCsv(file.GetData(), file.GetSize(), stage, errors, kMaxReportedErrors);
+	for (const MapChipCsvError& e : errors) {
+		std::fprintf(stderr, "%s:%u:%u: invalid cell '%s'\n", path.c_str(), e.row, e.column, e.text.c_str());
+	}
+	if (errorCount > 0 || stage.collision.height == 0) {
+		return false;
+	}
+	grid = std::move(stage.collision);
+	return true;
+}
+
+/// <summary>
+/// 左端から見て最初の立てる位置（自身と 1 つ上が solid でなく、すぐ下が ground）
+/// </summary>
+bool FindStart(const MapChipGrid& grid, PlayerVector2& position) {
+	auto property = [&](uint32_t x, uint32_t y) { return GetMapChipProperty(grid.tiles[static_cast<size_t>(y) * grid.width + x]); };
+	for (uint32_t x = 1; x < grid.width; ++x) {
+		for (uint32_t y = 1; y + 1 < grid.height; ++y) {
+			if (!property(x, y).solid && !property(x, y - 1).solid && property(x, y + 1).ground) {
+				position = {kMapChipBlockWidth * x, kMapChipBlockHeight * (grid.height - 1 - y)};
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// --tunnel 用のマップの大きさと、厚さ 1 タイルの床・天井・壁の位置
+constexpr uint32_t kTunnelMapSize = 40;
+constexpr uint32_t kTunnelFloorRow = 30;
+constexpr uint32_t kTunnelCeilingRow = 10;
+constexpr uint32_t kTunnelWallColumn = 20;
+
+// 1 ケースで進めるフレーム数と、タイル内で開始位置をずらす数
+constexpr uint32_t kTunnelFrames = 60;
+constexpr uint32_t kTunnelOffsets = 20;
+
+MapChipGrid MakeTunnelGrid(bool floor, bool ceiling, bool wall) {
+	MapChipGrid grid;
+	grid.width = kTunnelMapSize;
+	grid.height = kTunnelMapSize;
+	grid.tiles.assign(static_cast<size_t>(grid.width) * grid.height, MapChipType::kBlank);
+	for (uint32_t i = 0; i < kTunnelMapSize; ++i) {
+		if (floor) {
+			grid.tiles[static_cast<size_t>(kTunnelFloorRow) * grid.width + i] = MapChipType::kBlock;
+		}
+		if (ceiling) {
+			grid.tiles[static_cast<size_t>(kTunnelCeilingRow) * grid.width + i] = MapChipType::kBlock;
+		}
+		if (wall) {
+			grid.tiles[static_cast<size_t>(i) * grid.width + kTunnelWallColumn] = MapChipType::kBlock;
+		}
+	}
+	return grid;
+}
+
+/// <summary>
+/// 開始位置・速度から入力なしで動かし、passed が一度でも真になったら（すり抜けたら）false
+/// </summary>
+template<typename Passed>
+bool RunTunnelCase(const MapChipGrid& grid, const PlayerVector2& start, const PlayerVector2& velocity, Passed passed) {
+	GridMapQuery map(grid);
+	PlayerPhysics physics;
+	physics.SetMapQuery(&map);
+	physics.Initialize(start, 0.3f);
+	physics.SetVelocity(velocity);
+	const PlayerInput input;
+	for (uint32_t frame = 0; frame < kTunnelFrames; ++frame) {
+		physics.Step(input);
+		if (passed(physics.GetPosition())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int RunTunnelCheck() {
+	const float halfWidth = PlayerPhysics::kWidth * 0.5f;
+	const float halfHeight = PlayerPhysics::kHeight * 0.5f;
+	// タイルの端のワールド座標（行 y=0 が一番上）
+	const float floorTop = kMapChipBlockHeight * (kTunnelMapSize - 1 - kTunnelFloorRow) + kMapChipBlockHeight * 0.5f;
+	const float ceilingBottom = kMapChipBlockHeight * (kTunnelMapSize - 1 - kTunnelCeilingRow) - kMapChipBlockHeight * 0.5f;
+	const float wallLeft = kMapChipBlockWidth * kTunnelWallColumn - kMapChipBlockWidth * 0.5f;
+	const float wallRight = wallLeft + kMapChipBlockWidth;
+	const float centerX = kMapChipBlockWidth * (kTunnelWallColumn / 2);
+	const float centerY = (floorTop + ceilingBottom) * 0.5f;
+
+	const MapChipGrid floorGrid = MakeTunnelGrid(true, false, false);
+	const MapChipGrid ceilingGrid = MakeTunnelGrid(false, true, false);
+	const MapChipGrid wallGrid = MakeTunnelGrid(false, false, true);
+	const float speeds[] = {2.5f, 3.0f, 4.0f, 5.0f, 8.0f};
+
+	uint32_t cases = 0;
+	uint32_t failures = 0;
+	auto report = [&](const char* name, float speed, float offset, bool ok) {
+		++cases;
+		if (!ok) {
+			++failures;
+			std::printf("  FAIL %s speed %.1f offset %.2f\n", name, speed, offset);
+		}
+	};
+
+	for (float speed : speeds) {
+		for (uint32_t i = 0; i < kTunnelOffsets; ++i) {
+			float offset = kMapChipBlockHeight * i / kTunnelOffsets;
+
+			// 床: 足元が天面より下に行ったらすり抜け
+			report("floor", speed, offset, RunTunnelCase(floorGrid, {centerX, floorTop + halfHeight + 6.0f + offset}, {0.0f, -speed}, [&](const PlayerVector2& p) {
+				return p.y - halfHeight < floorTop - 0.01f;
+			}));
+
+			// 天井: 頭が下端より上に行ったらすり抜け
+			report("ceiling", speed, offset, RunTunnelCase(ceilingGrid, {centerX, ceilingBottom - halfHeight - 3.0f - offset}, {0.0f, speed}, [&](const PlayerVector2& p) {
+				return p.y + halfHeight > ceilingBottom + 0.01f;
+			}));
+
+			// 壁（右向き・左向き）: 体の端が壁の反対側に出たらすり抜け
+			report("wall right", speed, offset, RunTunnelCase(wallGrid, {wallLeft - halfWidth - 3.0f - offset, centerY}, {speed, 0.0f}, [&](const PlayerVector2& p) {
+				return p.x + halfWidth > wallLeft + 0.01f;
+			}));
+			report("wall left", speed, offset, RunTunnelCase(wallGrid, {wallRight + halfWidth + 3.0f + offset, centerY}, {-speed, 0.0f}, [&](const PlayerVector2& p) {
+				return p.x - halfWidth < wallRight - 0.01f;
+			}));
+		}
+	}
+
+	std::printf("tunnel check: %u cases, %u passed through\n", cases, failures);
+	return failures > 0 ? 1 : 0;
+}
+
+int RunReplay(const char* recordPath, const char* mapPath, uint32_t repeat) {
+	InputRecording recording;
+	if (!LoadInputRecording(recordPath, recording)) {
+		std::fprintf(stderr, "%s: not a version %u input recording\n", recordPath, kInputRecordFileVersion);
+		return 1;
+	}
+	MapChipGrid grid;
+	if (!LoadGrid(mapPath, grid)) {
+		return 1;
+	}
+
+	// 入力の変換は計測から外す（ゲームでも 1 ステップに 1 回だけなので）
+	std::vector<PlayerInput> inputs;
+	inputs.reserve(recording.frames.size());
+	for (const InputRecordFrame& frame : recording.frames) {
+		inputs.push_back(ToPlayerInput(frame));
+	}
+
+	GridMapQuery map(grid);
+	PlayerPhysics physics;
+	physics.SetMapQuery(&map);
+
+	InputTrajectoryHash hash;
+	auto begin = std::chrono::steady_clock::now();
+	for (uint32_t pass = 0; pass < repeat; ++pass) {
+		physics.Initialize(recording.start, 0.3f);
+		for (const PlayerInput& input : inputs) {
+			physics.Step(input);
+			if (pass == 0) {
+				hash.Add(physics.GetPosition(), physics.GetVelocity());
+			}
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	uint64_t frames = static_cast<uint64_t>(inputs.size()) * repeat;
+	double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+	const PlayerVector2& position = physics.GetPosition();
+	std::printf("%s on %s (%ux%u) %zu frames x %u\n", recordPath, mapPath, grid.width, grid.height, inputs.size(), repeat);
+	std::printf("  %.1f ns/frame, %.1f tile reads/frame (%.1f map calls/frame)\n", frames > 0 ? ns / frames : 0.0,
+	            frames > 0 ? static_cast<double>(map.GetTileReadCount()) / frames : 0.0, frames > 0 ? static_cast<double>(map.GetCallCount()) / frames : 0.0);
+	std::printf("  final position (%.3f, %.3f)\n", position.x, position.y);
+	std::printf("  trajectory hash %016llx, %s\n", static_cast<unsigned long long>(hash.GetValue()),
+	            hash.GetValue() == recording.trajectoryHash ? "matches the recording" : "differs from the recording");
+	return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	if (argc == 2 && std::strcmp(argv[1], "--tunnel") == 0) {
+		return RunTunnelCheck();
+	}
+	if ((argc == 4 || argc == 5) && std::strcmp(argv[1], "--replay") == 0) {
+		uint32_t repeat = argc > 4 ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : kDefaultReplayRepeat;
+		return RunReplay(argv[2], argv[3], std::max(repeat, 1u));
+	}
+	if (argc < 2 || argc > 4 || argv[1][0] == '-') {
+		std::fprintf(stderr, "usage: PlayerPhysicsBench <map.csv> [<frames>] [<seed>]\n       PlayerPhysicsBench --replay <input_record.bin> <map.csv> [<repeat>]\n       PlayerPhysicsBench --tunnel\n");
+		return 2;
+	}
+	uint32_t frames = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : kDefaultFrames;
+	uint32_t seed = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 1;
+
+	MapChipGrid grid;
+	if (!LoadGrid(argv[1], grid)) {
+		return 1;
+	}
+	PlayerVector2 start;
+	if (!FindStart(grid, start)) {
+		std::fprintf(stderr, "%s: no place to stand\n", argv[1]);
+		return 1;
+	}
+
+	GridMapQuery map(grid);
+	PlayerPhysics physics;
+	physics.SetMapQuery(&map);
+	physics.Initialize(start, 0.3f);
+
+	// 入力の生成は計測から外す
+	RandomInput random(seed);
+	std::vector<PlayerInput> inputs(frames);
+	for (PlayerInput& input : inputs) {
+		input = random.Next();
+	}
+
+	uint64_t hash = 1469598103934665603ull; // FNV-1a
+	uint32_t jumps = 0;
+	uint32_t groundedFrames = 0;
+	auto begin = std::chrono::steady_clock::now();
+	for (const PlayerInput& input : inputs) {
+		PlayerPhysicsEvents events = physics.Step(input);
+		jumps += events.jumped;
+		groundedFrames += physics.IsOnGround();
+
+		const float values[] = {physics.GetPosition().x, physics.GetPosition().y, physics.GetVelocity().x, physics.GetVelocity().y};
+		for (float value : values) {
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			hash = (hash ^ bits) * 1099511628211ull;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+	const PlayerVector2& position = physics.GetPosition();
+	std::printf("%s (%ux%u) %u frames, seed %u\n", argv[1], grid.width, grid.height, frames, seed);
+	std::printf("  %.1f ns/frame, %.1f tile reads/frame (%.1f map calls/frame)\n", frames > 0 ? ns / frames : 0.0,
+	            frames > 0 ? static_cast<double>(map.GetTileReadCount()) / frames : 0.0, frames > 0 ? static_cast<double>(map.GetCallCount()) / frames : 0.0);
+	std::printf("  final position (%.3f, %.3f), %u jumps, on ground %.1f%% of frames\n", position.x, position.y, jumps,
+	            frames > 0 ? 100.0 * groundedFrames / frames : 0.0);
+	std::printf("  state hash %016llx\n", static_cast<unsigned long long>(hash));
+	return 0;
+}
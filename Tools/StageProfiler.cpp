@@ -0,0 +1,551 @@
+// ステージの規模と 1 フレームあたりの負荷の見積もりを JSON で出力するツール
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /Fe:StageProfiler.exe Tools\StageProfiler.cpp MapChipFormat.cpp MapChipSnapshot.cpp MapChipBitPlanes.cpp MapChipTileStore.cpp MapChipNavGraph.cpp PlayerPhysics.cpp PhysicsTrace.cpp MappedFile.cpp
+//
+// 使い方
+//   StageProfiler [--budget <metric>=<max>]... <stage.csv | stage.mcb>...
+//
+// 読み込みは MapChipField::LoadMapChip と同じ規則（CSV より新しい .mcb があればそちら）で、同じ解析関数と MapChipSnapshot::CreateFromStage を使う
+// 見積もりもゲームと同じエンジン非依存のコード（MapChipSnapshot・BlockChunkStreamer の定数・MapChipNavGraph・PlayerPhysics）で求める
+//
+// 出力（標準出力、ステージごとに 1 要素）
+//   size        : 幅・高さ・読み込んだ形式・レイヤー名
+//   tileTypes   : 当たり判定レイヤーの種別ごとのタイル数（entities・decoration は layers の下に同じ形で出す）
+//   blocks      : ブロックのモデルを持つタイル数と、BlockChunkManager が同時に持つ WorldTransform の最大数
+//   entities    : 生成されるオブジェクトの種類ごとの数（当たり判定レイヤー + entities レイヤー）
+//     total      : 生成タイルすべての数（プレイヤーの開始位置・ステージノードも含む）
+//     collidable : そのうちモデルを持ち、プレイヤーとの当たり判定の対象になるものの数
+//   frame       : 1 フレームの見積もり（回数で表すので、計測する PC に依らない）
+//     drawCalls            : 常駐ブロックの最大数 + オブジェクトのモデル数
+//     entityPairChecks     : プレイヤーとオブジェクトの当たり判定の組数（GameScene は毎フレーム全組を調べる）
+//     playerTileReadsMax   : PlayerPhysics の 1 ステップで読むタイル数の最大（PlayerPhysicsBench と同じ数え方）
+//     playerTileReadsMean  : 同じく平均。立てる位置すべてから MakePlayerScript の入力で動かして数える
+//     enemyProbes          : 歩く敵 (MapChipSpawnKind::kEnemy) 全員が 1 フレームにマップへ問い合わせる回数
+//                            経路グラフの区間の上に生成される敵は区間の端だけで向きを変えるので 0、
+//                            区間の外の敵は Enemy::Update の壁 (TestPlane) と崖 (GetGroundDistance) の 2 回
+//     enemyProbesPerEnemy  : 同じく、歩く敵 1 体あたりの平均
+//   シールド持ち・砲台の敵は移動しないのでタイルを調べない（砲台の弾の Raycast は数えない）
+//
+// --budget で指標ごとの上限を指定すると、超えた指標を budgetExceeded に並べ、終了コード 1 を返す
+// 指標名は JSON のキーを '.' でつないだもの（例: --budget blocks.peakResident=2000 --budget frame.drawCalls=2500）
+
+#include "BlockChunkStreamer.h"
+#include "MapChipFormat.h"
+#include "MapChipNavGraph.h"
+#include "MapChipSnapshot.h"
+#include "MappedFile.h"
+#include "PlayerPhysics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kMaxReportedErrors = 16;
+
+// 立てる位置ごとに PlayerPhysics へ順に与える入力と、それぞれのフレーム数
+struct ScriptStep {
+	PlayerInput input;
+	uint32_t frames;
+};
+
+/// <summary>
+/// 待機・左右の移動・右へジャンプ・左へ回避・梯子を上る、を順に行う入力
+/// </summary>
+std::vector<ScriptStep> MakePlayerScript() {
+	PlayerInput idle;
+	PlayerInput right;
+	right.right = true;
+	PlayerInput left;
+	left.left = true;
+	PlayerInput jumpRight = right;
+	jumpRight.jumpKey = true;
+	PlayerInput dodgeLeft = left;
+	dodgeLeft.dodgeKey = true;
+	PlayerInput climb;
+	climb.up = true;
+	return {{idle, 4}, {right, 8}, {left, 8}, {jumpRight, 12}, {dodgeLeft, 6}, {climb, 4}};
+}
+
+// 経路グラフの区間の外にいる歩く敵が 1 フレームに行う問い合わせ（Enemy::Update の TestPlane と GetGroundDistance）
+constexpr uint32_t kEnemyProbesOffGraph = 2;
+
+// MapChipType の名前（JSON のキー）
+constexpr const char* kTypeNames[] = {
+    "blank", "block", "playerStart", "enemySpawn", "enemySpawnShield", "spike", "goal", "key",
+    "ice", "ladder", "stage", "shooter", "enemySpawnLeft", "enemySpawnShieldRight", "shooterRight",
+};
+static_assert(std::size(kTypeNames) == kMapChipTypeCount, "kTypeNames needs one entry per MapChipType");
+
+// MapChipSpawnKind ごとの名前と、GameScene が生成するオブジェクト 1 つあたりのモデル数
+struct SpawnKindInfo {
+	const char* name;
+	uint32_t models;
+};
+constexpr SpawnKindInfo kSpawnKinds[] = {
+    {"none", 0},
+    {"playerStart", 0}, // プレイヤーは 1 人なので数えない
+    {"enemy", 1},
+    {"shieldEnemy", 2}, // 本体 + 盾
+    {"shooterEnemy", 2}, // 本体 + 砲台
+    {"spike", 1},
+    {"goal", 1},
+    {"key", 1},
+    {"ladder", 1},
+    {"stage", 0}, // SelectScene でだけ使う
+};
+constexpr uint32_t kSpawnKindCount = static_cast<uint32_t>(std::size(kSpawnKinds));
+static_assert(static_cast<uint32_t>(MapChipSpawnKind::kStage) + 1 == kSpawnKindCount, "kSpawnKinds needs one entry per MapChipSpawnKind");
+
+struct Budget {
+	std::string metric;
+	double max;
+};
+
+struct Histogram {
+	uint64_t counts[kMapChipTypeCount] = {};
+
+	void Add(const MapChipSnapshot& map) {
+		for (uint32_t y = 0; y < map.GetNumBlockVertical(); ++y) {
+			for (uint32_t x = 0; x < map.GetNumBlockHorizontal(); ++x) {
+				++counts[static_cast<uint8_t>(map.GetMapChipTypeByIndexUnchecked(x, y))];
+			}
+		}
+	}
+
+	void Add(const MapChipLayer& layer, uint32_t height) {
+		for (uint32_t y = 0; y < height; ++y) {
+			layer.tiles.ForEachRun(y, [&](uint32_t, uint32_t count, MapChipType t) { counts[static_cast<uint8_t>(t)] += count; });
+		}
+	}
+};
+
+/// <summary>
+/// PlayerPhysics からのスナップショットへの問い合わせを、読んだタイル数を数えながら渡す
+/// 数え方は PlayerPhysicsBench と同じ（AnyInRect はマップ内にクリップした矩形の面積、GetMapChipTypeByIndex は 1）
+/// </summary>
+class CountingMapQuery : public PlayerMapQuery {
+public:
+	explicit CountingMapQuery(const MapChipSnapshot& map) : map_(map) {}
+
+	uint32_t GetNumBlockHorizontal() const override { return map_.GetNumBlockHorizontal(); }
+	uint32_t GetNumBlockVertical() const override { return map_.GetNumBlockVertical(); }
+
+	MapChipType GetMapChipTypeByIndex(uint32_t xIndex, uint32_t yIndex) const override {
+		++tileReads_;
+		return map_.GetMapChipTypeByIndex(xIndex, yIndex);
+	}
+
+	bool AnyInRect(MapChipPlane plane, int32_t x0, int32_t y0, int32_t x1, int32_t y1) const override {
+		int64_t width = std::min<int64_t>(x1, map_.GetNumBlockHorizontal() - 1) - std::max(x0, 0) + 1;
+		int64_t height = std::min<int64_t>(y1, map_.GetNumBlockVertical() - 1) - std::max(y0, 0) + 1;
+		if (width > 0 && height > 0) {
+			tileReads_ += static_cast<uint64_t>(width * height);
+		}
+		return map_.AnyInRect(plane, x0, y0, x1, y1);
+	}
+
+	uint64_t GetTileReadCount() const { return tileReads_; }
+
+private:
+	const MapChipSnapshot& map_;
+	mutable uint64_t tileReads_ = 0;
+};
+
+struct StageProfile {
+	std::string path;
+	std::string source; // "csv" / "binary"
+	MapChipStage stage; // 解析結果（タイルは map へ移したあと）
+	std::shared_ptr<const MapChipSnapshot> map;
+
+	Histogram collisionTypes;
+	std::vector<Histogram> layerTypes;
+
+	uint64_t modelTiles = 0;
+	uint64_t peakResidentBlocks = 0;
+	uint64_t nonEmptyChunks = 0;
+
+	uint64_t entities[kSpawnKindCount] = {};
+	uint64_t entityTotal = 0;
+	uint64_t entityCollidable = 0;
+	uint64_t entityModels = 0;
+
+	uint64_t drawCalls = 0;
+	uint64_t entityPairChecks = 0;
+	uint64_t playerTileReadsMax = 0;
+	double playerTileReadsMean = 0.0;
+	uint64_t enemyProbes = 0;
+	double enemyProbesPerEnemy = 0.0;
+
+	uint32_t Width() const { return map ? map->GetNumBlockHorizontal() : 0; }
+	uint32_t Height() const { return map ? map->GetNumBlockVertical() : 0; }
+
+	// --budget で参照する指標（JSON と同じ名前）
+	std::vector<std::pair<std::string, double>> Metrics() const {
+		return {
+		    {"size.width", Width()},
+		    {"size.height", Height()},
+		    {"blocks.modelTiles", static_cast<double>(modelTiles)},
+		    {"blocks.peakResident", static_cast<double>(peakResidentBlocks)},
+		    {"entities.total", static_cast<double>(entityTotal)},
+		    {"entities.collidable", static_cast<double>(entityCollidable)},
+		    {"frame.drawCalls", static_cast<double>(drawCalls)},
+		    {"frame.entityPairChecks", static_cast<double>(entityPairChecks)},
+		    {"frame.playerTileReadsMax", static_cast<double>(playerTileReadsMax)},
+		    {"frame.playerTileReadsMean", playerTileReadsMean},
+		    {"frame.enemyProbes", static_cast<double>(enemyProbes)},
+		    {"frame.enemyProbesPerEnemy", enemyProbesPerEnemy},
+		};
+	}
+};
+
+/// <summary>
+/// MapChipField::LoadMapChip と同じ規則でステージを解析する（CSV より新しい .mcb があればそちら）
+/// スナップショットは Profile で MapChipSnapshot::CreateFromStage から作る
+/// </summary>
+bool LoadStage(const std::string& path, StageProfile& profile) {
+	std::string binaryPath = path.ends_with(kMapChipBinaryExtension) ? path : GetMapChipBinaryPath(path);
+	std::error_code ec;
+	auto binaryTime = std::filesystem::last_write_time(binaryPath, ec);
+	bool useBinary = !ec;
+	if (useBinary && binaryPath != path) {
+		std::error_code csvEc;
+		auto csvTime = std::filesystem::last_write_time(path, csvEc);
+		useBinary = csvEc || binaryTime >= csvTime;
+	}
+
+	if (useBinary) {
+		MappedFile file;
+		MapChipBinaryView view;
+		const char* error = nullptr;
+		if (file.Open(binaryPath) && ReadMapChipBinary(file.GetData(), file.GetSize(), view, error)) {
+			size_t count = static_cast<size_t>(view.width) * view.height;
+			profile.source = "binary";
+			profile.stage.collision = {view.width, view.height, std::vector<MapChipType>(view.tiles, view.tiles + count)};
+			for (const MapChipBinaryLayerView& layer : view.layers) {
+				profile.stage.layers.push_back({layer.name, std::vector<MapChipType>(layer.tiles, layer.tiles + count)});
+			}
+			return true;
+		}
+		std::fprintf(stderr, "%s: %s, loading CSV\n", binaryPath.c_str(), error ? error : "failed to open");
+		if (binaryPath == path) {
+			return false;
+		}
+	}
+
+	MappedFile file;
+	if (!file.Open(path)) {
+		std::fprintf(stderr, "%s: failed to open\n", path.c_str());
+		return false;
+	}
+	std::vector<MapChipCsvError> errors;
+	uint32_t errorCount = ParseMapChipStageCsv(file.GetData(), file.GetSize(), profile.stage, errors, kMaxReportedErrors);
+	for (const MapChipCsvError& e : errors) {
+		std::fprintf(stderr, "%s:%u:%u: invalid cell '%s'\n", path.c_str(), e.row, e.column, e.text.c_str());
+	}
+	if (errorCount > 0 || profile.stage.collision.height == 0) {
+		std::fprintf(stderr, "%s: invalid stage\n", path.c_str());
+		return false;
+	}
+	profile.source = "csv";
+	return true;
+}
+
+/// <summary>
+/// BlockChunkManager が同時に持つブロックの最大数
+/// カメラをタイル単位で全域に動かしたときの、解放されずに残る範囲（読み込み半径 + 余裕）のチャンクの合計の最大
+/// </summary>
+void ProfileBlocks(StageProfile& profile) {
+	const MapChipSnapshot& map = *profile.map;
+	const MapChipLayer* decoration = map.FindLayer(kMapChipDecorationLayerName);
+	const uint32_t width = map.GetNumBlockHorizontal();
+	const uint32_t height = map.GetNumBlockVertical();
+	const uint32_t kChunkSize = BlockChunkStreamer::kChunkSize;
+	const uint32_t chunksX = (width + kChunkSize - 1) / kChunkSize;
+	const uint32_t chunksY = (height + kChunkSize - 1) / kChunkSize;
+
+	std::vector<uint64_t> chunkBlocks(static_cast<size_t>(chunksX) * chunksY, 0);
+	for (uint32_t y = 0; y < height; ++y) {
+		for (uint32_t x = 0; x < width; ++x) {
+			uint64_t blocks = GetMapChipProperty(map.GetMapChipTypeByIndexUnchecked(x, y)).model != MapChipModel::kNone;
+			if (decoration) {
+				blocks += GetMapChipProperty(decoration->tiles.Get(x, y)).model != MapChipModel::kNone;
+			}
+			chunkBlocks[static_cast<size_t>(y / kChunkSize) * chunksX + x / kChunkSize] += blocks;
+			profile.modelTiles += blocks;
+		}
+	}
+	profile.nonEmptyChunks = static_cast<uint64_t>(std::count_if(chunkBlocks.begin(), chunkBlocks.end(), [](uint64_t n) { return n > 0; }));
+
+	// 軸ごとに、カメラの位置で決まるチャンク範囲の組み合わせを集める
+	const int64_t reach = static_cast<int64_t>((BlockChunkStreamer::kDefaultLoadRadius + BlockChunkStreamer::kUnloadMargin) / MapChipSnapshot::GetBlockWidth());
+	auto collectRanges = [&](uint32_t tiles, uint32_t chunks) {
+		std::vector<std::pair<uint32_t, uint32_t>> ranges;
+		for (int64_t t = 0; t < tiles; ++t) {
+			uint32_t first = static_cast<uint32_t>(std::max<int64_t>(t - reach, 0)) / kChunkSize;
+			uint32_t last = std::min(static_cast<uint32_t>(std::min<int64_t>(t + reach, tiles - 1)) / kChunkSize, chunks - 1);
+			if (ranges.empty() || ranges.back() != std::make_pair(first, last)) {
+				ranges.push_back({first, last});
+			}
+		}
+		return ranges;
+	};
+	auto rangesX = collectRanges(width, chunksX);
+	auto rangesY = collectRanges(height, chunksY);
+
+	// 列ごとの累積和で、範囲の合計を縦方向のチャンク数に比例する手間で求める
+	std::vector<uint64_t> prefix(static_cast<size_t>(chunksX + 1) * chunksY, 0);
+	for (uint32_t cy = 0; cy < chunksY; ++cy) {
+		for (uint32_t cx = 0; cx < chunksX; ++cx) {
+			prefix[static_cast<size_t>(cy) * (chunksX + 1) + cx + 1] = prefix[static_cast<size_t>(cy) * (chunksX + 1) + cx] + chunkBlocks[static_cast<size_t>(cy) * chunksX + cx];
+		}
+	}
+	for (const auto& [y0, y1] : rangesY) {
+		for (const auto& [x0, x1] : rangesX) {
+			uint64_t sum = 0;
+			for (uint32_t cy = y0; cy <= y1; ++cy) {
+				const uint64_t* row = prefix.data() + static_cast<size_t>(cy) * (chunksX + 1);
+				sum += row[x1 + 1] - row[x0];
+			}
+			profile.peakResidentBlocks = std::max(profile.peakResidentBlocks, sum);
+		}
+	}
+}
+
+void ProfileEntities(StageProfile& profile) {
+	// 生成位置の索引は当たり判定レイヤーと entities レイヤーの両方から集めてある（GameScene もここから生成する）
+	for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+		MapChipType type = static_cast<MapChipType>(i);
+		profile.entities[static_cast<uint8_t>(GetMapChipProperty(type).spawnKind)] += profile.map->GetSpawnTiles(type).size();
+	}
+
+	// 0 番 (none) は生成しないタイル
+	for (uint32_t k = 1; k < kSpawnKindCount; ++k) {
+		profile.entityTotal += profile.entities[k];
+		// プレイヤーの開始位置とステージノードは当たり判定の対象にならない
+		if (kSpawnKinds[k].models > 0) {
+			profile.entityCollidable += profile.entities[k];
+			profile.entityModels += profile.entities[k] * kSpawnKinds[k].models;
+		}
+	}
+}
+
+/// <summary>
+/// 立てる位置（自身と 1 つ上が solid でなく、すぐ下が ground）すべてから PlayerPhysics を MakePlayerScript の入力で動かし、
+/// 1 ステップで読むタイル数の最大と平均を求める
+/// </summary>
+void ProfilePlayer(StageProfile& profile) {
+	const MapChipSnapshot& map = *profile.map;
+	CountingMapQuery query(map);
+	PlayerPhysics physics;
+	physics.SetMapQuery(&query);
+
+	const std::vector<ScriptStep> script = MakePlayerScript();
+	uint64_t steps = 0;
+	for (uint32_t y = 1; y + 1 < map.GetNumBlockVertical(); ++y) {
+		for (uint32_t x = 0; x < map.GetNumBlockHorizontal(); ++x) {
+			if (map.TestPlane(MapChipPlane::kSolid, x, y) || map.TestPlane(MapChipPlane::kSolid, x, y - 1) || !map.TestPlane(MapChipPlane::kGround, x, y + 1)) {
+				continue;
+			}
+			physics.Initialize({kMapChipBlockWidth * x, kMapChipBlockHeight * (map.GetNumBlockVertical() - 1 - y)}, 0.3f);
+			for (const ScriptStep& step : script) {
+				for (uint32_t frame = 0; frame < step.frames; ++frame) {
+					uint64_t before = query.GetTileReadCount();
+					physics.Step(step.input);
+					profile.playerTileReadsMax = std::max(profile.playerTileReadsMax, query.GetTileReadCount() - before);
+					++steps;
+				}
+			}
+		}
+	}
+	profile.playerTileReadsMean = steps > 0 ? static_cast<double>(query.GetTileReadCount()) / static_cast<double>(steps) : 0.0;
+}
+
+/// <summary>
+/// 歩く敵の 1 フレームの問い合わせ回数。ゲームと同じく経路グラフを作り、生成位置のタイルが区間の上かで決める
+/// </summary>
+void ProfileEnemies(StageProfile& profile) {
+	const MapChipSnapshot& map = *profile.map;
+	MapChipNavGraph graph;
+	graph.Build(map);
+
+	uint64_t walkers = 0;
+	for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+		MapChipType type = static_cast<MapChipType>(i);
+		if (GetMapChipProperty(type).spawnKind != MapChipSpawnKind::kEnemy) {
+			continue;
+		}
+		for (const IndexSet& index : map.GetSpawnTiles(type)) {
+			++walkers;
+			if (graph.FindNode(index.xIndex, index.yIndex) == kMapChipNavNone) {
+				profile.enemyProbes += kEnemyProbesOffGraph;
+			}
+		}
+	}
+	profile.enemyProbesPerEnemy = walkers > 0 ? static_cast<double>(profile.enemyProbes) / static_cast<double>(walkers) : 0.0;
+}
+
+bool Profile(const std::string& path, StageProfile& profile) {
+	profile.path = path;
+	if (!LoadStage(path, profile)) {
+		return false;
+	}
+	// ゲームと同じくスナップショットを作り、以降はそこから数える
+	profile.map = MapChipSnapshot::CreateFromStage(profile.stage);
+	profile.collisionTypes.Add(*profile.map);
+	for (const MapChipLayer& layer : profile.map->GetLayers()) {
+		profile.layerTypes.emplace_back().Add(layer, profile.Height());
+	}
+	ProfileBlocks(profile);
+	ProfileEntities(profile);
+	ProfilePlayer(profile);
+	ProfileEnemies(profile);
+
+	profile.drawCalls = profile.peakResidentBlocks + profile.entityModels;
+	profile.entityPairChecks = profile.entityCollidable;
+	return true;
+}
+
+// ---- JSON 出力 ----
+
+void PrintString(const std::string& s) {
+	std::putchar('"');
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			std::printf("\\%c", c);
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			std::printf("\\u%04x", c);
+		} else {
+			std::putchar(c);
+		}
+	}
+	std::putchar('"');
+}
+
+void PrintHistogram(const Histogram& histogram, const char* indent) {
+	std::printf("{");
+	bool first = true;
+	for (uint32_t i = 0; i < kMapChipTypeCount; ++i) {
+		if (histogram.counts[i] == 0) {
+			continue;
+		}
+		std::printf("%s\n%s  \"%s\": %llu", first ? "" : ",", indent, kTypeNames[i], static_cast<unsigned long long>(histogram.counts[i]));
+		first = false;
+	}
+	std::printf("%s}", first ? "" : (std::string("\n") + indent).c_str());
+}
+
+void PrintProfile(const StageProfile& p, const std::vector<std::string>& exceeded) {
+	std::span<const MapChipLayer> layers = p.map->GetLayers();
+	std::printf("    {\n      \"path\": ");
+	PrintString(p.path);
+	std::printf(",\n      \"size\": {\"width\": %u, \"height\": %u, \"tiles\": %llu, \"source\": \"%s\", \"layers\": [", p.Width(), p.Height(),
+	            static_cast<unsigned long long>(p.Width()) * p.Height(), p.source.c_str());
+	for (size_t i = 0; i < layers.size(); ++i) {
+		std::printf("%s", i > 0 ? ", " : "");
+		PrintString(layers[i].name);
+	}
+	std::printf("]},\n      \"tileTypes\": ");
+	PrintHistogram(p.collisionTypes, "      ");
+	std::printf(",\n      \"layers\": {");
+	for (size_t i = 0; i < layers.size(); ++i) {
+		std::printf("%s\n        ", i > 0 ? "," : "");
+		PrintString(layers[i].name);
+		std::printf(": {\"tileTypes\": ");
+		PrintHistogram(p.layerTypes[i], "        ");
+		std::printf("}");
+	}
+	std::printf("%s},\n", layers.empty() ? "" : "\n      ");
+	std::printf("      \"blocks\": {\"modelTiles\": %llu, \"nonEmptyChunks\": %llu, \"peakResident\": %llu},\n", static_cast<unsigned long long>(p.modelTiles),
+	            static_cast<unsigned long long>(p.nonEmptyChunks), static_cast<unsigned long long>(p.peakResidentBlocks));
+	std::printf("      \"entities\": {\"total\": %llu, \"collidable\": %llu", static_cast<unsigned long long>(p.entityTotal),
+	            static_cast<unsigned long long>(p.entityCollidable));
+	for (uint32_t k = 1; k < kSpawnKindCount; ++k) {
+		std::printf(", \"%s\": %llu", kSpawnKinds[k].name, static_cast<unsigned long long>(p.entities[k]));
+	}
+	std::printf("},\n");
+	std::printf("      \"frame\": {\"drawCalls\": %llu, \"entityPairChecks\": %llu, \"playerTileReadsMax\": %llu, \"playerTileReadsMean\": %.2f, "
+	            "\"enemyProbes\": %llu, \"enemyProbesPerEnemy\": %.2f},\n",
+	            static_cast<unsigned long long>(p.drawCalls), static_cast<unsigned long long>(p.entityPairChecks), static_cast<unsigned long long>(p.playerTileReadsMax),
+	            p.playerTileReadsMean, static_cast<unsigned long long>(p.enemyProbes), p.enemyProbesPerEnemy);
+	std::printf("      \"budgetExceeded\": [");
+	for (size_t i = 0; i < exceeded.size(); ++i) {
+		std::printf("%s", i > 0 ? ", " : "");
+		PrintString(exceeded[i]);
+	}
+	std::printf("]\n    }");
+}
+
+void PrintUsage() { std::fprintf(stderr, "usage: StageProfiler [--budget <metric>=<max>]... <stage.csv | stage.mcb>...\n"); }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::vector<Budget> budgets;
+	std::vector<std::string> paths;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+			std::string spec = argv[++i];
+			size_t eq = spec.find('=');
+			char* end = nullptr;
+			double max = eq == std::string::npos ? 0.0 : std::strtod(spec.c_str() + eq + 1, &end);
+			if (eq == std::string::npos || end == spec.c_str() + eq + 1 || *end != '\0') {
+				std::fprintf(stderr, "invalid budget '%s'\n", spec.c_str());
+				return 2;
+			}
+			budgets.push_back({spec.substr(0, eq), max});
+		} else {
+			paths.push_back(argv[i]);
+		}
+	}
+	if (paths.empty()) {
+		PrintUsage();
+		return 2;
+	}
+
+	// 指標名の綴り間違いで予算が素通りしないよう、先に確認する
+	std::vector<std::pair<std::string, double>> names = StageProfile().Metrics();
+	for (const Budget& b : budgets) {
+		if (std::none_of(names.begin(), names.end(), [&](const auto& m) { return m.first == b.metric; })) {
+			std::fprintf(stderr, "unknown metric '%s'\n", b.metric.c_str());
+			return 2;
+		}
+	}
+
+	bool ok = true;
+	bool first = true;
+	std::printf("{\n  \"stages\": [\n");
+	for (const std::string& path : paths) {
+		StageProfile profile;
+		if (!Profile(path, profile)) {
+			ok = false;
+			continue;
+		}
+
+		std::vector<std::string> exceeded;
+		for (const auto& [metric, value] : profile.Metrics()) {
+			for (const Budget& b : budgets) {
+				if (b.metric == metric && value > b.max) {
+					exceeded.push_back(metric);
+					std::fprintf(stderr, "%s: %s = %.2f exceeds budget %.2f\n", path.c_str(), metric.c_str(), value, b.max);
+				}
+			}
+		}
+		ok = ok && exceeded.empty();
+
+		std::printf("%s", first ? "" : ",\n");
+		PrintProfile(profile, exceeded);
+		first = false;
+	}
+	std::printf("\n  ]\n}\n");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+// PhysicsTrace の書き出したファイル（F9 で physics_trace.bin）を読める文字列にするツール
+//
+// ゲーム本体とは別にビルドする（DirectXGame.vcxproj には含めない）
+//   cl /std:c++20 /EHsc /O2 /utf-8 /I. /Fe:TraceDecoder.exe Tools\TraceDecoder.cpp MappedFile.cpp
+//
+// 使い方
+//   TraceDecoder [--event <name>]... [--frames <first>-<last>] <physics_trace.bin>
+//
+// 1 イベント 1 行で、古い順に「フレーム イベント名 値の名前=値 ...」を出す。イベント名・値の名前は PhysicsTrace.h の表を使う
+// --event を指定するとその名前のイベントだけ（複数指定可）、--frames を指定するとその範囲のフレームだけを出す
+// 最後に、イベントの種類ごとの件数を出す
+
+#include "MappedFile.h"
+#include "PhysicsTrace.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t kEventCount = static_cast<size_t>(PhysicsTraceId::kCount);
+
+/// <summary>
+/// イベント名から PhysicsTraceId の番号を引く（見つからなければ kEventCount）
+/// </summary>
+size_t FindEvent(const char* name) {
+	for (size_t i = 0; i < kEventCount; ++i) {
+		if (std::strcmp(kPhysicsTraceEventInfos[i].name, name) == 0) {
+			return i;
+		}
+	}
+	return kEventCount;
+}
+
+void PrintEvent(const PhysicsTraceEvent& event) {
+	if (event.id >= kEventCount) {
+		std::printf("%8u unknown(%u)", event.frame, event.id);
+	} else {
+		std::printf("%8u %-12s", event.frame, kPhysicsTraceEventInfos[event.id].name);
+	}
+	uint32_t count = event.valueCount < kPhysicsTraceMaxValues ? event.valueCount : kPhysicsTraceMaxValues;
+	for (uint32_t i = 0; i < count; ++i) {
+		const char* valueName = event.id < kEventCount ? kPhysicsTraceEventInfos[event.id].valueNames[i] : nullptr;
+		if (valueName) {
+			std::printf(" %s=%.4f", valueName, event.values[i]);
+		} else {
+			std::printf(" v%u=%.4f", i, event.values[i]);
+		}
+	}
+	std::printf("\n");
+}
+
+int Usage() {
+	std::fprintf(stderr, "usage: TraceDecoder [--event <name>]... [--frames <first>-<last>] <physics_trace.bin>\n");
+	return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+	std::vector<bool> shown(kEventCount, true);
+	bool filtered = false;
+	uint32_t firstFrame = 0;
+	uint32_t lastFrame = UINT32_MAX;
+	const char* path = nullptr;
+
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--event") == 0 && i + 1 < argc) {
+			size_t id = FindEvent(argv[++i]);
+			if (id == kEventCount) {
+				std::fprintf(stderr, "unknown event '%s'\n", argv[i]);
+				return 2;
+			}
+			if (!filtered) {
+				shown.assign(kEventCount, false);
+				filtered = true;
+			}
+			shown[id] = true;
+		} else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			char* end = nullptr;
+			firstFrame = static_cast<uint32_t>(std::strtoul(argv[++i], &end, 10));
+			if (*end != '-') {
+				return Usage();
+			}
+			lastFrame = static_cast<uint32_t>(std::strtoul(end + 1, nullptr, 10));
+		} else if (!path && argv[i][0] != '-') {
+			path = argv[i];
+		} else {
+			return Usage();
+		}
+	}
+	if (!path) {
+		return Usage();
+	}
+
+	MappedFile file;
+	if (!file.Open(path)) {
+		std::fprintf(stderr, "%s: failed to open\n", path);
+		return 1;
+	}
+	PhysicsTraceFileHeader header = {};
+	if (file.GetSize() < sizeof(header)) {
+		std::fprintf(stderr, "%s: too small for a trace header\n", path);
+		return 1;
+	}
+	std::memcpy(&header, file.GetData(), sizeof(header));
+	if (std::memcmp(header.magic, "PTRC", sizeof(header.magic)) != 0 || header.version != kPhysicsTraceFileVersion ||
+	    header.eventSize != sizeof(PhysicsTraceEvent)) {
+		std::fprintf(stderr, "%s: not a version %u physics trace\n", path, kPhysicsTraceFileVersion);
+		return 1;
+	}
+	if (file.GetSize() < sizeof(header) + static_cast<size_t>(header.count) * sizeof(PhysicsTraceEvent)) {
+		std::fprintf(stderr, "%s: truncated (%u events in header)\n", path, header.count);
+		return 1;
+	}
+
+	std::vector<uint32_t> counts(kEventCount + 1, 0);
+	const char* data = file.GetData() + sizeof(header);
+	for (uint32_t i = 0; i < header.count; ++i) {
+		PhysicsTraceEvent event;
+		std::memcpy(&event, data + static_cast<size_t>(i) * sizeof(event), sizeof(event));
+		if (event.frame < firstFrame || event.frame > lastFrame) {
+			continue;
+		}
+		bool known = event.id < kEventCount;
+		if (known && !shown[event.id]) {
+			continue;
+		}
+		if (!known && filtered) {
+			continue;
+		}
+		++counts[known ? event.id : kEventCount];
+		PrintEvent(event);
+	}
+
+	std::printf("-- %u events in file\n", header.count);
+	for (size_t i = 0; i < kEventCount; ++i) {
+		if (counts[i] > 0) {
+			std::printf("--   %-12s %u\n", kPhysicsTraceEventInfos[i].name, counts[i]);
+		}
+	}
+	if (counts[kEventCount] > 0) {
+		std::printf("--   %-12s %u\n", "unknown", counts[kEventCount]);
+	}
+	return 0;
+}
@@ -2,10 +2,13 @@
 
 #include "KamataEngine.h"
 
+#include "FrameClock.h"
 #include "GameScene.h"
 #include "TitleScene.h"
 #include "SelectScene.h"
 #include "GameOverScene.h"
+#include "InputRecording.h"
+#include "PhysicsTrace.h"
 
 using namespace KamataEngine;
 
@@ -17,6 +20,12 @@ GameOverScene* gameOverScene = nullptr;
 // 現在のステージインデックスを保持
 static int gCurrentStageIndex = 0;
 
+// F9 で書き出す物理トレースのファイル
+static const char* const kPhysicsTracePath = "physics_trace.bin";
+
+// F10 で記録し、F11 で再生するプレイヤー操作のファイル
+static const char* const kInputRecordPath = "input_record.bin";
+
 enum class Scene {
 
 	kUnknown = 0,
@@ -71,24 +80,76 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int) {
 
 	XINPUT_STATE state;
 
-	while (true) {
-		if (KamataEngine::Update()) {
-			break;
-		}
+	FrameClock* frameClock = FrameClock::GetInstance();
+	frameClock->Reset();
 
-		Input::GetInstance()->GetJoystickState(0, state);
+	bool quit = false;
+	while (!quit) {
+		// 実時間で溜まった分だけ固定ステップで更新し、描画は 1 回だけ行う
+		// 入力はステップごとに取り直すので、Trigger 系の判定が 2 回立ったり取りこぼしたりしない
+		uint32_t steps = frameClock->Advance();
 
 #ifdef _DEBUG
+		// ImGui のフレームは描画と同じく 1 回だけ開く。追いつきで複数ステップ進めるときは、ステップごとに ID を分けて衝突させない
 		imguiManager->Begin();
 #endif //  _DEBUG
 
-		
-		ChangeScene();
-		UpdateScene();
+		for (uint32_t i = 0; i < steps; ++i) {
+			if (KamataEngine::Update()) {
+				quit = true;
+				break;
+			}
+
+			Input::GetInstance()->GetJoystickState(0, state);
+
+#ifdef _DEBUG
+			ImGui::PushID(static_cast<int>(i));
+#endif //  _DEBUG
+
+			ChangeScene();
+			UpdateScene();
+
+#ifdef _DEBUG
+			ImGui::PopID();
+#endif //  _DEBUG
+		}
+
+		// ここからは表示フレームごとの処理（入力は最後のステップのもの）
+		if (!quit) {
+			// F9 で物理トレースの直近のイベントを書き出す（Tools/TraceDecoder で読む）
+			if (Input::GetInstance()->TriggerKey(DIK_F9)) {
+				bool dumped = PhysicsTrace::GetInstance()->Dump(kPhysicsTracePath);
+				DebugText::GetInstance()->ConsolePrintf("PhysicsTrace: %s %s\n", dumped ? "dumped to" : "failed to write", kPhysicsTracePath);
+			}
+
+			// F10 で次にプレイヤーが出たとき（ステージ開始・リトライ）からの操作を記録し、もう一度押すと止めて書き出す
+			// F11 で書き出した操作を読み、次にプレイヤーが出たときから実際の入力の代わりに再生する
+			InputRecorder* inputRecorder = InputRecorder::GetInstance();
+			if (Input::GetInstance()->TriggerKey(DIK_F10)) {
+				if (inputRecorder->GetMode() == InputRecorder::Mode::kRecording) {
+					InputRecorder::SessionResult result = inputRecorder->ToggleRecording(kInputRecordPath);
+					DebugText::GetInstance()->ConsolePrintf("InputRecorder: %s (%s)\n", InputRecorder::GetResultText(result), kInputRecordPath);
+				} else {
+					inputRecorder->ToggleRecording(kInputRecordPath);
+					bool armed = inputRecorder->GetPendingMode() == InputRecorder::Mode::kRecording;
+					DebugText::GetInstance()->ConsolePrintf("InputRecorder: %s\n", armed ? "recording starts when the player spawns" : "recording cancelled");
+				}
+			}
+			if (Input::GetInstance()->TriggerKey(DIK_F11)) {
+				if (inputRecorder->ArmReplay(kInputRecordPath)) {
+					DebugText::GetInstance()->ConsolePrintf("InputRecorder: replay of %s starts when the player spawns\n", kInputRecordPath);
+				} else {
+					DebugText::GetInstance()->ConsolePrintf("InputRecorder: failed to read %s\n", kInputRecordPath);
+				}
+			}
+		}
 
 #ifdef _DEBUG
 		imguiManager->End();
 #endif
+		if (quit) {
+			break;
+		}
 
 		dxCommom->PreDraw();
 